@@ -0,0 +1,60 @@
+// compares the table-driven angle functions in angle.h against libm, for speed and accuracy (run with make bench)
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+
+#include "angle.h"
+
+// number of calls timed per function
+#define BENCH_CALLS 10000000
+
+// keeps the compiler from throwing away the results being timed
+static volatile f32 sink;
+
+// returns the nanoseconds per call it took to run the function on BENCH_CALLS different inputs
+template <typename Function> static double TimeCalls(Function function) {
+	auto start = std::chrono::steady_clock::now();
+	f32 total = 0;
+	for (u32 i = 0; i < BENCH_CALLS; i++) total += function(i);
+	auto end = std::chrono::steady_clock::now();
+	sink = total;
+	return std::chrono::duration<double, std::nano>(end - start).count() / BENCH_CALLS;
+}
+
+int main() {
+	// accuracy: every 2^12th angle for sine/cosine, and a fine sweep of directions for arctangent
+	double sineError = 0;
+	double cosineError = 0;
+	for (u64 turns = 0; turns < 4294967296ull; turns += 4096) {
+		Angle angle = {(u32) turns};
+		double radians = turns * (2 * M_PI / 4294967296.0);
+		sineError = fmax(sineError, fabs(AngleSine(angle) - sin(radians)));
+		cosineError = fmax(cosineError, fabs(AngleCosine(angle) - cos(radians)));
+	}
+	double arcTangentError = 0;
+	for (int i = 0; i < 1000000; i++) {
+		double radians = i * (2 * M_PI / 1000000) - M_PI;
+		f32 length = 1 + i % 7 * 50; // lengths from 1 to 301, like bullet directions and tank offsets
+		Angle angle = ArcTangent(length * (f32) sin(radians), length * (f32) cos(radians));
+		double error = fabs(remainder(angle.turns * (2 * M_PI / 4294967296.0) - atan2(length * (f32) sin(radians), length * (f32) cos(radians)), 2 * M_PI));
+		arcTangentError = fmax(arcTangentError, error);
+	}
+	// speed: the same inputs through both, with the libm calls done the way the game used to (double precision, from degrees/2)
+	double tableSine = TimeCalls([](u32 i) { Angle angle = {i * 2654435769u}; return AngleSine(angle); });
+	double libmSine = TimeCalls([](u32 i) { return (f32) sin((i * 2654435769u) * (180 / 4294967296.0) * 2.0 * (M_PI / 180.0)); });
+	double tableHalfDegrees = TimeCalls([](u32 i) { Angle angle = HalfDegreesToAngle((f32) (i % 1800) / 10); return AngleCosine(angle) + AngleSine(angle); });
+	double libmHalfDegrees = TimeCalls([](u32 i) { f32 radRotation = (f32) (i % 1800) / 10 * 2.0 * (M_PI / 180.0); return (f32) (cos(radRotation) + sin(radRotation)); });
+	double tableArcTangent = TimeCalls([](u32 i) { return AngleToHalfDegrees(ArcTangent((f32) (i % 1000) - 500, (f32) (i % 997) - 498)); });
+	double libmArcTangent = TimeCalls([](u32 i) { return (f32) fmod(atan2((f32) (i % 1000) - 500, (f32) (i % 997) - 498) * (180.0 / M_PI) / 2 + 180, 180); });
+	printf("function,table_ns,libm_ns,speedup,max_error,error_bound\n");
+	printf("sine,%.2f,%.2f,%.2f,%.3g,%.3g\n", tableSine, libmSine, libmSine / tableSine, sineError, ANGLE_SINE_MAX_ERROR);
+	printf("cosine,,,,%.3g,%.3g\n", cosineError, ANGLE_SINE_MAX_ERROR);
+	printf("rotation_to_cos_sin,%.2f,%.2f,%.2f,,\n", tableHalfDegrees, libmHalfDegrees, libmHalfDegrees / tableHalfDegrees);
+	printf("arctangent_to_rotation,%.2f,%.2f,%.2f,%.3g,%.3g\n", tableArcTangent, libmArcTangent, libmArcTangent / tableArcTangent, arcTangentError, ANGLE_ARCTANGENT_MAX_ERROR);
+	// fail if the tables are off by more than the documented bounds
+	if (sineError > ANGLE_SINE_MAX_ERROR || cosineError > ANGLE_SINE_MAX_ERROR || arcTangentError > ANGLE_ARCTANGENT_MAX_ERROR) {
+		printf("error bound exceeded\n");
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef TANK_BENCHSTATS_H
+#define TANK_BENCHSTATS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+// shared by the benchmarks: timing samples are summarized into mean/median/p99/max and printed as csv (or json with -json),
+// one row per benchmark, so the output can be saved and compared between releases
+
+// the summary of one benchmark's timing samples
+struct BenchResult {
+	std::string name;
+	std::string parameters; // what the benchmark was run with, as key=value pairs separated by spaces
+	std::string unit; // what each sample measures (like ns_per_call or us_per_frame)
+	int samples;
+	double mean;
+	double median;
+	double p99;
+	double max;
+};
+
+// returns the time since start in the given unit (std::nano, std::micro...)
+template <typename Unit> static inline double BenchElapsed(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, Unit>(std::chrono::steady_clock::now() - start).count();
+}
+
+// summarizes a set of timing samples (nearest rank percentiles)
+static inline BenchResult SummarizeBench(const char* name, const std::string& parameters, const char* unit, std::vector<double> samples) {
+	BenchResult result;
+	result.name = name;
+	result.parameters = parameters;
+	result.unit = unit;
+	result.samples = samples.size();
+	std::sort(samples.begin(), samples.end());
+	double total = 0;
+	for (int i = 0; i < (int) samples.size(); i++) total += samples[i];
+	result.mean = samples.empty() ? 0 : total / samples.size();
+	result.median = samples.empty() ? 0 : samples[(samples.size() - 1) / 2];
+	result.p99 = samples.empty() ? 0 : samples[std::min(samples.size() - 1, (size_t) (samples.size() * .99))];
+	result.max = samples.empty() ? 0 : samples.back();
+	return result;
+}
+
+// returns true if -json was passed
+static inline bool BenchWantsJson(int argc, char** argv) {
+	for (int i = 1; i < argc; i++) if (!strcmp(argv[i], "-json")) return true;
+	return false;
+}
+
+// prints every result as csv or json
+static inline void PrintBenchResults(const std::vector<BenchResult>& results, bool json) {
+	if (json) printf("[\n");
+	else printf("benchmark,parameters,unit,samples,mean,median,p99,max\n");
+	for (int i = 0; i < (int) results.size(); i++) {
+		const BenchResult* result = &results[i];
+		if (json) {
+			printf("\t{\"benchmark\": \"%s\", \"parameters\": \"%s\", \"unit\": \"%s\", \"samples\": %d, \"mean\": %.4f, \"median\": %.4f, \"p99\": %.4f, \"max\": %.4f}%s\n",
+				result->name.c_str(), result->parameters.c_str(), result->unit.c_str(), result->samples, result->mean, result->median, result->p99, result->max, i + 1 < (int) results.size() ? "," : "");
+		}
+		else {
+			printf("%s,%s,%s,%d,%.4f,%.4f,%.4f,%.4f\n", result->name.c_str(), result->parameters.c_str(), result->unit.c_str(), result->samples, result->mean, result->median, result->p99, result->max);
+		}
+	}
+	if (json) printf("]\n");
+}
+
+#endif
\ No newline at end of file
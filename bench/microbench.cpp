@@ -0,0 +1,149 @@
+// times the collision, map generation and bot functions the game leans on hardest, a call at a time (run with make bench; -json for json output)
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+
+#include "benchstats.h"
+#include "collision.h"
+#include "map.h"
+#include "bots.h"
+
+// each benchmark takes this many samples, each one the average of a batch of calls
+#define MICROBENCH_SAMPLES 101
+
+// keeps the compiler from throwing away the results being timed
+static volatile f32 sink;
+
+// times a function (called with the call number) over MICROBENCH_SAMPLES batches of the given number of calls, and returns the nanoseconds per call of each batch
+template <typename Function> static std::vector<double> SampleCalls(int callsPerSample, Function function) {
+	std::vector<double> samples;
+	f32 total = 0;
+	u32 call = 0;
+	for (int sample = 0; sample < MICROBENCH_SAMPLES; sample++) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int i = 0; i < callsPerSample; i++) total += function(call++);
+		samples.push_back(BenchElapsed<std::nano>(start) / callsPerSample);
+	}
+	sink = total;
+	return samples;
+}
+
+// a tank-sized sprite and a wall-sized quad at random spots/angles around the middle of the screen, so about half of the pairs overlap
+struct CollisionPair {
+	Sprite* sprite;
+	Quad* quad;
+	OBB spriteVertices;
+	OBB quadVertices;
+	OrientedBox spriteBox;
+	OrientedBox quadBox;
+};
+
+int main(int argc, char** argv) {
+	std::vector<BenchResult> results;
+	std::mt19937 rng(1);
+
+	// collision: a fixed set of pairs cycled through, so every call is a different (but cache resident) pair
+	Image image;
+	std::vector<CollisionPair> pairs(256);
+	for (int i = 0; i < (int) pairs.size(); i++) {
+		CollisionPair* pair = &pairs[i];
+		pair->sprite = new Sprite();
+		pair->sprite->SetImage(&image);
+		pair->sprite->DefineCollisionRectangle(0, 0, 28, 24);
+		pair->sprite->SetPosition(300 + rng() % 40, 220 + rng() % 40);
+		pair->sprite->SetRotation(rng() % 180);
+		pair->quad = new Quad();
+		pair->quad->SetWidth(87);
+		pair->quad->SetHeight(8);
+		pair->quad->SetPosition(270 + rng() % 60, 230 + rng() % 40);
+		pair->quad->SetRotation(rng() % 2 ? rng() % 180 : 0);
+		pair->spriteVertices = GetVertices(pair->sprite);
+		pair->quadVertices = GetVertices(pair->quad);
+		pair->spriteBox = GetOrientedBox(pair->sprite);
+		pair->quadBox = GetOrientedBox(pair->quad);
+	}
+	int pairMask = pairs.size() - 1;
+	results.push_back(SummarizeBench("Collision", "shapes=obb_vertices", "ns_per_call", SampleCalls(100000, [&](u32 i) {
+		return Collision(&pairs[i & pairMask].spriteVertices, &pairs[i & pairMask].quadVertices).overlap;
+	})));
+	results.push_back(SummarizeBench("Collision", "shapes=oriented_box", "ns_per_call", SampleCalls(100000, [&](u32 i) {
+		return Collision(&pairs[i & pairMask].spriteBox, &pairs[i & pairMask].quadBox).overlap;
+	})));
+	results.push_back(SummarizeBench("Collision", "shapes=sprite_quad", "ns_per_call", SampleCalls(100000, [&](u32 i) {
+		return Collision(pairs[i & pairMask].sprite, pairs[i & pairMask].quad).overlap;
+	})));
+	results.push_back(SummarizeBench("CollisionPossible", "shapes=sprite_quad", "ns_per_call", SampleCalls(100000, [&](u32 i) {
+		return (f32) CollisionPossible(pairs[i & pairMask].sprite, pairs[i & pairMask].quad);
+	})));
+	for (int i = 0; i < (int) pairs.size(); i++) {
+		delete pairs[i].sprite;
+		delete pairs[i].quad;
+	}
+
+	// map generation, at the game's size, at 4 times its area, and at 64x64 (mazes only, since that's more walls than a wall manager is made for)
+	const int sizes[][2] = {{8, 6}, {16, 12}, {64, 64}};
+	Maze maze;
+	for (int size = 0; size < 3; size++) {
+		int width = sizes[size][0];
+		int height = sizes[size][1];
+		char parameters[64];
+		snprintf(parameters, sizeof(parameters), "width=%d height=%d", width, height);
+		results.push_back(SummarizeBench("GenerateMaze", parameters, "ns_per_call", SampleCalls(20, [&](u32 i) {
+			Random random;
+			SeedRandom(&random, i);
+			InitMaze(&maze, width, height);
+			GenerateMaze(&maze, &random);
+			OpenUpMaze(&maze, &random);
+			return (f32) maze.west[0];
+		})));
+		// one of the bots' fields (each is searched once, the first time a bot heads for its cell)
+		MazeDistances distances;
+		int cells = width * height;
+		results.push_back(SummarizeBench("GetMazeField", parameters, "ns_per_call", SampleCalls(20, [&](u32 i) {
+			ResetMazeDistances(&distances, cells);
+			int field = GetMazeField(&distances, &maze, i % cells);
+			return (f32) distances.steps[field + (i * 7) % cells];
+		})));
+		if (width > 16) continue;
+		// and one for every cell, which is the most a map can ever need (cells squared, so only for maps the game could use)
+		results.push_back(SummarizeBench("GetMazeField", std::string(parameters) + " targets=all", "ns_per_call", SampleCalls(20, [&](u32 i) {
+			ResetMazeDistances(&distances, cells);
+			for (int target = 0; target < cells; target++) GetMazeField(&distances, &maze, target);
+			return (f32) distances.steps[i % distances.steps.size()];
+		})));
+		// generating walls needs a new map each time, so that's timed along with it
+		LayerManager wallManager(width * height * 2 + width + height);
+		results.push_back(SummarizeBench("Map::GenerateWalls", parameters, "ns_per_call", SampleCalls(20, [&](u32 i) {
+			Map* map = new Map(width * 80 + 8, height * 80 + 8, width, height, 8, i);
+			map->GenerateWalls(&wallManager);
+			f32 walls = wallManager.GetSize();
+			map->Destroy(&wallManager);
+			return walls;
+		})));
+	}
+
+	// bot rays: a fixed set of random starts and directions on the game's size of map, against four tanks (so every call is a different ray, and about as long as the bots' are)
+	Map* map = new Map(640, 480, 8, 6, 8, 1);
+	Vec2 targets[MAX_PLAYERS];
+	for (int i = 0; i < MAX_PLAYERS; i++) {
+		targets[i].x = 50 + rng() % 540;
+		targets[i].y = 50 + rng() % 380;
+	}
+	std::vector<Vec2> rayStarts(256);
+	std::vector<Vec2> rayDirections(256);
+	for (int i = 0; i < (int) rayStarts.size(); i++) {
+		rayStarts[i].x = 20 + rng() % 600;
+		rayStarts[i].y = 20 + rng() % 440;
+		Angle angle = {(u32) rng()};
+		rayDirections[i].x = AngleCosine(angle);
+		rayDirections[i].y = AngleSine(angle);
+	}
+	int rayMask = rayStarts.size() - 1;
+	results.push_back(SummarizeBench("CastBotRay", "width=8 height=6 targets=4", "ns_per_call", SampleCalls(100000, [&](u32 i) {
+		return (f32) CastBotRay(map, rayStarts[i & rayMask], rayDirections[i & rayMask], targets, MAX_PLAYERS, 0).cells;
+	})));
+	delete map;
+
+	PrintBenchResults(results, BenchWantsJson(argc, argv));
+	return 0;
+}
\ No newline at end of file
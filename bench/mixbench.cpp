@@ -0,0 +1,80 @@
+// checks the host mixer's sse2 kernels against its plain loops (they have to give exactly the same samples) and times both (run with make bench)
+#include <stdio.h>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include "mixer.h"
+
+// samples per call (a 60th of a second of stereo, like the host runner mixes each frame), and calls timed per kernel
+#define BENCH_SAMPLES 1470
+#define BENCH_CALLS 200000
+// voices mixed at once for the whole frame timing (the game's voice budget, SOUND_VOICES)
+#define BENCH_VOICES 8
+
+// keeps the compiler from throwing away the results being timed
+static volatile s32 sink;
+
+// returns the nanoseconds per call it took to run the function BENCH_CALLS times
+template <typename Function> static double TimeCalls(Function function) {
+	auto start = std::chrono::steady_clock::now();
+	for (u32 i = 0; i < BENCH_CALLS; i++) function(i);
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / BENCH_CALLS;
+}
+
+int main() {
+	std::mt19937 rng(1);
+	// full scale noise, with the extremes thrown in, so products and sums hit every edge
+	std::vector<s16> samples(BENCH_SAMPLES + 8);
+	for (int i = 0; i < (int) samples.size(); i++) samples[i] = i % 61 == 0 ? -32768 : i % 67 == 0 ? 32767 : (s16) rng();
+
+	// accuracy: every volume, at every alignment and a count that leaves a tail for the plain loop, onto mixes that are already near (and past) the clamp
+	int mixMismatches = 0;
+	int clampMismatches = 0;
+	std::vector<s32> simdMix(BENCH_SAMPLES);
+	std::vector<s32> scalarMix(BENCH_SAMPLES);
+	std::vector<s16> simdOutput(BENCH_SAMPLES);
+	std::vector<s16> scalarOutput(BENCH_SAMPLES);
+	for (int volume = 0; volume <= MIXER_FULL_VOLUME; volume++) {
+		int offset = volume % 8;
+		int count = BENCH_SAMPLES - volume % 13;
+		for (int i = 0; i < count; i++) simdMix[i] = scalarMix[i] = (s32) (rng() % 262144) - 131072;
+		MixSamples(&simdMix[0], &samples[offset], count, volume);
+		MixSamplesScalar(&scalarMix[0], &samples[offset], count, volume);
+		ClampMix(&simdOutput[0], &simdMix[0], count);
+		ClampMixScalar(&scalarOutput[0], &scalarMix[0], count);
+		for (int i = 0; i < count; i++) {
+			if (simdMix[i] != scalarMix[i]) mixMismatches++;
+			if (simdOutput[i] != scalarOutput[i]) clampMismatches++;
+		}
+	}
+
+	// speed: one voice's worth of mixing, one clamp, and a whole frame of every voice at once
+	double simdMixTime = TimeCalls([&](u32 i) { MixSamples(&simdMix[0], &samples[i % 8], BENCH_SAMPLES, MIXER_FULL_VOLUME); });
+	double scalarMixTime = TimeCalls([&](u32 i) { MixSamplesScalar(&scalarMix[0], &samples[i % 8], BENCH_SAMPLES, MIXER_FULL_VOLUME); });
+	double simdClampTime = TimeCalls([&](u32 i) { ClampMix(&simdOutput[0], &simdMix[0], BENCH_SAMPLES); });
+	double scalarClampTime = TimeCalls([&](u32 i) { ClampMixScalar(&scalarOutput[0], &scalarMix[0], BENCH_SAMPLES); });
+	MixerVoice voices[BENCH_VOICES];
+	double voicesTime = TimeCalls([&](u32 i) {
+		for (int voice = 0; voice < BENCH_VOICES; voice++) voices[voice] = {&samples[0], BENCH_SAMPLES / 2, 0, MIXER_STEP(MIXER_RATE), 2, MIXER_FULL_VOLUME};
+		MixVoices(voices, BENCH_VOICES, &simdOutput[0], BENCH_SAMPLES / 2, &simdMix[0]);
+	});
+	// the same, with the sound effects' packed format (mono 22.05khz, so each voice is expanded first)
+	double monoVoicesTime = TimeCalls([&](u32 i) {
+		for (int voice = 0; voice < BENCH_VOICES; voice++) voices[voice] = {&samples[0], BENCH_SAMPLES / 4, 0, MIXER_STEP(22050), 1, MIXER_FULL_VOLUME};
+		MixVoices(voices, BENCH_VOICES, &simdOutput[0], BENCH_SAMPLES / 2, &simdMix[0]);
+	});
+	sink = simdMix[0] + scalarMix[0] + simdOutput[0] + scalarOutput[0];
+	printf("kernel,simd_ns,scalar_ns,speedup,mismatches\n");
+	printf("mix_samples,%.1f,%.1f,%.2f,%d\n", simdMixTime, scalarMixTime, scalarMixTime / simdMixTime, mixMismatches);
+	printf("clamp_mix,%.1f,%.1f,%.2f,%d\n", simdClampTime, scalarClampTime, scalarClampTime / simdClampTime, clampMismatches);
+	printf("mix_voices_%d,%.1f,,,\n", BENCH_VOICES, voicesTime);
+	printf("mix_voices_%d_mono_22khz,%.1f,,,\n", BENCH_VOICES, monoVoicesTime);
+	// fail if the kernels don't match the plain loops exactly
+	if (mixMismatches || clampMismatches) {
+		printf("kernels don't match\n");
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
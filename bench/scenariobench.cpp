@@ -0,0 +1,177 @@
+// steps whole scenarios (some number of tanks and bullets on a map of some size) for a number of frames and times every frame (run with make bench; -json for json output)
+// with no arguments it runs a fixed set of scenarios, and the whole game with random input; -tanks n -bullets n -width n -height n -frames n runs just that one
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+
+#include "benchstats.h"
+#include "platform_host.h"
+#include "game.h"
+
+// cells are this big in every scenario (about the game's size), so bigger maps just cover more screen
+#define SCENARIO_CELL_SIZE 80
+#define SCENARIO_WALL_THICKNESS 8
+
+struct Scenario {
+	int tanks;
+	int bullets;
+	int width; // in cells
+	int height;
+	int frames;
+};
+
+// random but tank-like input (the same as the host runner's): each player holds a direction for a while, then picks another, and fires every so often
+static void RandomInput(InputState* input, std::mt19937* rng) {
+	static const u32 directions[] = {0, BUTTON_2, BUTTON_LEFT, BUTTON_UP, BUTTON_DOWN, BUTTON_2 | BUTTON_UP, BUTTON_2 | BUTTON_DOWN, BUTTON_LEFT | BUTTON_UP};
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		PlayerInput* playerInput = &input->players[player];
+		u32 previous = playerInput->held;
+		if ((*rng)() % 20 == 0) playerInput->held = directions[(*rng)() % 8];
+		playerInput->held = (playerInput->held & ~BUTTON_1) | ((*rng)() % 15 == 0 ? BUTTON_1 : 0);
+		playerInput->down = playerInput->held & ~previous;
+		playerInput->pointerX = -100;
+		playerInput->pointerY = -100;
+		playerInput->pointerAngle = 0;
+	}
+}
+
+// puts a tank in the middle of a random cell (tanks past the 4th share players' inputs and colors)
+static void SpawnScenarioTank(int index, LayerManager* tankManager, EntityPools* pools, TextureCache* textures, SoundQueue* sounds, const Scenario* scenario, std::mt19937* rng) {
+	Tank* tank = new (&pools->tanks) Tank(index % MAX_PLAYERS, 6, pools, textures, sounds);
+	if (!tank) return;
+	f32 x = ((*rng)() % scenario->width + .5) * SCENARIO_CELL_SIZE + SCENARIO_WALL_THICKNESS / 2;
+	f32 y = ((*rng)() % scenario->height + .5) * SCENARIO_CELL_SIZE + SCENARIO_WALL_THICKNESS / 2;
+	tank->SetPosition(x - tank->GetWidth() / 2, y - tank->GetHeight() / 2);
+	tank->SetRotation((*rng)() % 180);
+	tank->SavePose();
+	tankManager->Append(tank);
+}
+
+// fires a bullet from the middle of a random cell in a random direction, lasting the whole run
+static void SpawnScenarioBullet(int index, BulletSystem* bullets, const Scenario* scenario, std::mt19937* rng) {
+	f32 x = ((*rng)() % scenario->width + .5) * SCENARIO_CELL_SIZE + SCENARIO_WALL_THICKNESS / 2;
+	f32 y = ((*rng)() % scenario->height + .5) * SCENARIO_CELL_SIZE + SCENARIO_WALL_THICKNESS / 2;
+	bullets->Spawn(index % MAX_PLAYERS, x, y, {(u32) (*rng)()}, 2, 4, scenario->frames + 1);
+}
+
+// steps a scenario the way Game::Update does (spinners, bullets, tanks, then explosions) and returns the microseconds each frame took
+// (tanks that die and bullets that hit them are replaced between frames, so the load stays the same throughout)
+static std::vector<double> RunScenario(const Scenario* scenario) {
+	std::mt19937 rng(1);
+	f32 screenWidth = scenario->width * SCENARIO_CELL_SIZE + SCENARIO_WALL_THICKNESS;
+	f32 screenHeight = scenario->height * SCENARIO_CELL_SIZE + SCENARIO_WALL_THICKNESS;
+	TextureCache textures;
+	textures.Preload();
+	int tankAmmo = 6;
+	SoundQueue sounds;
+	BulletSystem bullets(scenario->bullets + scenario->tanks * tankAmmo, screenWidth, screenHeight, &textures, &sounds);
+	EntityPools pools(scenario->tanks, scenario->tanks);
+	LayerManager tankManager(scenario->tanks);
+	LayerManager explosionManager(scenario->tanks);
+	LayerManager wallManager(scenario->width * scenario->height * 2 + scenario->width + scenario->height);
+	Map* map = new Map(screenWidth, screenHeight, scenario->width, scenario->height, SCENARIO_WALL_THICKNESS, 1);
+	map->GenerateWalls(&wallManager);
+	for (int i = 0; i < scenario->tanks; i++) SpawnScenarioTank(i, &tankManager, &pools, &textures, &sounds, scenario, &rng);
+	for (int i = 0; i < scenario->bullets; i++) SpawnScenarioBullet(i, &bullets, scenario, &rng);
+	Broadphase broadphase;
+	ResetBroadphase(&broadphase, scenario->tanks, bullets.GetCapacity());
+	InputState input;
+	memset(&input, 0, sizeof(InputState));
+	std::vector<double> frameTimes;
+	for (int frame = 0; frame < scenario->frames; frame++) {
+		RandomInput(&input, &rng);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		bullets.SavePoses();
+		for (int i = 0; i < (int) tankManager.GetSize(); i++) ((Tank*) tankManager.GetLayerAt(i))->SavePose();
+		for (int i = 0; i < map->GetSpinningWalls(); i++) {
+			Quad* spinningWall = (Quad*) wallManager.GetLayerAt(i);
+			spinningWall->SetRotation(AngleToHalfDegrees(HalfDegreesToAngle(spinningWall->GetRotation()) + HalfDegreesToAngle(.5)));
+		}
+		map->UpdateWallGrid(&wallManager);
+		bullets.Update(1, map->GetWallGrid());
+		for (int i = 0; i < (int) tankManager.GetSize(); i++) ((Tank*) tankManager.GetLayerAt(i))->Update(&input, 1, map->GetWallGrid());
+		UpdateBroadphase(&broadphase, &tankManager, &bullets);
+		HitTanks(&broadphase, &tankManager, &bullets, &explosionManager);
+		for (int i = 0; i < (int) tankManager.GetSize(); i++) ((Tank*) tankManager.GetLayerAt(i))->Fire(&input, &bullets);
+		for (int i = 0; i < (int) explosionManager.GetSize(); i++) {
+			int explosions = explosionManager.GetSize();
+			((Explosion*) explosionManager.GetLayerAt(i))->Update(&explosionManager);
+			if ((int) explosionManager.GetSize() < explosions) i--; // repeat index because the explosion ended
+		}
+		sounds.Play();
+		frameTimes.push_back(BenchElapsed<std::micro>(start));
+		for (int i = tankManager.GetSize(); i < scenario->tanks; i++) SpawnScenarioTank(i, &tankManager, &pools, &textures, &sounds, scenario, &rng);
+		for (int i = bullets.GetCount(); i < scenario->bullets; i++) SpawnScenarioBullet(i, &bullets, scenario, &rng);
+	}
+	ClearLayerManager(&tankManager);
+	ClearLayerManager(&explosionManager);
+	map->Destroy(&wallManager);
+	return frameTimes;
+}
+
+// runs the whole game (4 players, random input, drawing included) for a number of frames and returns the microseconds each frame took
+static std::vector<double> RunGame(int frames) {
+	GameWindow* gwd = new GameWindow();
+	InitPlatform(gwd);
+	Game* game = new Game(gwd->GetWidth(), gwd->GetHeight(), 1);
+	game->StartGame(MAX_PLAYERS);
+	std::mt19937 rng(1);
+	InputState input;
+	memset(&input, 0, sizeof(InputState));
+	std::vector<double> frameTimes;
+	for (int frame = 0; frame < frames; frame++) {
+		RandomInput(&input, &rng);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		game->Update(&input);
+		game->PlaySounds();
+		game->Draw();
+		gwd->Flush();
+		frameTimes.push_back(BenchElapsed<std::micro>(start));
+	}
+	delete game;
+	ShutdownPlatform(gwd);
+	delete gwd;
+	return frameTimes;
+}
+
+int main(int argc, char** argv) {
+	std::vector<Scenario> scenarios;
+	Scenario custom = {4, 0, 8, 6, 3600};
+	bool customized = false;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-json")) continue;
+		if (i + 1 >= argc) break;
+		if (!strcmp(argv[i], "-tanks")) custom.tanks = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-bullets")) custom.bullets = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-width")) custom.width = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-height")) custom.height = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-frames")) custom.frames = atoi(argv[++i]);
+		else continue;
+		customized = true;
+	}
+	if (custom.tanks < 1 || custom.bullets < 0 || custom.width < 2 || custom.height < 2 || custom.frames < 1) {
+		fprintf(stderr, "usage: %s [-tanks n (1+)] [-bullets n] [-width cells (2+)] [-height cells (2+)] [-frames n] [-json]\n", argv[0]);
+		return 1;
+	}
+	if (customized) scenarios.push_back(custom);
+	else {
+		// the game as it is, a busy round, bullet hell, and a bigger map with more of everything
+		scenarios.push_back({4, 0, 8, 6, 3600});
+		scenarios.push_back({4, 24, 8, 6, 3600});
+		scenarios.push_back({4, 200, 8, 6, 3600});
+		scenarios.push_back({16, 400, 16, 12, 1800});
+	}
+
+	std::vector<BenchResult> results;
+	for (int i = 0; i < (int) scenarios.size(); i++) {
+		const Scenario* scenario = &scenarios[i];
+		char parameters[128];
+		snprintf(parameters, sizeof(parameters), "tanks=%d bullets=%d width=%d height=%d frames=%d", scenario->tanks, scenario->bullets, scenario->width, scenario->height, scenario->frames);
+		results.push_back(SummarizeBench("scenario", parameters, "us_per_frame", RunScenario(scenario)));
+	}
+	if (!customized) results.push_back(SummarizeBench("game", "players=4 frames=3600", "us_per_frame", RunGame(3600)));
+
+	PrintBenchResults(results, BenchWantsJson(argc, argv));
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#---------------------------------------------------------------------------------
+# host build: compiles the game with the system compiler so it can run headless
+# on a pc (for benchmarks, perf, valgrind, and sanitizers); included by the
+# Makefile for host goals
+#
+# make host                            builds build-host/wii-trouble-host and build-host/wii-trouble-batch
+# make host SANITIZE=address,undefined builds it with sanitizers (in build-host-sanitize)
+# make bench                           builds and runs the benchmarks
+# make test                            builds and runs the tests
+# make assets                          converts and packs the data into build-host/data/assets.wta and prints what went in
+#---------------------------------------------------------------------------------
+HOSTCXX		?=	g++
+HOSTBUILD	:=	build-host
+HOSTCXXFLAGS	:=	-g -O2 -Wall -std=gnu++14 -MMD -MP -Ihost/include -Ihost -Isource $(if $(POOL_DEBUG),-DPOOL_DEBUG) $(if $(PROFILE),-DPROFILE)
+HOSTLDFLAGS	:=	-g -pthread
+
+ifneq ($(strip $(SANITIZE)),)
+HOSTBUILD	:=	build-host-sanitize
+HOSTCXXFLAGS	+=	-fsanitize=$(SANITIZE) -fno-omit-frame-pointer
+HOSTLDFLAGS	+=	-fsanitize=$(SANITIZE)
+endif
+
+#---------------------------------------------------------------------------------
+# the game code is everything in source except the wii's own main, platform
+# backend and render backend, which host/ replaces (along with libwiisprite)
+#---------------------------------------------------------------------------------
+HOSTGAMEFILES	:=	$(filter-out source/main.cpp source/platform_wii.cpp source/renderer_wii.cpp,$(wildcard source/*.cpp)) \
+					host/platform_host.cpp host/renderer_host.cpp host/mixer.cpp host/wiisprite.cpp
+HOSTGAMEOBJS	:=	$(HOSTGAMEFILES:%.cpp=$(HOSTBUILD)/%.o)
+
+#---------------------------------------------------------------------------------
+# data files are packed into one archive by the asset packer, with the pngs
+# converted to gx textures first (see tools/assetpack.cpp and tools/texconv.cpp,
+# which are built straight from their sources, since the game objects below
+# wait on the data), then embedded like bin2o does on the wii
+#---------------------------------------------------------------------------------
+HOSTDATASOURCES	:=	$(HOSTBUILD)/data/assets_wta.S
+HOSTDATAOBJS	:=	$(HOSTDATASOURCES:.S=.o)
+HOSTTEXTURES	:=	$(patsubst data/%.png,$(HOSTBUILD)/data/%.tex,$(wildcard data/*.png))
+HOSTASSETFILES	:=	$(filter-out %.png,$(wildcard data/*.*)) $(HOSTTEXTURES)
+
+$(HOSTBUILD)/assetpack: $(ASSETPACKFILES) source/assetarchive.h host/mixer.h
+	@mkdir -p $(HOSTBUILD)
+	$(HOSTCXX) $(filter-out -MMD -MP,$(HOSTCXXFLAGS)) $(HOSTLDFLAGS) -o $@ $(ASSETPACKFILES)
+
+$(HOSTBUILD)/texconv: $(TEXCONVFILES) source/tiledtexture.h
+	@mkdir -p $(HOSTBUILD)
+	$(HOSTCXX) $(filter-out -MMD -MP,$(HOSTCXXFLAGS)) $(HOSTLDFLAGS) -o $@ $(TEXCONVFILES) -lpng
+
+$(HOSTBUILD)/data/%.tex: data/%.png $(HOSTBUILD)/texconv
+	@mkdir -p $(HOSTBUILD)/data
+	@./$(HOSTBUILD)/texconv $(TEXCONVFLAGS_$*) $< $@ > $@.csv
+
+$(HOSTBUILD)/data/assets.wta: $(HOSTASSETFILES) $(HOSTBUILD)/assetpack
+	@./$(HOSTBUILD)/assetpack $@ $(HOSTASSETFILES) > $(HOSTBUILD)/data/assets.csv
+
+$(HOSTBUILD)/data/assets_wta.S: $(HOSTBUILD)/data/assets.wta host/bin2s.sh
+	@sh host/bin2s.sh $(CURDIR)/$< assets_wta $(HOSTBUILD)/data
+
+$(HOSTBUILD)/data/%.o: $(HOSTBUILD)/data/%.S
+	$(HOSTCXX) -c -o $@ $<
+
+#---------------------------------------------------------------------------------
+# game objects need the data headers to exist before they're compiled
+#---------------------------------------------------------------------------------
+$(HOSTBUILD)/%.o: %.cpp | $(HOSTDATASOURCES)
+	@mkdir -p $(dir $@)
+	$(HOSTCXX) $(HOSTCXXFLAGS) -I$(HOSTBUILD)/data -c -o $@ $<
+
+-include $(HOSTGAMEOBJS:.o=.d) $(HOSTBUILD)/host/main.d $(HOSTBUILD)/host/batch.d $(HOSTBUILD)/host/workstealingpool.d $(wildcard $(HOSTBUILD)/bench/*.d) $(wildcard $(HOSTBUILD)/test/*.d)
+
+.PHONY: host bench test assets
+
+host: $(HOSTBUILD)/wii-trouble-host $(HOSTBUILD)/wii-trouble-batch
+
+# converts and packs (and checks) the assets on their own, printing each texture's conversion and then what went into the archive
+assets: $(HOSTBUILD)/data/assets.wta
+	@echo texture,format,width,height,png_bytes,texture_bytes,max_error,png_decode_us
+	@cat $(HOSTTEXTURES:=.csv)
+	@cat $(HOSTBUILD)/data/assets.csv
+
+$(HOSTBUILD)/wii-trouble-host: $(HOSTBUILD)/host/main.o $(HOSTGAMEOBJS) $(HOSTDATAOBJS)
+	$(HOSTCXX) $(HOSTLDFLAGS) -o $@ $^
+
+# plays many matches at once across every core (see host/batch.cpp)
+$(HOSTBUILD)/wii-trouble-batch: $(HOSTBUILD)/host/batch.o $(HOSTBUILD)/host/workstealingpool.o $(HOSTGAMEOBJS) $(HOSTDATAOBJS)
+	$(HOSTCXX) $(HOSTLDFLAGS) -o $@ $^
+
+#---------------------------------------------------------------------------------
+# benchmarks (each one prints its results as csv; microbench and scenariobench
+# print json instead with make bench BENCHARGS=-json)
+#---------------------------------------------------------------------------------
+BENCHES		:=	anglebench mixbench microbench scenariobench
+
+bench: $(foreach bench,$(BENCHES),$(HOSTBUILD)/$(bench))
+	@$(foreach bench,$(BENCHES),echo $(bench) && ./$(HOSTBUILD)/$(bench) $(BENCHARGS) &&) true
+
+$(HOSTBUILD)/anglebench: $(HOSTBUILD)/bench/anglebench.o $(HOSTBUILD)/source/angle.o
+	$(HOSTCXX) $(HOSTLDFLAGS) -o $@ $^
+
+$(HOSTBUILD)/mixbench: $(HOSTBUILD)/bench/mixbench.o $(HOSTBUILD)/host/mixer.o
+	$(HOSTCXX) $(HOSTLDFLAGS) -o $@ $^
+
+$(HOSTBUILD)/microbench $(HOSTBUILD)/scenariobench: $(HOSTBUILD)/%: $(HOSTBUILD)/bench/%.o $(HOSTGAMEOBJS) $(HOSTDATAOBJS)
+	$(HOSTCXX) $(HOSTLDFLAGS) -o $@ $^
+
+#---------------------------------------------------------------------------------
+# tests (each one checks part of the game against a simpler version of it, and
+# exits with 1 if anything didn't match, which stops make test there)
+#---------------------------------------------------------------------------------
+TESTS		:=	collisiontest wallbatchtest wallbatchtest-scalar wallgridtest bulletsystemtest rendertest replaytest
+
+test: $(foreach test,$(TESTS),$(HOSTBUILD)/$(test))
+	@$(foreach test,$(TESTS),./$(HOSTBUILD)/$(test) &&) true
+
+$(foreach test,$(filter-out %-scalar,$(TESTS)),$(HOSTBUILD)/$(test)): $(HOSTBUILD)/%: $(HOSTBUILD)/test/%.o $(HOSTGAMEOBJS) $(HOSTDATAOBJS)
+	$(HOSTCXX) $(HOSTLDFLAGS) -o $@ $^
+
+# the wall batch test again, built with the plain c kernel in place of the
+# host's simd one, so both are checked against the same reference
+$(HOSTBUILD)/test/wallbatch-scalar.o: source/wallbatch.cpp | $(HOSTDATASOURCES)
+	@mkdir -p $(dir $@)
+	$(HOSTCXX) $(HOSTCXXFLAGS) -DWALLBATCH_SCALAR -I$(HOSTBUILD)/data -c -o $@ $<
+
+$(HOSTBUILD)/wallbatchtest-scalar: $(HOSTBUILD)/test/wallbatchtest.o $(HOSTBUILD)/test/wallbatch-scalar.o $(filter-out $(HOSTBUILD)/source/wallbatch.o,$(HOSTGAMEOBJS)) $(HOSTDATAOBJS)
+	$(HOSTCXX) $(HOSTLDFLAGS) -o $@ $^
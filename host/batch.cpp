@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <algorithm>
+
+#include "platform_host.h"
+#include "workstealingpool.h"
+#include "game.h"
+
+using namespace wsp;
+
+// headless batch runner: plays a lot of independent matches as fast as it can, spread over every core, and prints what happened in them all (for balance tuning and regression testing)
+// a match is a game (the real game code, menu skipped) with -tanks tanks and -ammo shots each, played until -rounds rounds have been decided, or -max-steps steps have gone by
+// match i is seeded with -seed + i, so the same settings always give the same results however many threads run them,
+// and a match can be watched on its own with the host runner (wii-trouble-host -seed <seed + i> -players <tanks> plays it with the same random input)
+// input is random, like the host runner's, or with -script, every match plays the buttons from a replay (from the start again each time it runs out);
+// -bots has the computer play the last n tanks instead (so -bots 2 pits two bots against two random players, and -bots 4 is bots only)
+// each match has its own game, input and results, and the host platform's state is per thread, so nothing that changes is shared between matches but the pool's queues
+// stats by corner are in player order: top left, top right, bottom left, bottom right (see Map::SpawnTanks)
+
+// what's known about a match once it's been played
+struct MatchResult {
+	GameStats stats;
+	u32 steps;
+	u32 stateHash; // the game's state at the end (all of them are hashed together, to tell if a change made any match play out differently)
+	u32 botUpdates; // what the bots cost (see BotPlayers)
+	u64 botTicks;
+	u64 botMaxTicks;
+	u64 botRays;
+};
+
+// what every match is played with
+struct BatchSettings {
+	int matches;
+	int rounds;
+	u32 maxSteps;
+	int tanks;
+	int ammo;
+	int bots;
+	u32 seed;
+	u32 screenWidth;
+	u32 screenHeight;
+	const Replay* script; // NULL for random input
+};
+
+// random but tank-like input (the same as the host runner's): each player holds a direction for a while, then picks another, and fires every so often
+static void RandomInput(InputState* input, int players, std::mt19937* rng) {
+	static const u32 directions[] = {0, BUTTON_2, BUTTON_LEFT, BUTTON_UP, BUTTON_DOWN, BUTTON_2 | BUTTON_UP, BUTTON_2 | BUTTON_DOWN, BUTTON_LEFT | BUTTON_UP};
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		PlayerInput* playerInput = &input->players[player];
+		u32 previous = playerInput->held;
+		if (player >= players) {
+			playerInput->held = 0;
+		}
+		else {
+			if ((*rng)() % 20 == 0) playerInput->held = directions[(*rng)() % 8];
+			playerInput->held = (playerInput->held & ~BUTTON_1) | ((*rng)() % 15 == 0 ? BUTTON_1 : 0);
+		}
+		playerInput->down = playerInput->held & ~previous;
+		playerInput->pointerX = -100; // pointing off screen
+		playerInput->pointerY = -100;
+		playerInput->pointerAngle = 0;
+	}
+}
+
+// the next step of a script's input, going back to its start when it runs out (its hashes are ignored, since the match isn't the game it was recorded from)
+static void ScriptedInput(InputState* input, Replay* script) {
+	u32 hash;
+	if (ReadReplayStep(script, input, &hash)) return;
+	RewindReplay(script);
+	if (!ReadReplayStep(script, input, &hash)) memset(input, 0, sizeof(InputState)); // (an empty script is no input at all)
+}
+
+// plays one match
+static void RunMatch(const BatchSettings* settings, int index, MatchResult* result) {
+	u32 seed = settings->seed + index;
+	Game* game = new Game(settings->screenWidth, settings->screenHeight, seed, settings->ammo);
+	game->StartGame(settings->tanks);
+	game->SetBots(((1 << settings->tanks) - 1) & ~((1 << (settings->tanks - settings->bots)) - 1));
+	std::mt19937 rng(seed);
+	Replay script; // this match's own copy, so it has its own place in the script
+	if (settings->script) {
+		script = *settings->script;
+		RewindReplay(&script);
+	}
+	InputState input;
+	memset(&input, 0, sizeof(InputState));
+	u32 step;
+	for (step = 0; step < settings->maxSteps && game->GetStats()->rounds < settings->rounds; step++) {
+		if (settings->script) ScriptedInput(&input, &script);
+		else RandomInput(&input, settings->tanks, &rng);
+		game->Update(&input);
+		game->PlaySounds();
+	}
+	result->stats = *game->GetStats();
+	result->steps = step;
+	result->stateHash = game->GetStateHash();
+	const BotPlayers* bots = game->GetBots();
+	result->botUpdates = bots->GetUpdates();
+	result->botTicks = bots->GetTicks();
+	result->botMaxTicks = bots->GetMaxTicks();
+	result->botRays = bots->GetRays();
+	delete game;
+}
+
+// prints one number for each corner, separated by slashes
+static void PrintByCorner(const char* name, const u64* values) {
+	printf("%s", name);
+	for (int corner = 0; corner < MAX_PLAYERS; corner++) printf("%c%llu", corner ? '/' : ' ', (unsigned long long) values[corner]);
+	printf("\n");
+}
+
+int main(int argc, char** argv) {
+	BatchSettings settings;
+	settings.matches = 100;
+	settings.rounds = 5;
+	settings.maxSteps = 60 * 60 * 10; // 10 minutes of game time
+	settings.tanks = MAX_PLAYERS;
+	settings.ammo = 6;
+	settings.bots = 0;
+	settings.seed = 1;
+	settings.script = NULL;
+	int threads = 0;
+	const char* scriptPath = NULL;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "-matches")) settings.matches = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-rounds")) settings.rounds = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-max-steps")) settings.maxSteps = strtoul(argv[i + 1], NULL, 0);
+		else if (!strcmp(argv[i], "-tanks")) settings.tanks = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-ammo")) settings.ammo = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-bots")) settings.bots = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-seed")) settings.seed = strtoul(argv[i + 1], NULL, 0);
+		else if (!strcmp(argv[i], "-threads")) threads = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-script")) scriptPath = argv[i + 1];
+		else {
+			fprintf(stderr, "usage: %s [-matches n] [-rounds per match] [-max-steps per match] [-tanks 2-4] [-ammo shots per tank] [-bots n] [-seed first match's seed] [-threads n (0 for one per core)] [-script replay file]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (settings.tanks < 2 || settings.tanks > MAX_PLAYERS) {
+		fprintf(stderr, "tanks must be 2-%d\n", MAX_PLAYERS);
+		return 1;
+	}
+	if (settings.bots < 0 || settings.bots > settings.tanks) {
+		fprintf(stderr, "bots must be 0-%d\n", settings.tanks);
+		return 1;
+	}
+	if (settings.matches < 1 || settings.rounds < 1 || settings.ammo < 1 || threads < 0) {
+		fprintf(stderr, "matches, rounds and ammo must be at least 1 (and threads at least 0)\n");
+		return 1;
+	}
+	Replay script;
+	if (scriptPath) {
+		if (!LoadReplay(&script, scriptPath)) {
+			fprintf(stderr, "couldn't load script %s\n", scriptPath);
+			return 1;
+		}
+		settings.script = &script;
+	}
+	// the screen's size is all the game needs from the window (it's the same for every match)
+	GameWindow* gwd = new GameWindow();
+	InitPlatform(gwd);
+	settings.screenWidth = gwd->GetWidth();
+	settings.screenHeight = gwd->GetHeight();
+
+	std::vector<MatchResult> results(settings.matches); // each match only writes its own
+	WorkStealingPool pool(threads);
+	u64 start = GetClockTicks();
+	pool.Run(settings.matches, [&settings, &results](int index, int thread) { RunMatch(&settings, index, &results[index]); });
+	f64 seconds = ClockTicksToSeconds(GetClockTicks() - start);
+
+	// add every match up, in match order
+	u64 steps = 0, roundSteps = 0, shots = 0, bounces = 0, draws = 0;
+	u64 botUpdates = 0, botTicks = 0, botMaxTicks = 0, botRays = 0;
+	u64 rounds = 0;
+	u32 shortestRound = 0, longestRound = 0;
+	int unfinished = 0;
+	u64 wins[MAX_PLAYERS] = {}, kills[MAX_PLAYERS] = {}, deaths[MAX_PLAYERS] = {}, selfKills[MAX_PLAYERS] = {};
+	u32 resultsHash = STATE_HASH_START;
+	for (int i = 0; i < settings.matches; i++) {
+		const MatchResult* result = &results[i];
+		const GameStats* stats = &result->stats;
+		steps += result->steps;
+		if (stats->rounds < settings.rounds) unfinished++;
+		if (stats->rounds && (!rounds || stats->shortestRound < shortestRound)) shortestRound = stats->shortestRound;
+		if (stats->longestRound > longestRound) longestRound = stats->longestRound;
+		rounds += stats->rounds;
+		roundSteps += stats->roundSteps;
+		draws += stats->draws;
+		shots += stats->shots;
+		bounces += stats->bounces;
+		for (int corner = 0; corner < MAX_PLAYERS; corner++) {
+			wins[corner] += stats->wins[corner];
+			selfKills[corner] += stats->kills[corner][corner];
+			for (int other = 0; other < MAX_PLAYERS; other++) {
+				kills[corner] += stats->kills[corner][other];
+				deaths[corner] += stats->kills[other][corner];
+			}
+		}
+		botUpdates += result->botUpdates;
+		botTicks += result->botTicks;
+		botMaxTicks = std::max(botMaxTicks, result->botMaxTicks);
+		botRays += result->botRays;
+		resultsHash = AddToStateHash(resultsHash, result->stateHash);
+	}
+
+	printf("matches %d\n", settings.matches);
+	printf("matches_unfinished %d\n", unfinished); // ran out of steps before all their rounds were decided
+	printf("tanks %d\n", settings.tanks);
+	printf("ammo %d\n", settings.ammo);
+	printf("bots %d\n", settings.bots);
+	printf("rounds %llu\n", (unsigned long long) rounds);
+	printf("round_steps_mean %.1f\n", rounds ? (f64) roundSteps / rounds : 0);
+	printf("round_steps_min_max %u/%u\n", shortestRound, longestRound);
+	printf("draws %llu\n", (unsigned long long) draws);
+	PrintByCorner("wins_by_corner", wins);
+	PrintByCorner("kills_by_corner", kills); // tanks destroyed by each corner's bullets (including their own)
+	PrintByCorner("deaths_by_corner", deaths);
+	PrintByCorner("self_kills_by_corner", selfKills);
+	printf("shots %llu\n", (unsigned long long) shots);
+	printf("shots_per_round %.2f\n", rounds ? (f64) shots / rounds : 0);
+	printf("bounces %llu\n", (unsigned long long) bounces);
+	printf("bounces_per_shot %.2f\n", shots ? (f64) bounces / shots : 0);
+	if (settings.bots) {
+		printf("bot_microseconds_per_step %.2f/%.2f\n", botUpdates ? ClockTicksToSeconds(botTicks) * 1e6 / botUpdates : 0, ClockTicksToSeconds(botMaxTicks) * 1e6); // mean/max (the max is for one step)
+		printf("bot_rays_per_step %.2f\n", botUpdates ? (f64) botRays / botUpdates : 0);
+	}
+	printf("threads %d\n", pool.GetThreadCount());
+	printf("matches_by_thread");
+	int steals = 0;
+	for (int thread = 0; thread < pool.GetThreadCount(); thread++) {
+		printf("%c%d", thread ? '/' : ' ', pool.GetTasksRun(thread));
+		steals += pool.GetSteals(thread);
+	}
+	printf("\n");
+	printf("matches_stolen %d\n", steals);
+	printf("steps %llu\n", (unsigned long long) steps);
+	printf("seconds %.3f\n", seconds);
+	printf("simulated_frames_per_second %.0f\n", steps / seconds);
+	printf("results_hash %08x\n", (unsigned int) resultsHash);
+
+	ShutdownPlatform(gwd);
+	delete gwd;
+	return 0;
+}
\ No newline at end of file
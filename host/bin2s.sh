@@ -0,0 +1,36 @@
+#!/bin/sh
+# host version of devkitpro's bin2o: embeds a data file as an assembly file plus a header declaring name, name_end and name_size
+# usage: bin2s.sh <file, or - for an empty one> <symbol name> <output directory>
+set -e
+file=$1
+name=$2
+out=$3
+incbin=
+[ "$file" = - ] || incbin=".incbin \"$file\""
+cat > "$out/$name.S" <<END
+	.section .rodata
+	.global $name
+	.global ${name}_end
+	.global ${name}_size
+	.balign 32
+$name:
+	$incbin
+${name}_end:
+	.balign 4
+${name}_size:
+	.int ${name}_end - $name
+	.section .note.GNU-stack,"",@progbits
+END
+cat > "$out/$name.h" <<END
+/* Generated by bin2s.sh - please don't edit directly */
+#ifndef TANK_HOST_DATA_${name}_H
+#define TANK_HOST_DATA_${name}_H
+
+#include <gccore.h>
+
+extern const u8 $name[];
+extern const u8 ${name}_end[];
+extern const u32 ${name}_size;
+
+#endif
+END
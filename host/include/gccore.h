@@ -0,0 +1,27 @@
+#ifndef TANK_HOST_GCCORE_H
+#define TANK_HOST_GCCORE_H
+
+// stand-in for libogc's gccore.h on host builds (just the types the game code and headless libwiisprite use)
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+typedef float f32;
+typedef double f64;
+
+typedef struct _gx_color {
+	u8 r;
+	u8 g;
+	u8 b;
+	u8 a;
+} GXColor;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+#ifndef TANK_HOST_WIISPRITE_H
+#define TANK_HOST_WIISPRITE_H
+
+#include <gccore.h>
+
+// headless stand-in for the parts of libwiisprite the game uses, so the game code builds on the host unchanged (this is the host's render backend)
+// layers keep all the same state and math (positions, sizes, frames, stretching, rotation), but drawing just counts what would have been drawn
+
+#define WSP_POINTER_CORRECTION_X 200
+#define WSP_POINTER_CORRECTION_Y 250
+
+namespace wsp {
+
+enum IMG_LOAD_ERROR { IMG_LOAD_ERROR_NONE = 0, IMG_LOAD_ERROR_NOT_FOUND, IMG_LOAD_ERROR_INV_PNG, IMG_LOAD_ERROR_PNG_FAIL, IMG_LOAD_ERROR_WRONG_SIZE, IMG_LOAD_ERROR_ALREADY_INIT };
+enum IMG_LOAD_TYPE { IMG_LOAD_TYPE_PATH, IMG_LOAD_TYPE_BUFFER };
+
+// only reads the size out of the png header, since nothing is ever drawn
+class Image {
+	public:
+		Image();
+		virtual ~Image();
+		IMG_LOAD_ERROR LoadImage(const unsigned char* buffer, IMG_LOAD_TYPE loadType = IMG_LOAD_TYPE_BUFFER);
+		u32 GetWidth() const;
+		u32 GetHeight() const;
+		bool IsInitialized() const;
+		void BindTexture(bool bilinear = true);
+	protected:
+		// the same members libwiisprite's image has (so TiledImage can set itself up the same way on both)
+		u32 _width;
+		u32 _height;
+		bool _initialized;
+};
+
+struct Rectangle {
+	f32 x;
+	f32 y;
+	f32 width;
+	f32 height;
+};
+
+class Layer {
+	public:
+		Layer();
+		virtual ~Layer();
+		u32 GetWidth() const;
+		u32 GetHeight() const;
+		f32 GetX() const;
+		f32 GetY() const;
+		bool IsVisible() const;
+		void SetVisible(bool visible);
+		u8 GetTransparency() const;
+		void SetTransparency(u8 alpha);
+		void SetPosition(f32 x, f32 y);
+		void Move(f32 deltaX, f32 deltaY);
+		virtual void Draw(f32 offsetX = 0, f32 offsetY = 0) const = 0;
+	protected:
+		void SetWidth(u32 width);
+		void SetHeight(u32 height);
+	private:
+		u32 width;
+		u32 height;
+		f32 x;
+		f32 y;
+		bool visible;
+		u8 transparency;
+};
+
+class Sprite : public Layer {
+	public:
+		Sprite();
+		virtual ~Sprite();
+		void SetImage(const Image* image, u32 frameWidth = 0, u32 frameHeight = 0);
+		const Image* GetImage() const;
+		void SetRotation(f32 rotation);
+		f32 GetRotation() const;
+		void SetZoom(f32 zoom);
+		f32 GetZoom() const;
+		void SetStretchWidth(f32 stretchWidth);
+		void SetStretchHeight(f32 stretchHeight);
+		f32 GetStretchWidth() const;
+		f32 GetStretchHeight() const;
+		void DefineCollisionRectangle(f32 x, f32 y, u32 width, u32 height);
+		const Rectangle* GetCollisionRectangle() const;
+		void SetFrame(u32 frame);
+		u32 GetFrame() const;
+		u32 GetFrameCount() const;
+		void Draw(f32 offsetX = 0, f32 offsetY = 0) const;
+	private:
+		const Image* image;
+		f32 rotation;
+		f32 stretchWidth;
+		f32 stretchHeight;
+		Rectangle collision;
+		u32 frame;
+		u32 frameCount;
+};
+
+class Quad : public Layer {
+	public:
+		Quad();
+		virtual ~Quad();
+		void SetWidth(u32 width);
+		void SetHeight(u32 height);
+		void SetRotation(f32 rotation);
+		f32 GetRotation() const;
+		void SetFillColor(GXColor color);
+		GXColor GetFillColor() const;
+		void Draw(f32 offsetX = 0, f32 offsetY = 0) const;
+	private:
+		f32 rotation;
+		GXColor fillColor;
+};
+
+class LayerManager {
+	public:
+		LayerManager(u32 boundary);
+		virtual ~LayerManager();
+		void Append(Layer* layer);
+		void Insert(Layer* layer, u32 index);
+		void Remove(Layer* layer);
+		void RemoveAll();
+		Layer* GetLayerAt(u32 index) const;
+		u32 GetSize() const;
+		void Draw(f32 offsetX = 0, f32 offsetY = 0) const;
+	private:
+		Layer** layers;
+		u32 boundary;
+		u32 size;
+};
+
+// host only: totals of what's been drawn on this thread (visible layers drawn, and frames flushed)
+struct HostDrawCounts {
+	u64 layers;
+	u64 frames;
+};
+HostDrawCounts* GetHostDrawCounts();
+
+class GameWindow {
+	public:
+		void InitVideo();
+		void StopVideo();
+		void SetBackground(GXColor color);
+		u32 GetWidth();
+		u32 GetHeight();
+		void Flush();
+};
+
+}
+
+#endif
\ No newline at end of file
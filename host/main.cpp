@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include "platform_host.h"
+#include "renderer_host.h"
+#include "game.h"
+
+using namespace wsp;
+
+// headless driver for the game: skips the menu, then plays rounds with random inputs for a set number of frames and prints what happened
+// (this is the real game code, so it can be run under perf/valgrind/sanitizers)
+// by default each frame is one simulation step; with -hz, frames go through the fixed timestep clock as if the display ran at that rate
+// (and with -realtime, frames are also spaced out to really run at that rate, like on the wii)
+// -record saves each game as a replay in a directory; -replay plays one back (as fast as possible unless -realtime) instead of random input,
+// checking the game's state against it every step, and exits with 2 if it ever doesn't match
+// -profile times every frame's phases (with the overlay drawn, like on the wii), prints the average of each, and writes the last few seconds to a file as a chrome trace
+// (the per frame counts of collision pairs and allocations are only kept in PROFILE builds, make host PROFILE=1, so they're only printed then)
+// sound effects are mixed as each frame's worth of time passes (a 60th of a second, or 1/hz), and -wav writes everything that was mixed to a wav file
+// -music streams the music from music.pcm (which is mixed in too) or music.mp3 in a directory, like the wii does from the sd card
+// -bots has the computer play the last n players (in place of their random input), and prints what the bots cost per step
+
+// rate the sound effects are mixed at
+#define AUDIO_RATE 44100
+
+// writes 16-bit stereo samples to a wav file (the header's fields are little endian, like the pc), and returns false if it couldn't be written
+static bool WriteWav(const char* path, const std::vector<s16>* samples) {
+	FILE* file = fopen(path, "wb");
+	if (!file) return false;
+	u32 dataSize = samples->size() * sizeof(s16);
+	u32 riffSize = 36 + dataSize;
+	u32 formatSize = 16;
+	u16 format = 1; // pcm
+	u16 channels = 2;
+	u32 rate = AUDIO_RATE;
+	u32 byteRate = AUDIO_RATE * 4;
+	u16 blockAlign = 4;
+	u16 bits = 16;
+	bool written = fwrite("RIFF", 4, 1, file) && fwrite(&riffSize, 4, 1, file) && fwrite("WAVEfmt ", 8, 1, file) && fwrite(&formatSize, 4, 1, file);
+	written = written && fwrite(&format, 2, 1, file) && fwrite(&channels, 2, 1, file) && fwrite(&rate, 4, 1, file) && fwrite(&byteRate, 4, 1, file);
+	written = written && fwrite(&blockAlign, 2, 1, file) && fwrite(&bits, 2, 1, file) && fwrite("data", 4, 1, file) && fwrite(&dataSize, 4, 1, file);
+	if (dataSize) written = written && fwrite(&(*samples)[0], dataSize, 1, file);
+	return fclose(file) == 0 && written;
+}
+
+// random but tank-like input: each player holds a direction for a while, then picks another, and fires every so often
+static void RandomInput(InputState* input, int players, std::mt19937* rng) {
+	static const u32 directions[] = {0, BUTTON_2, BUTTON_LEFT, BUTTON_UP, BUTTON_DOWN, BUTTON_2 | BUTTON_UP, BUTTON_2 | BUTTON_DOWN, BUTTON_LEFT | BUTTON_UP};
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		PlayerInput* playerInput = &input->players[player];
+		u32 previous = playerInput->held;
+		if (player >= players) {
+			playerInput->held = 0;
+		}
+		else {
+			if ((*rng)() % 20 == 0) playerInput->held = directions[(*rng)() % 8];
+			playerInput->held = (playerInput->held & ~BUTTON_1) | ((*rng)() % 15 == 0 ? BUTTON_1 : 0);
+		}
+		playerInput->down = playerInput->held & ~previous;
+		playerInput->pointerX = -100; // pointing off screen
+		playerInput->pointerY = -100;
+		playerInput->pointerAngle = 0;
+	}
+}
+
+int main(int argc, char** argv) {
+	int frames = 60 * 60;
+	bool frameLimit = false;
+	int players = 4;
+	u32 seed = 1;
+	f64 hz = 0;
+	int ammo = 6;
+	const char* replayPath = NULL;
+	const char* recordDirectory = NULL;
+	bool realtime = false;
+	const char* profilePath = NULL;
+	const char* wavPath = NULL;
+	const char* musicDirectory = NULL;
+	int botCount = 0;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "-frames")) {
+			frames = atoi(argv[i + 1]);
+			frameLimit = true;
+		}
+		else if (!strcmp(argv[i], "-players")) players = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-seed")) seed = strtoul(argv[i + 1], NULL, 0);
+		else if (!strcmp(argv[i], "-hz")) hz = atof(argv[i + 1]);
+		else if (!strcmp(argv[i], "-ammo")) ammo = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-replay")) replayPath = argv[i + 1];
+		else if (!strcmp(argv[i], "-record")) recordDirectory = argv[i + 1];
+		else if (!strcmp(argv[i], "-realtime")) realtime = atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-profile")) profilePath = argv[i + 1];
+		else if (!strcmp(argv[i], "-wav")) wavPath = argv[i + 1];
+		else if (!strcmp(argv[i], "-music")) musicDirectory = argv[i + 1];
+		else if (!strcmp(argv[i], "-bots")) botCount = atoi(argv[i + 1]);
+		else {
+			fprintf(stderr, "usage: %s [-frames n] [-players 2-4] [-seed n] [-hz display rate] [-ammo shots per tank] [-replay file] [-record directory] [-realtime 0/1] [-profile trace file] [-wav file] [-music directory] [-bots n]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (players < 2 || players > MAX_PLAYERS) {
+		fprintf(stderr, "players must be 2-%d\n", MAX_PLAYERS);
+		return 1;
+	}
+	if (botCount < 0 || botCount > players) {
+		fprintf(stderr, "bots must be 0-%d\n", players);
+		return 1;
+	}
+
+	// replays bring their own ammo (the game has to be made with it) and go until they end
+	Replay replay;
+	if (replayPath) {
+		if (!LoadReplay(&replay, replayPath)) {
+			fprintf(stderr, "couldn't load replay %s\n", replayPath);
+			return 1;
+		}
+		ammo = replay.ammo;
+		if (!frameLimit) frames = INT_MAX;
+	}
+	if (realtime && !hz) hz = 60;
+
+	GameWindow* gwd = new GameWindow();
+	InitPlatform(gwd);
+	Game* game = new Game(gwd->GetWidth(), gwd->GetHeight(), seed, ammo);
+	if (recordDirectory) game->RecordReplays(recordDirectory);
+	if (musicDirectory) game->StreamMusicFrom(musicDirectory);
+	if (replayPath) game->PlayReplay(&replay);
+	else game->StartGame(players);
+	game->SetBots(((1 << players) - 1) & ~((1 << (players - botCount)) - 1));
+
+	Profiler* profiler = profilePath ? new Profiler() : NULL;
+	ProfileOverlay* profileOverlay = profilePath ? new ProfileOverlay() : NULL;
+	RenderQueue overlayQueue;
+	ProfileFrame profileFrame;
+	f64 phaseSeconds[PROFILE_PHASE_COUNT] = {};
+	u64 counterTotals[PROFILE_COUNTER_COUNT] = {};
+	game->SetProfiler(profiler);
+
+	std::vector<s16> audio; // this frame's mix (or every frame's, with -wav)
+	f64 audioFrames = 0; // audio frames due but not mixed yet
+	u64 mixTicks = 0;
+
+	std::mt19937 rng(seed);
+	InputState input;
+	memset(&input, 0, sizeof(InputState));
+	u64 start = GetClockTicks();
+	std::chrono::steady_clock::time_point nextFrame = std::chrono::steady_clock::now();
+	int frame;
+	for (frame = 0; frame < frames; frame++) {
+		if (profiler) profiler->BeginFrame();
+		{
+			ProfileScope scope(profiler, PROFILE_INPUT);
+			if (!replayPath) RandomInput(&input, players, &rng);
+		}
+		bool running = hz ? game->Frame(&input, 1 / hz) : game->Update(&input);
+		if (!hz) game->PlaySounds();
+		{
+			audioFrames += AUDIO_RATE / (hz ? hz : 60);
+			int mixFrames = (int) audioFrames;
+			audioFrames -= mixFrames;
+			int offset = wavPath ? audio.size() : 0;
+			audio.resize(offset + mixFrames * 2);
+			u64 mixStart = GetClockTicks();
+			if (mixFrames) MixHostAudio(&audio[offset], mixFrames);
+			mixTicks += GetClockTicks() - mixStart;
+		}
+		{
+			ProfileScope scope(profiler, PROFILE_RENDER);
+			GetHostRenderLog()->clear(); // so it only has the last frame's commands at the end
+			game->Draw(hz ? game->GetInterpolation() : 1);
+			if (profileOverlay) {
+				profileOverlay->Draw(profiler, &overlayQueue, 16, 16);
+				overlayQueue.Flush();
+			}
+		}
+		{
+			ProfileScope scope(profiler, PROFILE_FLUSH);
+			gwd->Flush();
+		}
+		if (profiler) {
+			profiler->EndFrame();
+			profiler->CopyFrames(&profileFrame, 1);
+			for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++) phaseSeconds[phase] += ClockTicksToSeconds(profileFrame.phaseTicks[phase]);
+			for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) counterTotals[counter] += profileFrame.counters[counter];
+		}
+		if (!running) break; // only happens at the end of a replay
+		if (realtime) {
+			nextFrame += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<f64>(1 / hz));
+			std::this_thread::sleep_until(nextFrame);
+		}
+	}
+	frames = frame;
+	f64 seconds = ClockTicksToSeconds(GetClockTicks() - start);
+
+	printf("frames %d\n", frames);
+	printf("steps %u\n", hz ? game->GetClock()->steps : frames);
+	printf("skipped_steps %u\n", game->GetClock()->skippedSteps);
+	printf("rounds %d\n", game->GetRoundCount());
+	printf("seconds %.3f\n", seconds);
+	printf("frames_per_second %.0f\n", frames / seconds);
+	printf("microseconds_per_frame %.2f\n", seconds * 1e6 / frames);
+	printf("layers_drawn %llu\n", (unsigned long long) GetHostDrawCounts()->layers);
+	const HostRenderCounts* renderCounts = GetHostRenderCounts();
+	printf("render_draw_calls_per_frame %.2f\n", (f64) (renderCounts->drawCalls + renderCounts->displayListCalls) / frames);
+	printf("render_texture_changes_per_frame %.2f\n", (f64) renderCounts->textureChanges / frames);
+	printf("render_quads_per_frame %.2f\n", (f64) renderCounts->quads / frames);
+	printf("render_display_lists_compiled %llu\n", (unsigned long long) renderCounts->displayListsCompiled);
+	// the last frame's command stream, e.g. "T1 D1 T0 L20 D3" (T: texture set, 0 for none; D: draw with that many quads; L: display list with that many)
+	printf("render_last_frame");
+	const std::vector<HostRenderCommand>* renderLog = GetHostRenderLog();
+	for (int i = 0; i < (int) renderLog->size(); i++) {
+		const HostRenderCommand* command = &(*renderLog)[i];
+		if (command->type == HOST_RENDER_SET_TEXTURE) printf(" T%d", command->image ? 1 : 0);
+		if (command->type == HOST_RENDER_DRAW_QUADS) printf(" D%d", command->quadCount);
+		if (command->type == HOST_RENDER_CALL_DISPLAY_LIST) printf(" L%d", command->quadCount);
+	}
+	printf("\n");
+	printf("sound_effects %llu\n", (unsigned long long) GetHostAudioCounts()->soundEffects);
+	const SoundStats* soundStats = game->GetSounds()->GetStats();
+	printf("sounds_posted_coalesced %u/%u\n", soundStats->posted, soundStats->coalesced);
+	printf("sounds_played_stolen_dropped %u/%u/%u\n", soundStats->played, soundStats->stolen, soundStats->dropped);
+	const MusicStream* musicStream = game->GetMusicStream();
+	printf("music_starts %llu\n", (unsigned long long) GetHostAudioCounts()->musicStarts);
+	printf("music_stream_bytes %llu\n", (unsigned long long) GetHostAudioCounts()->musicStreamBytes);
+	printf("music_stream_chunks_read_underruns %d/%d\n", musicStream->GetChunksRead(), musicStream->GetUnderruns());
+	printf("audio_mix_microseconds_per_frame %.2f\n", ClockTicksToSeconds(mixTicks) * 1e6 / frames);
+	if (wavPath) {
+		int audioPeak = 0;
+		for (int i = 0; i < (int) audio.size(); i++) audioPeak = std::max(audioPeak, abs(audio[i]));
+		printf("audio_peak %d\n", audioPeak);
+		if (!WriteWav(wavPath, &audio)) fprintf(stderr, "couldn't write wav %s\n", wavPath);
+	}
+	const EntityPools* pools = game->GetPools();
+	printf("tank_pool_high_water %d/%d\n", pools->tanks.GetHighWater(), pools->tanks.GetCapacity());
+	printf("bullet_high_water %d/%d\n", game->GetBullets()->GetHighWater(), game->GetBullets()->GetCapacity());
+	printf("explosion_pool_high_water %d/%d\n", pools->explosions.GetHighWater(), pools->explosions.GetCapacity());
+	const MapBuilder* mapBuilder = game->GetMapBuilder();
+	printf("maps_ready_waited_synchronous %d/%d/%d\n", mapBuilder->GetReadyCount(), mapBuilder->GetWaitCount(), mapBuilder->GetSynchronousCount());
+	if (game->GetMap()) printf("walls_merged_unmerged %d/%d\n", game->GetWallManager()->GetSize(), game->GetMap()->GetUnmergedWallCount());
+	printf("texture_decodes %d/%d\n", game->GetTextures()->GetDecodes(), TEXTURE_COUNT);
+	const BotPlayers* bots = game->GetBots();
+	if (bots->GetPlayers()) {
+		printf("bots %d\n", botCount);
+		printf("bot_microseconds_per_step %.2f/%.2f\n", bots->GetUpdates() ? ClockTicksToSeconds(bots->GetTicks()) * 1e6 / bots->GetUpdates() : 0, ClockTicksToSeconds(bots->GetMaxTicks()) * 1e6);
+		printf("bot_rays_per_step %.2f\n", bots->GetUpdates() ? (f64) bots->GetRays() / bots->GetUpdates() : 0);
+	}
+	printf("state_hash %08x\n", (unsigned int) game->GetStateHash());
+	if (replayPath) {
+		printf("replay_steps %u/%u\n", replay.step, replay.stepCount);
+		printf("replay_divergence %d\n", game->GetReplayDivergence());
+	}
+	printf("pool_failed_acquires %d\n", pools->tanks.GetFailedAcquires() + game->GetBullets()->GetFailedSpawns() + pools->explosions.GetFailedAcquires());
+
+	if (profiler) {
+		for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++) {
+			printf("profile_%s_microseconds_per_frame %.2f\n", GetProfilePhaseName((ProfilePhase) phase), phaseSeconds[phase] * 1e6 / frames);
+		}
+#ifdef PROFILE
+		for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) {
+			printf("profile_%s_per_frame %.2f\n", GetProfileCounterName((ProfileCounter) counter), (f64) counterTotals[counter] / frames);
+		}
+#endif
+		if (!WriteProfileTrace(profiler, profilePath)) fprintf(stderr, "couldn't write profile trace %s\n", profilePath);
+		delete profileOverlay;
+		delete profiler;
+	}
+
+	int divergence = game->GetReplayDivergence();
+	delete game;
+	ShutdownPlatform(gwd);
+	delete gwd;
+	return divergence < 0 ? 0 : 2;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "mixer.h"
+#include <string.h>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// adds count samples, scaled by volume, onto a mix
+void MixSamplesScalar(s32* mix, const s16* samples, int count, s32 volume) {
+	for (int i = 0; i < count; i++) mix[i] += (samples[i] * volume) >> 8;
+}
+#ifdef __SSE2__
+// 8 samples at a time: the 16x16 bit products are put back together from their low and high halves, then shifted down like the scalar loop
+void MixSamples(s32* mix, const s16* samples, int count, s32 volume) {
+	__m128i volumes = _mm_set1_epi16((s16) volume);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i sample = _mm_loadu_si128((const __m128i*) (samples + i));
+		__m128i low = _mm_mullo_epi16(sample, volumes);
+		__m128i high = _mm_mulhi_epi16(sample, volumes);
+		__m128i first = _mm_srai_epi32(_mm_unpacklo_epi16(low, high), 8);
+		__m128i second = _mm_srai_epi32(_mm_unpackhi_epi16(low, high), 8);
+		_mm_storeu_si128((__m128i*) (mix + i), _mm_add_epi32(_mm_loadu_si128((const __m128i*) (mix + i)), first));
+		_mm_storeu_si128((__m128i*) (mix + i + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i*) (mix + i + 4)), second));
+	}
+	MixSamplesScalar(mix + i, samples + i, count - i, volume);
+}
+#else
+void MixSamples(s32* mix, const s16* samples, int count, s32 volume) { MixSamplesScalar(mix, samples, count, volume); }
+#endif
+
+// clamps count samples of a mix into 16-bit output
+void ClampMixScalar(s16* output, const s32* mix, int count) {
+	for (int i = 0; i < count; i++) output[i] = mix[i] < -32768 ? -32768 : mix[i] > 32767 ? 32767 : mix[i];
+}
+#ifdef __SSE2__
+// packing with signed saturation is exactly the clamp
+void ClampMix(s16* output, const s32* mix, int count) {
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i first = _mm_loadu_si128((const __m128i*) (mix + i));
+		__m128i second = _mm_loadu_si128((const __m128i*) (mix + i + 4));
+		_mm_storeu_si128((__m128i*) (output + i), _mm_packs_epi32(first, second));
+	}
+	ClampMixScalar(output + i, mix + i, count - i);
+}
+#else
+void ClampMix(s16* output, const s32* mix, int count) { ClampMixScalar(output, mix, count); }
+#endif
+
+// expands up to frames of a voice's sound into 44.1khz stereo output (linearly interpolating between its samples) and moves it along, returning how many frames there were
+// (mono sounds go to both channels; the last frame is held rather than interpolated towards whatever's after the sound)
+int ExpandVoice(MixerVoice* voice, s16* output, int frames) {
+	int channels = voice->channels;
+	int count = 0;
+	// up to the last frame, there's always a next one to interpolate towards, so the common cases get loops without any checks
+	u64 last = voice->length ? (u64) (voice->length - 1) << 16 : 0;
+	int safe = voice->position < last ? (int) std::min<u64>((last - voice->position + voice->step - 1) / voice->step, frames) : 0;
+	u64 position = voice->position;
+	if (channels == 1) {
+		for (; count < safe; count++, position += voice->step) {
+			const s16* current = voice->samples + (position >> 16);
+			s16 sample = current[0] + (((current[1] - current[0]) * (s32) ((position & 0xffff) >> 1)) >> 15);
+			output[count * 2] = sample;
+			output[count * 2 + 1] = sample;
+		}
+	}
+	else {
+		for (; count < safe; count++, position += voice->step) {
+			const s16* current = voice->samples + (position >> 16) * 2;
+			s32 fraction = (position & 0xffff) >> 1;
+			output[count * 2] = current[0] + (((current[2] - current[0]) * fraction) >> 15);
+			output[count * 2 + 1] = current[1] + (((current[3] - current[1]) * fraction) >> 15);
+		}
+	}
+	voice->position = position;
+	for (; count < frames; count++) {
+		u32 frame = voice->position >> 16;
+		if (frame >= voice->length) break;
+		// 15 bits of the fraction, so the difference (up to 17 bits) times it still fits in 32
+		s32 fraction = (voice->position & 0xffff) >> 1;
+		const s16* current = voice->samples + frame * channels;
+		const s16* next = frame + 1 < voice->length ? current + channels : current;
+		for (int channel = 0; channel < 2; channel++) {
+			int source = channel < channels ? channel : 0;
+			output[count * 2 + channel] = current[source] + (((next[source] - current[source]) * fraction) >> 15);
+		}
+		voice->position += voice->step;
+	}
+	return count;
+}
+
+// mixes the next frames of every voice into output, freeing the voices that reach the end of their sound
+void MixVoices(MixerVoice* voices, int voiceCount, s16* output, int frames, s32* mix) {
+	int count = frames * 2;
+	memset(mix, 0, count * sizeof(s32));
+	for (int i = 0; i < voiceCount; i++) {
+		MixerVoice* voice = &voices[i];
+		if (!voice->samples) continue;
+		u32 frame = voice->position >> 16;
+		if (voice->channels == 2 && voice->step == MIXER_STEP(MIXER_RATE)) {
+			// already 44.1khz stereo, so it's mixed straight from the sound
+			int remaining = voice->length - frame < (u32) frames ? voice->length - frame : frames;
+			MixSamples(mix, voice->samples + frame * 2, remaining * 2, voice->volume);
+			voice->position += (u64) remaining << 16;
+		}
+		else {
+			// output isn't written until the clamp at the end, so it's the scratch space for the expanded sound
+			int expanded = ExpandVoice(voice, output, frames);
+			MixSamples(mix, output, expanded * 2, voice->volume);
+		}
+		if (voice->position >> 16 >= voice->length) voice->samples = NULL;
+	}
+	ClampMix(output, mix, count);
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef TANK_HOST_MIXER_H
+#define TANK_HOST_MIXER_H
+
+#include <gccore.h>
+
+// host only: a software mixer for 16-bit pcm (what asndlib does on the wii's dsp), so the host build plays the game's sounds into a buffer instead of just counting them
+// the mix is 44.1khz stereo; voices at that rate are added straight onto a 32-bit mix, and anything else (mono, or another rate) is expanded to it first
+// with linear interpolation, then the mix is clamped back down to 16 bits at the end; the two inner loops have sse2 kernels, with plain loops for anywhere else
+// (both are exported so mixbench can time them and check that they give exactly the same samples)
+
+// samples per second of the mix
+#define MIXER_RATE 44100
+
+// volumes are 8.8 fixed point, so this is full volume (what the wii plays sound effects at)
+#define MIXER_FULL_VOLUME 256
+
+// how far (in 16.16 fixed point frames) a sound at the given rate moves on for each frame of the mix
+#define MIXER_STEP(rate) ((u32) (((u64) (rate) << 16) / MIXER_RATE))
+
+// one voice: the sound it's playing, and how far through it it is
+struct MixerVoice {
+	const s16* samples; // NULL if the voice is free
+	u32 length; // in frames (a sample for each channel)
+	u64 position; // frames played, in 16.16 fixed point
+	u32 step; // MIXER_STEP of the sound's rate
+	int channels; // 1 or 2
+	s32 volume; // 0 to MIXER_FULL_VOLUME
+};
+
+// adds count samples, scaled by volume, onto a mix
+void MixSamples(s32* mix, const s16* samples, int count, s32 volume);
+void MixSamplesScalar(s32* mix, const s16* samples, int count, s32 volume);
+
+// clamps count samples of a mix into 16-bit output
+void ClampMix(s16* output, const s32* mix, int count);
+void ClampMixScalar(s16* output, const s32* mix, int count);
+
+// expands up to frames of a voice's sound into 44.1khz stereo output (linearly interpolating between its samples) and moves it along, returning how many frames there were
+int ExpandVoice(MixerVoice* voice, s16* output, int frames);
+
+// mixes the next frames (stereo pairs of samples) of every voice into output, freeing the voices that reach the end of their sound
+// (mix is scratch space for frames * 2 samples)
+void MixVoices(MixerVoice* voices, int voiceCount, s16* output, int frames, s32* mix);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "platform_host.h"
+#include "mixer.h"
+#include "musicstream.h"
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <system_error>
+using namespace wsp;
+
+// headless backend: there are no wiimotes, speakers, or sd card, so input comes from whoever's driving the game (ReadInput just says nothing's pressed)
+// and sounds are played into a software mixer (see MixHostAudio) rather than out of speakers; each thread keeps its own state so several games can run side by side
+
+static thread_local HostAudioCounts audioCounts;
+static thread_local bool musicPlaying;
+static thread_local MixerVoice voices[SOUND_VOICES + 1]; // the sound effects' voices, then the music's
+static thread_local std::vector<s32> mix;
+static thread_local MusicStream* musicStream; // stream being played (NULL if it's the built in track, or nothing)
+static thread_local const u8* musicChunk; // chunk being played, and how far through it the music is
+static thread_local u32 musicChunkSize;
+static thread_local u32 musicChunkOffset;
+static thread_local std::vector<s16> musicSamples; // the part of a pcm stream being mixed
+static thread_local f64 musicBytesDue; // how far behind an mp3 stream is
+
+HostAudioCounts* GetHostAudioCounts() { return &audioCounts; }
+
+// video, audio, storage, and wiimote initialization
+void InitPlatform(GameWindow* gwd) {
+	gwd->InitVideo();
+}
+
+// shuts everything down before exiting
+void ShutdownPlatform(GameWindow* gwd) {
+	gwd->StopVideo();
+}
+
+// reads every player's input for this frame
+void ReadInput(InputState* input) {
+	memset(input, 0, sizeof(InputState));
+}
+u32 GetConnectedPlayers() { return 0; }
+
+// plays a sound effect on a voice, cutting off whatever it was playing (it's expanded to the mix's rate as it's mixed, like the dsp does)
+void PlayVoice(int voice, const SoundSamples* sound) {
+	u32 length = sound->channels ? sound->size / (2 * sound->channels) : 0;
+	voices[voice].samples = length ? (const s16*) sound->data : NULL; // the data's little endian, like the pc (and 32 byte aligned, see assetarchive.h)
+	voices[voice].length = length;
+	voices[voice].position = 0;
+	voices[voice].step = MIXER_STEP(sound->rate);
+	voices[voice].channels = sound->channels;
+	voices[voice].volume = MIXER_FULL_VOLUME;
+	audioCounts.soundEffects++;
+}
+
+// returns true if a voice is still playing its sound effect (they only move along as they're mixed)
+bool IsVoicePlaying(int voice) { return voices[voice].samples; }
+
+// copies up to size bytes of the music stream out (as many as have been read), and returns how many
+static u32 ReadMusic(u8* output, u32 size) {
+	u32 copied = 0;
+	while (copied < size) {
+		if (musicChunkOffset == musicChunkSize) {
+			if (musicChunk) musicStream->ReleaseChunk();
+			musicChunkOffset = 0;
+			musicChunkSize = 0;
+			musicChunk = musicStream->TakeChunk(&musicChunkSize);
+			if (!musicChunk) break;
+		}
+		u32 count = std::min(size - copied, musicChunkSize - musicChunkOffset);
+		if (output) memcpy(output + copied, musicChunk + musicChunkOffset, count);
+		musicChunkOffset += count;
+		copied += count;
+	}
+	audioCounts.musicStreamBytes += copied;
+	return copied;
+}
+
+// mixes the next frames (44.1khz stereo pairs of samples) of every sound effect that's playing, and the music if it's a pcm stream, into output
+// (there's no mp3 decoder on the host, so mp3 streams are just read through as fast as a 128kbps track would play)
+void MixHostAudio(s16* output, int frames) {
+	if ((int) mix.size() < frames * 2) mix.resize(frames * 2);
+	voices[SOUND_VOICES].samples = NULL;
+	if (musicStream && musicStream->GetFormat() == MUSIC_FORMAT_PCM) {
+		if ((int) musicSamples.size() < frames * 2) musicSamples.resize(frames * 2);
+		u32 length = ReadMusic((u8*) &musicSamples[0], frames * 4) / 4;
+		voices[SOUND_VOICES] = {&musicSamples[0], length, 0, MIXER_STEP(MIXER_RATE), 2, MIXER_FULL_VOLUME};
+	}
+	if (musicStream && musicStream->GetFormat() == MUSIC_FORMAT_MP3) {
+		musicBytesDue += frames * (128000 / 8.0 / 44100);
+		musicBytesDue -= ReadMusic(NULL, (u32) musicBytesDue);
+	}
+	MixVoices(voices, SOUND_VOICES + 1, output, frames, &mix[0]);
+}
+
+// plays/stops the background music (mp3 in memory, which is never decoded, so it just plays forever; an empty buffer means there's no music to play)
+void PlayMusic(const u8* mp3, u32 size) {
+	StopMusic();
+	if (!size) return;
+	musicPlaying = true;
+	audioCounts.musicStarts++;
+}
+
+// streams are played as they're mixed (see MixHostAudio)
+bool PlayMusicStream(MusicStream* stream) {
+	StopMusic();
+	musicStream = stream;
+	musicBytesDue = 0;
+	audioCounts.musicStarts++;
+	return true;
+}
+
+void StopMusic() {
+	if (musicStream && musicChunk) musicStream->ReleaseChunk();
+	musicStream = NULL;
+	musicChunk = NULL;
+	musicChunkSize = 0;
+	musicChunkOffset = 0;
+	musicPlaying = false;
+}
+
+bool IsMusicPlaying() { return musicStream ? !musicStream->IsFinished() : musicPlaying; }
+
+// keeps streamed music going (the stream's only read as it's mixed, so there's nothing to restart)
+void UpdateMusic() {
+	if (musicStream) musicStream->Pump();
+}
+
+// the clock is steady_clock, in nanoseconds
+u64 GetClockTicks() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+f64 ClockTicksToSeconds(u64 ticks) { return ticks / 1e9; }
+
+// background threads are just std::threads (a pc has cores to spare, so they really do run alongside the game)
+struct BackgroundThread {
+	std::thread thread;
+};
+
+BackgroundThread* StartBackgroundThread(void (*function)(void*), void* argument) {
+	BackgroundThread* thread = new BackgroundThread();
+	try {
+		thread->thread = std::thread(function, argument);
+	}
+	catch (const std::system_error&) {
+		delete thread;
+		return NULL;
+	}
+	return thread;
+}
+
+void JoinBackgroundThread(BackgroundThread* thread) {
+	thread->thread.join();
+	delete thread;
+}
+
+struct BackgroundSignal {
+	std::mutex lock; // guards woken
+	std::condition_variable wake;
+	bool woken;
+};
+
+BackgroundSignal* CreateBackgroundSignal() {
+	BackgroundSignal* signal = new BackgroundSignal();
+	signal->woken = false;
+	return signal;
+}
+
+void FreeBackgroundSignal(BackgroundSignal* signal) { delete signal; }
+
+void WaitForBackgroundSignal(BackgroundSignal* signal) {
+	std::unique_lock<std::mutex> guard(signal->lock);
+	signal->wake.wait(guard, [signal] { return signal->woken; });
+	signal->woken = false;
+}
+
+void WakeBackgroundSignal(BackgroundSignal* signal) {
+	std::lock_guard<std::mutex> guard(signal->lock);
+	signal->woken = true;
+	signal->wake.notify_one();
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef TANK_HOST_PLATFORM_HOST_H
+#define TANK_HOST_PLATFORM_HOST_H
+
+#include <gccore.h>
+
+#include "platform.h"
+
+// host only: totals of the sounds the game has asked for on this thread
+struct HostAudioCounts {
+	u64 soundEffects;
+	u64 musicStarts;
+	u64 musicStreamBytes; // bytes of streamed music played
+};
+HostAudioCounts* GetHostAudioCounts();
+
+// host only: mixes the next frames (44.1khz stereo pairs of samples) of every sound effect playing on this thread into output
+// (voices only play as far as they've been mixed, so if nothing calls this, every voice stays busy with the first sound it was given; music is only mixed when it's a pcm stream)
+void MixHostAudio(s16* output, int frames);
+
+#endif
\ No newline at end of file
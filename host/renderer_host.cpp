@@ -0,0 +1,51 @@
+#include "renderer_host.h"
+#include "tiledimage.h"
+using namespace wsp;
+
+// each thread gets its own log and counts, so several headless games can run side by side
+static thread_local HostRenderCounts renderCounts;
+static thread_local std::vector<HostRenderCommand> renderLog;
+
+HostRenderCounts* GetHostRenderCounts() { return &renderCounts; }
+std::vector<HostRenderCommand>* GetHostRenderLog() { return &renderLog; }
+
+struct RenderDisplayList {
+	int quadCount;
+};
+
+static void LogRenderCommand(HostRenderCommandType type, const Image* image, int quadCount) {
+	HostRenderCommand command = {type, image, quadCount};
+	renderLog.push_back(command);
+}
+
+// nothing's drawn, so a tiled image only needs its size
+void TiledImage::InitTexture(const u8* tiles) {}
+
+void SetRenderTexture(const Image* image) {
+	renderCounts.textureChanges++;
+	LogRenderCommand(HOST_RENDER_SET_TEXTURE, image, 0);
+}
+
+void DrawRenderQuads(const RenderQuad* quads, int count) {
+	renderCounts.drawCalls++;
+	renderCounts.quads += count;
+	LogRenderCommand(HOST_RENDER_DRAW_QUADS, NULL, count);
+}
+
+RenderDisplayList* CompileRenderDisplayList(const RenderQuad* quads, int count, bool textured) {
+	renderCounts.displayListsCompiled++;
+	LogRenderCommand(HOST_RENDER_COMPILE_DISPLAY_LIST, NULL, count);
+	RenderDisplayList* list = new RenderDisplayList();
+	list->quadCount = count;
+	return list;
+}
+
+void CallRenderDisplayList(RenderDisplayList* list) {
+	renderCounts.displayListCalls++;
+	renderCounts.quads += list->quadCount;
+	LogRenderCommand(HOST_RENDER_CALL_DISPLAY_LIST, NULL, list->quadCount);
+}
+
+int GetRenderDisplayListQuadCount(const RenderDisplayList* list) { return list->quadCount; }
+
+void FreeRenderDisplayList(RenderDisplayList* list) { delete list; }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef TANK_HOST_RENDERER_HOST_H
+#define TANK_HOST_RENDERER_HOST_H
+
+#include <gccore.h>
+#include <vector>
+
+#include "renderer.h"
+
+// host only: the render backend doesn't draw anything, it records the commands it's given (on this thread) so the batching can be checked
+
+enum HostRenderCommandType {
+	HOST_RENDER_SET_TEXTURE,
+	HOST_RENDER_DRAW_QUADS,
+	HOST_RENDER_CALL_DISPLAY_LIST,
+	HOST_RENDER_COMPILE_DISPLAY_LIST
+};
+
+struct HostRenderCommand {
+	HostRenderCommandType type;
+	const Image* image; // texture set (NULL for none)
+	int quadCount; // quads drawn/called/compiled
+};
+
+// totals of every command so far
+struct HostRenderCounts {
+	u64 textureChanges;
+	u64 drawCalls; // DrawRenderQuads calls
+	u64 displayListCalls;
+	u64 displayListsCompiled;
+	u64 quads; // drawn, including display lists'
+};
+HostRenderCounts* GetHostRenderCounts();
+
+// the commands since the log was last cleared (the caller clears it, e.g. each frame, so it doesn't grow forever)
+std::vector<HostRenderCommand>* GetHostRenderLog();
+
+#endif
\ No newline at end of file
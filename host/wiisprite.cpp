@@ -0,0 +1,172 @@
+#include <wiisprite.h>
+#include <string.h>
+
+namespace wsp {
+
+// each thread gets its own counts, so several headless games can run side by side
+static thread_local HostDrawCounts drawCounts;
+HostDrawCounts* GetHostDrawCounts() { return &drawCounts; }
+
+Image::Image() {
+	_width = 0;
+	_height = 0;
+	_initialized = false;
+}
+Image::~Image() {}
+IMG_LOAD_ERROR Image::LoadImage(const unsigned char* buffer, IMG_LOAD_TYPE loadType) {
+	if (_initialized) return IMG_LOAD_ERROR_ALREADY_INIT;
+	if (loadType != IMG_LOAD_TYPE_BUFFER || !buffer) return IMG_LOAD_ERROR_NOT_FOUND;
+	static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	if (memcmp(buffer, signature, 8) || memcmp(buffer + 12, "IHDR", 4)) return IMG_LOAD_ERROR_INV_PNG;
+	// the IHDR chunk always comes first, and starts with the big endian width and height
+	_width = (buffer[16] << 24) | (buffer[17] << 16) | (buffer[18] << 8) | buffer[19];
+	_height = (buffer[20] << 24) | (buffer[21] << 16) | (buffer[22] << 8) | buffer[23];
+	// libwiisprite needs dimensions that are multiples of 4 for its tiled textures
+	if (_width % 4 || _height % 4) {
+		_width = 0;
+		_height = 0;
+		return IMG_LOAD_ERROR_WRONG_SIZE;
+	}
+	_initialized = true;
+	return IMG_LOAD_ERROR_NONE;
+}
+u32 Image::GetWidth() const { return _width; }
+u32 Image::GetHeight() const { return _height; }
+bool Image::IsInitialized() const { return _initialized; }
+void Image::BindTexture(bool bilinear) {}
+
+Layer::Layer() {
+	width = 0;
+	height = 0;
+	x = 0;
+	y = 0;
+	visible = true;
+	transparency = 255;
+}
+Layer::~Layer() {}
+u32 Layer::GetWidth() const { return width; }
+u32 Layer::GetHeight() const { return height; }
+f32 Layer::GetX() const { return x; }
+f32 Layer::GetY() const { return y; }
+bool Layer::IsVisible() const { return visible; }
+void Layer::SetVisible(bool visible) { this->visible = visible; }
+u8 Layer::GetTransparency() const { return transparency; }
+void Layer::SetTransparency(u8 alpha) { transparency = alpha; }
+void Layer::SetPosition(f32 x, f32 y) {
+	this->x = x;
+	this->y = y;
+}
+void Layer::Move(f32 deltaX, f32 deltaY) {
+	x += deltaX;
+	y += deltaY;
+}
+void Layer::SetWidth(u32 width) { this->width = width; }
+void Layer::SetHeight(u32 height) { this->height = height; }
+
+Sprite::Sprite() {
+	image = NULL;
+	rotation = 0;
+	stretchWidth = 1;
+	stretchHeight = 1;
+	collision.x = 0;
+	collision.y = 0;
+	collision.width = 0;
+	collision.height = 0;
+	frame = 0;
+	frameCount = 0;
+}
+Sprite::~Sprite() {}
+void Sprite::SetImage(const Image* image, u32 frameWidth, u32 frameHeight) {
+	if (!image || !image->IsInitialized()) return;
+	if (!frameWidth) frameWidth = image->GetWidth();
+	if (!frameHeight) frameHeight = image->GetHeight();
+	// changing images keeps the frame and collision rectangle, like libwiisprite (which only resets them the first time)
+	bool first = this->image == NULL;
+	this->image = image;
+	SetWidth(frameWidth);
+	SetHeight(frameHeight);
+	frameCount = (image->GetWidth() / frameWidth) * (image->GetHeight() / frameHeight);
+	if (first) {
+		frame = 0;
+		DefineCollisionRectangle(0, 0, frameWidth, frameHeight);
+	}
+	if (frame >= frameCount) frame = 0;
+}
+const Image* Sprite::GetImage() const { return image; }
+void Sprite::SetRotation(f32 rotation) { this->rotation = rotation; }
+f32 Sprite::GetRotation() const { return rotation; }
+void Sprite::SetZoom(f32 zoom) {
+	stretchWidth = zoom;
+	stretchHeight = zoom;
+}
+f32 Sprite::GetZoom() const { return stretchWidth; }
+void Sprite::SetStretchWidth(f32 stretchWidth) { this->stretchWidth = stretchWidth; }
+void Sprite::SetStretchHeight(f32 stretchHeight) { this->stretchHeight = stretchHeight; }
+f32 Sprite::GetStretchWidth() const { return stretchWidth; }
+f32 Sprite::GetStretchHeight() const { return stretchHeight; }
+void Sprite::DefineCollisionRectangle(f32 x, f32 y, u32 width, u32 height) {
+	collision.x = x;
+	collision.y = y;
+	collision.width = width;
+	collision.height = height;
+}
+const Rectangle* Sprite::GetCollisionRectangle() const { return &collision; }
+void Sprite::SetFrame(u32 frame) {
+	if (frame < frameCount) this->frame = frame;
+}
+u32 Sprite::GetFrame() const { return frame; }
+u32 Sprite::GetFrameCount() const { return frameCount; }
+void Sprite::Draw(f32 offsetX, f32 offsetY) const { if (image) drawCounts.layers++; }
+
+Quad::Quad() {
+	rotation = 0;
+	fillColor = (GXColor) {0, 0, 0, 255};
+}
+Quad::~Quad() {}
+void Quad::SetWidth(u32 width) { Layer::SetWidth(width); }
+void Quad::SetHeight(u32 height) { Layer::SetHeight(height); }
+void Quad::SetRotation(f32 rotation) { this->rotation = rotation; }
+f32 Quad::GetRotation() const { return rotation; }
+void Quad::SetFillColor(GXColor color) { fillColor = color; }
+GXColor Quad::GetFillColor() const { return fillColor; }
+void Quad::Draw(f32 offsetX, f32 offsetY) const { drawCounts.layers++; }
+
+LayerManager::LayerManager(u32 boundary) {
+	this->boundary = boundary;
+	size = 0;
+	layers = new Layer*[boundary];
+}
+LayerManager::~LayerManager() { delete[] layers; }
+// like libwiisprite, adding a layer that's already there moves it, and adding past the boundary does nothing
+void LayerManager::Append(Layer* layer) { Insert(layer, size); }
+void LayerManager::Insert(Layer* layer, u32 index) {
+	if (!layer) return;
+	Remove(layer);
+	if (size >= boundary || index > size) return;
+	for (u32 i = size; i > index; i--) layers[i] = layers[i - 1];
+	layers[index] = layer;
+	size++;
+}
+void LayerManager::Remove(Layer* layer) {
+	for (u32 i = 0; i < size; i++) {
+		if (layers[i] != layer) continue;
+		for (u32 j = i; j + 1 < size; j++) layers[j] = layers[j + 1];
+		size--;
+		return;
+	}
+}
+void LayerManager::RemoveAll() { size = 0; }
+Layer* LayerManager::GetLayerAt(u32 index) const { return index < size ? layers[index] : NULL; }
+u32 LayerManager::GetSize() const { return size; }
+void LayerManager::Draw(f32 offsetX, f32 offsetY) const {
+	for (u32 i = size; i > 0; i--) if (layers[i - 1]->IsVisible()) layers[i - 1]->Draw(offsetX, offsetY);
+}
+
+void GameWindow::InitVideo() {}
+void GameWindow::StopVideo() {}
+void GameWindow::SetBackground(GXColor color) {}
+u32 GameWindow::GetWidth() { return 640; }
+u32 GameWindow::GetHeight() { return 480; }
+void GameWindow::Flush() { drawCounts.frames++; }
+
+}
\ No newline at end of file
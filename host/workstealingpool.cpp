@@ -0,0 +1,61 @@
+#include "workstealingpool.h"
+
+#include <thread>
+
+// runs task(index, thread) for every index from 0 to count - 1 and returns once they're all done
+void WorkStealingPool::Run(int count, const std::function<void(int, int)>& task) {
+	int threadCount = workers.size();
+	// deal the tasks out in runs of neighbouring ones, so each thread works through its own part of the batch in order unless it has to steal
+	for (int thread = 0; thread < threadCount; thread++) {
+		Worker* worker = workers[thread];
+		worker->tasks.clear();
+		for (int i = (s64) count * thread / threadCount; i < (s64) count * (thread + 1) / threadCount; i++) worker->tasks.push_back(i);
+		worker->tasksRun = 0;
+		worker->steals = 0;
+	}
+	auto work = [this, &task](int thread) {
+		for (int index = TakeTask(thread); index >= 0; index = TakeTask(thread)) {
+			task(index, thread);
+			workers[thread]->tasksRun++;
+		}
+	};
+	// the calling thread is the first of the pool's threads
+	std::vector<std::thread> threads;
+	for (int thread = 1; thread < threadCount; thread++) threads.push_back(std::thread(work, thread));
+	work(0);
+	for (int i = 0; i < (int) threads.size(); i++) threads[i].join();
+}
+
+// takes the next task for a thread, from its own deque or someone else's (returns -1 if there are none left anywhere)
+int WorkStealingPool::TakeTask(int thread) {
+	Worker* worker = workers[thread];
+	{
+		std::lock_guard<std::mutex> guard(worker->lock);
+		if (!worker->tasks.empty()) {
+			int index = worker->tasks.front();
+			worker->tasks.pop_front();
+			return index;
+		}
+	}
+	// out of its own, so try the others in turn (starting with the next thread along, so the thieves don't all go for the same one)
+	for (int i = 1; i < (int) workers.size(); i++) {
+		Worker* victim = workers[(thread + i) % workers.size()];
+		std::lock_guard<std::mutex> guard(victim->lock);
+		if (victim->tasks.empty()) continue;
+		int index = victim->tasks.back(); // the end its owner will get to last
+		victim->tasks.pop_back();
+		worker->steals++;
+		return index;
+	}
+	return -1;
+}
+
+// threadCount threads (0 for one per core)
+WorkStealingPool::WorkStealingPool(int threadCount) {
+	if (threadCount <= 0) threadCount = std::thread::hardware_concurrency();
+	if (threadCount <= 0) threadCount = 1; // (if the number of cores can't be told)
+	for (int thread = 0; thread < threadCount; thread++) workers.push_back(new Worker());
+}
+WorkStealingPool::~WorkStealingPool() {
+	for (int thread = 0; thread < (int) workers.size(); thread++) delete workers[thread];
+}
\ No newline at end of file
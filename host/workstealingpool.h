@@ -0,0 +1,39 @@
+#ifndef TANK_HOST_WORKSTEALINGPOOL_H
+#define TANK_HOST_WORKSTEALINGPOOL_H
+
+#include <gccore.h>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <functional>
+
+// host only: runs a batch of independent tasks (numbered 0 to count - 1) across a number of threads, for the batch match runner
+// each thread starts with an even share of the tasks in a deque of its own, takes them from the front, and once it's out, steals from the back of another thread's,
+// so a thread that got quick tasks helps out one that got slow ones instead of sitting idle; nothing is added once a run's started, so a thread that finds every deque empty is done
+class WorkStealingPool {
+	public:
+		// runs task(index, thread) for every index from 0 to count - 1 and returns once they're all done (thread is which of the pool's threads ran it, 0 to GetThreadCount() - 1)
+		void Run(int count, const std::function<void(int, int)>& task);
+		int GetThreadCount() const { return (int) workers.size(); }
+		// tasks each thread ran, and took from another thread, in the last run
+		int GetTasksRun(int thread) const { return workers[thread]->tasksRun; }
+		int GetSteals(int thread) const { return workers[thread]->steals; }
+		// threadCount threads (0 for one per core)
+		WorkStealingPool(int threadCount);
+		~WorkStealingPool();
+	private:
+		struct Worker {
+			std::mutex lock; // guards tasks
+			std::deque<int> tasks;
+			int tasksRun;
+			int steals;
+		};
+		std::vector<Worker*> workers;
+		// takes the next task for a thread, from its own deque or someone else's (returns -1 if there are none left anywhere)
+		int TakeTask(int thread);
+		// the pool owns its workers, so it can't be copied
+		WorkStealingPool(const WorkStealingPool&);
+		WorkStealingPool& operator=(const WorkStealingPool&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "angle.h"
+
+static constexpr double pi = 3.14159265358979323846;
+
+// sine of x (in radians, between -pi and pi) from its taylor series, which has converged to double precision well before the last term
+static constexpr double TaylorSine(double x) {
+	double term = x;
+	double sum = x;
+	for (int n = 1; n < 30; n++) {
+		term *= -x * x / ((2 * n) * (2 * n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+// arctangent of x (between 0 and 1) from its taylor series; tangents above tan(pi/8) use atan(x) = pi/4 + atan((x - 1) / (x + 1)),
+// which keeps the series argument under .42 so it converges quickly
+static constexpr double TaylorArcTangent(double x) {
+	double offset = 0;
+	if (x > .41421356237309503) {
+		x = (x - 1) / (x + 1);
+		offset = pi / 4;
+	}
+	double power = x;
+	double sum = 0;
+	for (int n = 0; n < 40; n++) {
+		sum += (n % 2 ? -power : power) / (2 * n + 1);
+		power *= x * x;
+	}
+	return offset + sum;
+}
+
+static constexpr AngleTables GenerateAngleTables() {
+	AngleTables tables = {};
+	for (int step = 0; step <= ANGLE_SINE_STEPS; step++) {
+		// steps past halfway are done as negative angles, to keep the series in its accurate range
+		int signedStep = step <= ANGLE_SINE_STEPS / 2 ? step : step - ANGLE_SINE_STEPS;
+		tables.sine[step] = (f32) TaylorSine(2 * pi * signedStep / ANGLE_SINE_STEPS);
+	}
+	for (int step = 0; step <= ANGLE_ARCTANGENT_STEPS; step++) {
+		tables.arctangent[step] = (f32) (TaylorArcTangent((double) step / ANGLE_ARCTANGENT_STEPS) / (2 * pi) * 4294967296.0);
+	}
+	return tables;
+}
+
+// the tables are worked out by the compiler, so there's no trig at runtime at all (not even at startup)
+constexpr AngleTables angleTables = GenerateAngleTables();
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef TANK_ANGLE_H
+#define TANK_ANGLE_H
+
+#include <gccore.h>
+#include <math.h>
+#include <algorithm>
+
+// number of steps the sine table splits a full turn into (a power of 2, so the step an angle is in is just its top bits)
+#define ANGLE_SINE_BITS 10
+#define ANGLE_SINE_STEPS (1 << ANGLE_SINE_BITS)
+// number of steps the arctangent table splits the tangents from 0 to 1 into
+#define ANGLE_ARCTANGENT_STEPS 256
+
+// worst case errors of the lookups below compared to the exact functions (sine/cosine as a value, arctangent in radians);
+// these come from the linear interpolation between table entries (step size squared * max second derivative / 8), plus a bit for float rounding
+#define ANGLE_SINE_MAX_ERROR 5e-6
+#define ANGLE_ARCTANGENT_MAX_ERROR 2e-6
+
+// fixed point angle, stored as a fraction of a full turn out of 2^32 (so a quarter turn is 0x40000000)
+// this means angles wrap around on their own through integer overflow, without fmod
+struct Angle {
+	u32 turns;
+};
+
+// lookup tables for the angle functions (generated at compile time in angle.cpp; each has one extra entry at the end so interpolation never has to wrap)
+struct AngleTables {
+	f32 sine[ANGLE_SINE_STEPS + 1]; // sine of each step of a full turn
+	f32 arctangent[ANGLE_ARCTANGENT_STEPS + 1]; // arctangent of each step of the tangents from 0 to 1, as an angle's turns
+};
+extern const AngleTables angleTables;
+
+inline Angle operator+(Angle angle1, Angle angle2) {
+	Angle sum = {angle1.turns + angle2.turns};
+	return sum;
+}
+inline Angle operator-(Angle angle1, Angle angle2) {
+	Angle difference = {angle1.turns - angle2.turns};
+	return difference;
+}
+
+// converts libwiisprite rotation (in degrees/2, so 180 is a full turn) to an angle (works for anything between -270 and 270)
+inline Angle HalfDegreesToAngle(f32 halfDegrees) {
+	// shift into -90 to 90 first, so the result fits in a signed int (it's the same angle once it wraps around anyway)
+	if (halfDegrees >= 90) halfDegrees -= 180;
+	else if (halfDegrees < -90) halfDegrees += 180;
+	Angle angle = {(u32) (s32) (halfDegrees * (4294967296.0f / 180))};
+	return angle;
+}
+
+// converts an angle to libwiisprite rotation, in 0-180 (0-360 degrees)
+inline f32 AngleToHalfDegrees(Angle angle) {
+	return (f32) angle.turns * (180 / 4294967296.0f);
+}
+
+// returns the sine of an angle, interpolated from the table
+inline f32 AngleSine(Angle angle) {
+	u32 step = angle.turns >> (32 - ANGLE_SINE_BITS);
+	f32 fraction = (f32) (angle.turns & ((1 << (32 - ANGLE_SINE_BITS)) - 1)) * (1.0f / (1 << (32 - ANGLE_SINE_BITS)));
+	f32 low = angleTables.sine[step];
+	return low + (angleTables.sine[step + 1] - low) * fraction;
+}
+
+// returns the cosine of an angle (the sine of the angle a quarter turn later)
+inline f32 AngleCosine(Angle angle) {
+	Angle shifted = {angle.turns + 0x40000000};
+	return AngleSine(shifted);
+}
+
+// returns the angle of the vector (x, y), like atan2(y, x) (the zero vector gives 0)
+// the table covers the first eighth of a turn, and the rest is mirrored from it
+inline Angle ArcTangent(f32 y, f32 x) {
+	f32 absX = fabsf(x);
+	f32 absY = fabsf(y);
+	bool steep = absY > absX;
+	f32 longest = steep ? absY : absX;
+	Angle angle = {0};
+	if (longest == 0) return angle;
+	f32 position = (steep ? absX : absY) / longest * ANGLE_ARCTANGENT_STEPS;
+	int step = std::min((int) position, ANGLE_ARCTANGENT_STEPS - 1);
+	f32 fraction = position - step;
+	f32 low = angleTables.arctangent[step];
+	angle.turns = (u32) (s32) (low + (angleTables.arctangent[step + 1] - low) * fraction);
+	if (steep) angle.turns = 0x40000000 - angle.turns;
+	if (x < 0) angle.turns = 0x80000000 - angle.turns;
+	if (y < 0) angle.turns = -angle.turns;
+	return angle;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "assetarchive.h"
+#include <string.h>
+#include <malloc.h>
+
+// little endian reading/writing, so archives are the same everywhere (see replay.cpp)
+static void WriteU32(u8* bytes, u32 value) {
+	for (int i = 0; i < 4; i++) bytes[i] = (value >> (8 * i)) & 0xff;
+}
+static u32 ReadU32(const u8* bytes) { return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((u32) bytes[3] << 24); }
+
+static u32 AlignAsset(u32 offset) { return (offset + ASSET_ALIGNMENT - 1) & ~(ASSET_ALIGNMENT - 1); }
+
+// reads the header, and returns the number of assets in the table (-1 if it isn't an archive this version can read)
+static int ReadAssetHeader(const u8* header) {
+	if (memcmp(header, ASSET_ARCHIVE_MAGIC, 4) || ReadU32(header + 4) != ASSET_ARCHIVE_VERSION) return -1;
+	return ReadU32(header + 8) <= 0xffff ? (int) ReadU32(header + 8) : -1;
+}
+
+// reads the table, making sure every asset's name is terminated and its bytes are inside the archive
+static bool ReadAssetTable(AssetArchive* archive, const u8* table, int count, u32 size) {
+	archive->assets.resize(count);
+	for (int i = 0; i < count; i++) {
+		const u8* entry = table + i * ASSET_ENTRY_SIZE;
+		AssetInfo* asset = &archive->assets[i];
+		memcpy(asset->name, entry, ASSET_NAME_SIZE);
+		asset->type = ReadU32(entry + ASSET_NAME_SIZE);
+		asset->offset = ReadU32(entry + ASSET_NAME_SIZE + 4);
+		asset->size = ReadU32(entry + ASSET_NAME_SIZE + 8);
+		asset->rate = ReadU32(entry + ASSET_NAME_SIZE + 12);
+		asset->channels = ReadU32(entry + ASSET_NAME_SIZE + 16);
+		if (asset->name[ASSET_NAME_SIZE - 1] || asset->offset > size || asset->size > size - asset->offset) {
+			archive->assets.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+// opens an archive that's already in memory (returns false if it isn't a valid archive)
+bool OpenAssetArchive(AssetArchive* archive, const u8* data, u32 size) {
+	archive->data = NULL;
+	archive->file = NULL;
+	archive->assets.clear();
+	if (size < ASSET_ARCHIVE_HEADER_SIZE) return false;
+	int count = ReadAssetHeader(data);
+	if (count < 0 || (size - ASSET_ARCHIVE_HEADER_SIZE) / ASSET_ENTRY_SIZE < (u32) count) return false;
+	if (!ReadAssetTable(archive, data + ASSET_ARCHIVE_HEADER_SIZE, count, size)) return false;
+	archive->data = data;
+	return true;
+}
+
+// opens an archive file, reading just its table (returns false if it can't be read or isn't a valid archive)
+bool OpenAssetArchiveFile(AssetArchive* archive, const char* path) {
+	archive->data = NULL;
+	archive->file = NULL;
+	archive->assets.clear();
+	FILE* file = fopen(path, "rb");
+	if (!file) return false;
+	u8 header[ASSET_ARCHIVE_HEADER_SIZE];
+	bool valid = fread(header, 1, ASSET_ARCHIVE_HEADER_SIZE, file) == ASSET_ARCHIVE_HEADER_SIZE;
+	int count = valid ? ReadAssetHeader(header) : -1;
+	long size = count >= 0 && !fseek(file, 0, SEEK_END) ? ftell(file) : -1;
+	valid = size >= 0 && (u32) (size - ASSET_ARCHIVE_HEADER_SIZE) / ASSET_ENTRY_SIZE >= (u32) count;
+	if (valid) {
+		std::vector<u8> table(count * ASSET_ENTRY_SIZE);
+		valid = !fseek(file, ASSET_ARCHIVE_HEADER_SIZE, SEEK_SET) && fread(table.data(), 1, table.size(), file) == table.size();
+		valid = valid && ReadAssetTable(archive, table.data(), count, size);
+	}
+	if (!valid) {
+		fclose(file);
+		return false;
+	}
+	archive->file = file;
+	return true;
+}
+
+void CloseAssetArchive(AssetArchive* archive) {
+	if (archive->file) fclose(archive->file);
+	archive->file = NULL;
+	archive->data = NULL;
+	archive->assets.clear();
+}
+
+// returns the asset with the given name (NULL if there isn't one)
+const AssetInfo* FindAsset(const AssetArchive* archive, const char* name) {
+	for (u32 i = 0; i < archive->assets.size(); i++) {
+		if (!strcmp(archive->assets[i].name, name)) return &archive->assets[i];
+	}
+	return NULL;
+}
+
+// returns an asset's bytes: straight out of the archive if it's in memory, otherwise read from the file into a 32 byte aligned buffer
+const u8* LoadAsset(const AssetArchive* archive, const AssetInfo* asset) {
+	if (archive->data) return archive->data + asset->offset;
+	if (!archive->file) return NULL;
+	// padded out to the alignment, so the dsp and gx can read the buffer right up to its end
+	u8* data = (u8*) memalign(ASSET_ALIGNMENT, AlignAsset(asset->size) ? AlignAsset(asset->size) : ASSET_ALIGNMENT);
+	if (!data) return NULL;
+	memset(data + asset->size, 0, AlignAsset(asset->size) - asset->size);
+	if (fseek(archive->file, asset->offset, SEEK_SET) || fread(data, 1, asset->size, archive->file) != asset->size) {
+		free(data);
+		return NULL;
+	}
+	return data;
+}
+
+void FreeAsset(const AssetArchive* archive, const u8* data) {
+	if (!archive->data) free((void*) data);
+}
+
+// lays assets out as an archive: fills in each one's offset and size from its data, then writes the lot into archive
+void PackAssetArchive(std::vector<u8>* archive, std::vector<AssetInfo>* assets, const std::vector<std::vector<u8> >& data) {
+	u32 offset = AlignAsset(ASSET_ARCHIVE_HEADER_SIZE + assets->size() * ASSET_ENTRY_SIZE);
+	for (u32 i = 0; i < assets->size(); i++) {
+		(*assets)[i].offset = offset;
+		(*assets)[i].size = data[i].size();
+		offset = AlignAsset(offset + data[i].size());
+	}
+	// everything between the assets is zeros
+	archive->assign(offset, 0);
+	u8* bytes = archive->data();
+	memcpy(bytes, ASSET_ARCHIVE_MAGIC, 4);
+	WriteU32(bytes + 4, ASSET_ARCHIVE_VERSION);
+	WriteU32(bytes + 8, assets->size());
+	WriteU32(bytes + 12, 0);
+	for (u32 i = 0; i < assets->size(); i++) {
+		const AssetInfo* asset = &(*assets)[i];
+		u8* entry = bytes + ASSET_ARCHIVE_HEADER_SIZE + i * ASSET_ENTRY_SIZE;
+		memcpy(entry, asset->name, strnlen(asset->name, ASSET_NAME_SIZE - 1)); // the rest of the name is the zeros it was filled with
+		WriteU32(entry + ASSET_NAME_SIZE, asset->type);
+		WriteU32(entry + ASSET_NAME_SIZE + 4, asset->offset);
+		WriteU32(entry + ASSET_NAME_SIZE + 8, asset->size);
+		WriteU32(entry + ASSET_NAME_SIZE + 12, asset->rate);
+		WriteU32(entry + ASSET_NAME_SIZE + 16, asset->channels);
+		if (!data[i].empty()) memcpy(bytes + asset->offset, data[i].data(), data[i].size());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef TANK_ASSETARCHIVE_H
+#define TANK_ASSETARCHIVE_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <gccore.h>
+
+#include <vector>
+
+// every asset the game uses (the images, sounds, and music in data) is packed into one archive by tools/assetpack.cpp when the game's built
+// an archive is a header, a table of every asset (its name, type, and where its bytes are), and then each asset's bytes, 32 byte aligned (which is what the dsp and gx need)
+// the game has one built in (see GetBuiltInAssets), but an archive can also be opened from a file, which only reads the table until an asset is loaded
+
+#define ASSET_ARCHIVE_MAGIC "WTRA"
+#define ASSET_ARCHIVE_VERSION 1
+#define ASSET_ARCHIVE_HEADER_SIZE 16
+#define ASSET_NAME_SIZE 32
+#define ASSET_ENTRY_SIZE (ASSET_NAME_SIZE + 20)
+#define ASSET_ALIGNMENT 32
+
+// what an asset's bytes are
+enum AssetType {
+	ASSET_RAW, // a file packed as it was (pngs, mp3s)
+	ASSET_SOUND // 16-bit little endian pcm, at the asset's rate and number of channels (interleaved)
+};
+
+// one asset's entry in the table
+struct AssetInfo {
+	char name[ASSET_NAME_SIZE]; // the name of the file it was packed from, like "tanks.png" (nul terminated)
+	u32 type; // an AssetType
+	u32 offset; // where its bytes start, from the start of the archive (a multiple of ASSET_ALIGNMENT)
+	u32 size; // in bytes
+	u32 rate; // sounds only: samples per second, and channels (1 or 2)
+	u32 channels;
+};
+
+// an open archive: its table, and either the whole thing in memory or the file the assets are read from
+struct AssetArchive {
+	std::vector<AssetInfo> assets;
+	const u8* data; // NULL if the assets are read from the file
+	FILE* file;
+};
+
+// opens an archive that's already in memory (returns false if it isn't a valid archive)
+bool OpenAssetArchive(AssetArchive* archive, const u8* data, u32 size);
+// opens an archive file, reading just its table (returns false if it can't be read or isn't a valid archive)
+bool OpenAssetArchiveFile(AssetArchive* archive, const char* path);
+void CloseAssetArchive(AssetArchive* archive);
+
+// returns the asset with the given name (NULL if there isn't one)
+const AssetInfo* FindAsset(const AssetArchive* archive, const char* name);
+
+// returns an asset's bytes: straight out of the archive if it's in memory, otherwise read from the file into a 32 byte aligned buffer
+// (returns NULL if it can't be read; either way, give it back to FreeAsset when it's done with)
+const u8* LoadAsset(const AssetArchive* archive, const AssetInfo* asset);
+void FreeAsset(const AssetArchive* archive, const u8* data);
+
+// lays assets out as an archive (the packer's half): fills in each one's offset and size from its data, then writes the lot into archive
+void PackAssetArchive(std::vector<u8>* archive, std::vector<AssetInfo>* assets, const std::vector<std::vector<u8> >& data);
+
+// the archive of everything in data, built into the game (see builtinassets.cpp)
+const AssetArchive* GetBuiltInAssets();
+// returns a built in asset's bytes and fills in its info (NULL if there's no asset by that name, like music.mp3 when it's been left out)
+// (the bytes are the archive's own, so they're never freed)
+const u8* GetBuiltInAsset(const char* name, const AssetInfo** info = NULL);
+
+#endif
\ No newline at end of file
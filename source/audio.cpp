@@ -0,0 +1,71 @@
+#include "audio.h"
+#include "assetarchive.h"
+
+using namespace wsp;
+
+// the asset each sound's samples are in (in SoundEffect order)
+static const char* const soundNames[SOUND_EFFECT_COUNT] = {
+	"hit.pcm",
+	"shoot.pcm",
+	"explode.pcm"
+};
+
+// asks for a sound to be played this frame
+void SoundQueue::Post(SoundEffect sound) {
+	stats.posted++;
+	if (pending & 1 << sound) stats.coalesced++;
+	pending |= 1 << sound;
+}
+
+// plays everything posted since the last call (most important first), and returns how many sounds were started
+int SoundQueue::Play() {
+	int started = 0;
+	for (int sound = SOUND_EFFECT_COUNT - 1; sound >= 0; sound--) {
+		if (!(pending & 1 << sound)) continue;
+		int voice = FindVoice((SoundEffect) sound);
+		if (voice < 0) {
+			stats.dropped++;
+			continue;
+		}
+		if (IsVoicePlaying(voice)) stats.stolen++;
+		PlayVoice(voice, &samples[sound]);
+		voiceSounds[voice] = (SoundEffect) sound;
+		voiceFrames[voice] = frame;
+		stats.played++;
+		started++;
+	}
+	pending = 0;
+	frame++;
+	return started;
+}
+
+// returns a voice to play a sound on (a free one, or else the one playing the least important, oldest sound, as long as that isn't more important), or -1 if there isn't one
+int SoundQueue::FindVoice(SoundEffect sound) {
+	int steal = -1;
+	for (int voice = 0; voice < SOUND_VOICES; voice++) {
+		if (!IsVoicePlaying(voice)) return voice;
+		// sounds started this frame are never cut off (they'd never be heard)
+		if (voiceSounds[voice] > sound || voiceFrames[voice] == frame) continue;
+		if (steal < 0 || voiceSounds[voice] < voiceSounds[steal] || (voiceSounds[voice] == voiceSounds[steal] && frame - voiceFrames[voice] > frame - voiceFrames[steal])) steal = voice;
+	}
+	return steal;
+}
+
+SoundQueue::SoundQueue() {
+	pending = 0;
+	frame = 0;
+	for (int voice = 0; voice < SOUND_VOICES; voice++) {
+		voiceSounds[voice] = SOUND_HIT;
+		voiceFrames[voice] = 0;
+	}
+	stats = SoundStats();
+	// the packer turns every sound into pcm (see tools/assetpack.cpp), so there's nothing to decode; one that's missing just has no samples
+	for (int sound = 0; sound < SOUND_EFFECT_COUNT; sound++) {
+		const AssetInfo* asset;
+		samples[sound].data = GetBuiltInAsset(soundNames[sound], &asset);
+		bool valid = samples[sound].data && asset->type == ASSET_SOUND;
+		samples[sound].size = valid ? asset->size : 0;
+		samples[sound].rate = valid ? asset->rate : 0;
+		samples[sound].channels = valid ? asset->channels : 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef TANK_AUDIO_H
+#define TANK_AUDIO_H
+
+#include <stdlib.h>
+#include <gccore.h>
+
+#include "platform.h"
+
+using namespace wsp;
+
+// sound effects, from least to most important (when every voice is busy, a sound can cut off one that's less important, or an older copy of itself)
+enum SoundEffect {
+	SOUND_HIT,
+	SOUND_SHOOT,
+	SOUND_EXPLOSION,
+	SOUND_EFFECT_COUNT
+};
+
+// totals of what's happened to the sounds posted to a queue
+struct SoundStats {
+	u32 posted;
+	u32 coalesced; // posts of a sound that had already been posted that frame (so they didn't get voices of their own)
+	u32 played;
+	u32 stolen; // sounds that cut off another to get a voice
+	u32 dropped; // sounds that didn't play because every voice was busy with something more important
+};
+
+// the simulation posts sound effects here instead of playing them, and everything posted is played at once each frame, so
+// the same sound posted several times in a frame (like five bullets hitting walls at once) only plays once, and when
+// there aren't enough voices to go around, explosions win over shots and shots win over hits
+class SoundQueue {
+	public:
+		// asks for a sound to be played this frame
+		void Post(SoundEffect sound);
+		// plays everything posted since the last call (most important first), and returns how many sounds were started
+		int Play();
+		const SoundStats* GetStats() const { return &stats; }
+		SoundQueue();
+	private:
+		u32 pending; // a bit for each sound that's been posted this frame
+		u32 frame; // calls to Play so far, for telling which voice's sound is oldest
+		SoundEffect voiceSounds[SOUND_VOICES]; // the sound each voice was last given
+		u32 voiceFrames[SOUND_VOICES]; // and the frame it was given it
+		SoundStats stats;
+		SoundSamples samples[SOUND_EFFECT_COUNT]; // each sound's samples, out of the assets built in
+		// returns a voice to play a sound on (a free one, or else the one playing the least important, oldest sound, as long as that isn't more important), or -1 if there isn't one
+		int FindVoice(SoundEffect sound);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "bots.h"
+
+// distance from a tank's center to where its bullets start, and their radius (see Tank::Shoot)
+#define BOT_MUZZLE_DISTANCE 14
+#define BOT_BULLET_RADIUS 2
+// how far off a heading a bot still turns to fix (a bit over a step's turn, so it doesn't wobble either side), and still drives forwards at
+#define BOT_TURN_TOLERANCE 0x02000000 // about 3 degrees
+#define BOT_DRIVE_TOLERANCE 0x20000000 // 45 degrees
+
+// casts a ray through a map's maze, reflecting it off the walls between cells, and finds the first target it passes close to
+// (cells are walked one at a time: the ray goes to whichever cell edge it reaches first, then either into the next cell or, if there's a wall there, back the other way;
+// a wall reflects it where a bullet would touch it, which is the wall's center line less half its thickness and a bullet's radius)
+BotRayHit CastBotRay(Map* map, Vec2 start, Vec2 direction, const Vec2* targets, int targetCount, int ignore) {
+	const Maze* maze = map->GetMaze();
+	f32 cellWidth = map->GetCellWidth();
+	f32 cellHeight = map->GetCellHeight();
+	f32 offset = map->GetWallThickness() / 2.0f; // where the walls' center lines start
+	f32 margin = offset + BOT_BULLET_RADIUS; // how far short of the center line a bullet bounces
+	BotRayHit hit = {-1, 0, 0};
+	Vec2 position = start;
+	int cellX = std::min(std::max((int) floorf((position.x - offset) / cellWidth), 0), maze->width - 1);
+	int cellY = std::min(std::max((int) floorf((position.y - offset) / cellHeight), 0), maze->height - 1);
+	for (; hit.cells < BOT_RAY_CELLS; hit.cells++) {
+		// distance to the cell's edges the ray is heading for (or to where it bounces, if there's a wall)
+		bool openX = MazeOpen(maze, cellX, cellY, direction.x > 0 ? MAZE_EAST : MAZE_WEST);
+		bool openY = MazeOpen(maze, cellX, cellY, direction.y > 0 ? MAZE_SOUTH : MAZE_NORTH);
+		f32 edgeX = direction.x > 0 ? (cellX + 1) * cellWidth + offset - (openX ? 0 : margin) : cellX * cellWidth + offset + (openX ? 0 : margin);
+		f32 edgeY = direction.y > 0 ? (cellY + 1) * cellHeight + offset - (openY ? 0 : margin) : cellY * cellHeight + offset + (openY ? 0 : margin);
+		f32 toX = direction.x ? (edgeX - position.x) / direction.x : INFINITY;
+		f32 toY = direction.y ? (edgeY - position.y) / direction.y : INFINITY;
+		f32 length = std::max(std::min(toX, toY), 0.0f);
+		// the nearest point on this part of the ray to each target
+		f32 nearest = INFINITY;
+		for (int i = 0; i < targetCount; i++) {
+			if (i == ignore && !hit.bounces) continue;
+			Vec2 offsetToTarget = {targets[i].x - position.x, targets[i].y - position.y};
+			f32 along = std::min(std::max(DotProduct(offsetToTarget, direction), 0.0f), length);
+			f32 acrossX = offsetToTarget.x - direction.x * along;
+			f32 acrossY = offsetToTarget.y - direction.y * along;
+			if (acrossX * acrossX + acrossY * acrossY <= BOT_HIT_RADIUS * BOT_HIT_RADIUS && along < nearest) {
+				nearest = along;
+				hit.target = i;
+			}
+		}
+		if (hit.target >= 0) return hit;
+		position.x += direction.x * length;
+		position.y += direction.y * length;
+		// into the next cell, or off the wall
+		if (toX <= toY) {
+			if (openX) cellX += direction.x > 0 ? 1 : -1;
+			else {
+				direction.x = -direction.x;
+				hit.bounces++;
+			}
+		}
+		else {
+			if (openY) cellY += direction.y > 0 ? 1 : -1;
+			else {
+				direction.y = -direction.y;
+				hit.bounces++;
+			}
+		}
+		if (hit.bounces > BOT_RAY_BOUNCES) break;
+	}
+	return hit;
+}
+
+// works out every bot's buttons for this step from where the tanks are, and writes them into input
+void BotPlayers::Update(InputState* input, LayerManager* tankManager, Map* map) {
+	u64 start = GetClockTicks();
+	// every tank's center is a target (for each bot, all of them but its own)
+	Vec2 targets[MAX_PLAYERS];
+	Tank* tanks[MAX_PLAYERS];
+	int tankCount = std::min((int) tankManager->GetSize(), MAX_PLAYERS);
+	for (int i = 0; i < tankCount; i++) {
+		tanks[i] = (Tank*) tankManager->GetLayerAt(i);
+		targets[i] = tanks[i]->GetBox()->center;
+	}
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		if (!(players & (1 << player))) continue;
+		BotState* state = &states[player];
+		u32 held = 0;
+		for (int i = 0; i < tankCount; i++) {
+			if (tanks[i]->GetPlayer() == player) held = UpdateBot(state, tanks[i], targets, tankCount, i, map);
+		}
+		input->players[player].held = held;
+		input->players[player].down = held & ~state->held;
+		state->held = held;
+	}
+	updates++;
+	u64 elapsed = GetClockTicks() - start;
+	ticks += elapsed;
+	maxTicks = std::max(maxTicks, elapsed);
+}
+
+// works out the buttons for one bot's tank
+// it shoots if its turret's lined up on someone, otherwise it turns to the best shot its scan has found (and takes it), and otherwise it drives towards the nearest tank along the maze
+u32 BotPlayers::UpdateBot(BotState* state, Tank* tank, const Vec2* targets, int targetCount, int self, Map* map) {
+	u32 held = 0;
+	Vec2 center = targets[self];
+	Angle heading = HalfDegreesToAngle(tank->GetRotation());
+	Vec2 facing = {AngleCosine(heading), AngleSine(heading)};
+	// look down the turret
+	if (state->fireDelay > 0) state->fireDelay--;
+	if (state->wander > 0) state->wander--;
+	Vec2 muzzle = {center.x + facing.x * BOT_MUZZLE_DISTANCE, center.y + facing.y * BOT_MUZZLE_DISTANCE};
+	BotRayHit hit = CastBotRay(map, muzzle, facing, targets, targetCount, self);
+	bool onTarget = hit.target >= 0 && hit.target != self;
+	if (onTarget && !state->fireDelay) {
+		held |= BUTTON_1;
+		state->fireDelay = BOT_FIRE_DELAY;
+	}
+	// look around (keeping the shot with the fewest bounces, since it's the least likely to go wrong)
+	if (state->aiming && ++state->aimAge > BOT_AIM_LIFE) state->aiming = false;
+	for (int ray = 0; ray < BOT_SCAN_RAYS && !state->wander; ray++) {
+		Angle direction = {state->scan * (u32) (0x100000000ull / BOT_SCAN_DIRECTIONS)};
+		state->scan = (state->scan + 1) % BOT_SCAN_DIRECTIONS;
+		Vec2 scanFacing = {AngleCosine(direction), AngleSine(direction)};
+		Vec2 scanMuzzle = {center.x + scanFacing.x * BOT_MUZZLE_DISTANCE, center.y + scanFacing.y * BOT_MUZZLE_DISTANCE};
+		BotRayHit scanHit = CastBotRay(map, scanMuzzle, scanFacing, targets, targetCount, self);
+		if (scanHit.target < 0 || scanHit.target == self || (state->aiming && scanHit.bounces >= state->aimBounces)) continue;
+		state->aiming = true;
+		state->aim = direction;
+		state->aimBounces = scanHit.bounces;
+		state->aimAge = 0;
+	}
+	rays += 1 + (state->wander ? 0 : BOT_SCAN_RAYS);
+	if (onTarget) return held; // hold still while it's lined up
+	// once it's turned to the aim, the turret's ray is at a slightly different angle than the scan's was (and after a bounce or two that can miss),
+	// so it takes the shot the scan found anyway, and then goes looking for a better one
+	if (state->aiming && abs((s32) (state->aim.turns - heading.turns)) <= BOT_TURN_TOLERANCE) {
+		if (!state->fireDelay) {
+			held |= BUTTON_1;
+			state->fireDelay = BOT_FIRE_DELAY;
+		}
+		state->aiming = false;
+		state->wander = BOT_WANDER;
+	}
+	// where to head: the aim if there is one, otherwise the way to the nearest tank by path
+	Angle goal = state->aim;
+	bool drive = false;
+	if (!state->aiming) {
+		MazeDistances* distances = map->GetMazeDistances();
+		f32 cellWidth = map->GetCellWidth();
+		f32 cellHeight = map->GetCellHeight();
+		f32 offset = map->GetWallThickness() / 2.0f;
+		int width = map->GetWidth();
+		int cellX = std::min(std::max((int) ((center.x - offset) / cellWidth), 0), width - 1);
+		int cellY = std::min(std::max((int) ((center.y - offset) / cellHeight), 0), map->GetHeight() - 1);
+		int cell = cellY * width + cellX;
+		int nearest = -1;
+		int nearestField = 0;
+		for (int i = 0; i < targetCount; i++) {
+			if (i == self) continue;
+			int targetX = std::min(std::max((int) ((targets[i].x - offset) / cellWidth), 0), width - 1);
+			int targetY = std::min(std::max((int) ((targets[i].y - offset) / cellHeight), 0), map->GetHeight() - 1);
+			int field = GetMazeField(distances, map->GetMaze(), targetY * width + targetX);
+			if (nearest < 0 || distances->steps[field + cell] < distances->steps[nearestField + cell]) {
+				nearest = i;
+				nearestField = field;
+			}
+		}
+		if (nearest < 0) return held; // no one left
+		int direction = distances->directions[nearestField + cell];
+		Vec2 waypoint = targets[nearest]; // in the same cell, so straight at it
+		if (direction != MAZE_NOWHERE) {
+			// the middle of the next cell, unless the tank's too far to the side of its own cell to get through the gap, in which case the middle of its own cell first
+			Vec2 cellCenter = {(cellX + .5f) * cellWidth + offset, (cellY + .5f) * cellHeight + offset};
+			bool across = direction == MAZE_EAST || direction == MAZE_WEST;
+			f32 sideways = across ? fabsf(center.y - cellCenter.y) / cellHeight : fabsf(center.x - cellCenter.x) / cellWidth;
+			waypoint = cellCenter;
+			if (sideways < .2f) {
+				waypoint.x += direction == MAZE_EAST ? cellWidth : direction == MAZE_WEST ? -cellWidth : 0;
+				waypoint.y += direction == MAZE_SOUTH ? cellHeight : direction == MAZE_NORTH ? -cellHeight : 0;
+			}
+		}
+		goal = ArcTangent(waypoint.y - center.y, waypoint.x - center.x);
+		drive = true;
+	}
+	// turn towards it (an angle going up is clockwise on screen), and drive once it's roughly ahead
+	s32 turn = (s32) (goal.turns - heading.turns);
+	if (turn > BOT_TURN_TOLERANCE) held |= BUTTON_DOWN;
+	if (turn < -BOT_TURN_TOLERANCE) held |= BUTTON_UP;
+	if (drive && abs(turn) < BOT_DRIVE_TOLERANCE) held |= BUTTON_2;
+	return held;
+}
+
+// forgets what the bots were doing (for a new round)
+void BotPlayers::Reset() {
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		BotState* state = &states[player];
+		state->held = 0;
+		state->scan = player * BOT_SCAN_DIRECTIONS / MAX_PLAYERS; // so they don't all look the same way at once
+		state->aiming = false;
+		state->aim.turns = 0;
+		state->aimBounces = 0;
+		state->aimAge = 0;
+		state->fireDelay = 0;
+		state->wander = 0;
+	}
+}
+
+BotPlayers::BotPlayers() {
+	players = 0;
+	updates = 0;
+	ticks = 0;
+	maxTicks = 0;
+	rays = 0;
+	Reset();
+}
\ No newline at end of file
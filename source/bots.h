@@ -0,0 +1,88 @@
+#ifndef TANK_BOTS_H
+#define TANK_BOTS_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+
+#include "platform.h"
+#include "angle.h"
+#include "collision.h"
+#include "map.h"
+#include "tank.h"
+
+using namespace wsp;
+
+// computer players: each step, a bot works out the buttons its player would press, which go into the input in place of the player's own
+// (so everything downstream, replays included, sees a bot as just another player)
+// bots find their way around with the map's maze distances (a field for each cell a tank's in, searched the first time a bot heads there; see GetMazeField), heading for the nearest tank by path,
+// and aim by casting rays that bounce off the maze's walls the way a bullet would, firing when the ray along their turret reaches another tank before it comes back to them
+// what a bot does each step is bounded: one ray along its turret and BOT_SCAN_RAYS more round a scan, each crossing at most BOT_RAY_CELLS cells, and a few lookups to steer
+// (plus a search of the maze the first time a tank's cell is looked up in a round, which is one visit to each of its cells),
+// so four of them cost a small, bounded amount every step however the round's going (the time is measured, and shown as the profiler's bots phase)
+
+// rays each bot casts per step as it looks around, besides the one along its turret (the scan goes round BOT_SCAN_DIRECTIONS directions, so it takes
+// BOT_SCAN_DIRECTIONS / BOT_SCAN_RAYS steps to look all the way round)
+#define BOT_SCAN_RAYS 2
+#define BOT_SCAN_DIRECTIONS 32
+// walls a ray bounces off, and cells it crosses, before it's given up on (together these cap the work a ray can take, however open the map is)
+#define BOT_RAY_BOUNCES 3
+#define BOT_RAY_CELLS 40
+// how close a ray has to pass to a tank's center to count as hitting it (about the middle of a tank's collision box)
+#define BOT_HIT_RADIUS 9
+// steps between a bot's shots, that an aim found by the scan is kept for (long enough to turn all the way round to it),
+// and that a bot drives without scanning after taking a shot its scan found (so it doesn't sit there taking the same one)
+#define BOT_FIRE_DELAY 20
+#define BOT_AIM_LIFE 64
+#define BOT_WANDER 90
+
+// what a ray hit
+struct BotRayHit {
+	int target; // index of the first target the ray passed within BOT_HIT_RADIUS of (-1 if none)
+	int bounces;
+	int cells; // cells it crossed
+};
+
+// casts a ray from start along a unit direction through a map's maze, reflecting it off the walls between cells where a bullet would bounce
+// (spinners are left out, since they move), and finds the first of the targets it passes close to (ignoring the target at index ignore until the ray's bounced, so a tank's own ray doesn't hit it on the way out)
+BotRayHit CastBotRay(Map* map, Vec2 start, Vec2 direction, const Vec2* targets, int targetCount, int ignore);
+
+// the bot players of a game
+class BotPlayers {
+	public:
+		// sets which players are bots (a bit for each player)
+		void SetPlayers(u32 players) { this->players = players; }
+		u32 GetPlayers() const { return players; }
+		// works out every bot's buttons for this step from where the tanks are, and writes them into input (a bot without a tank presses nothing)
+		void Update(InputState* input, LayerManager* tankManager, Map* map);
+		// forgets what the bots were doing (for a new round)
+		void Reset();
+		// what the updates have cost so far: how many there have been, the time they took in total and at most (in clock ticks), and the rays they cast
+		u32 GetUpdates() const { return updates; }
+		u64 GetTicks() const { return ticks; }
+		u64 GetMaxTicks() const { return maxTicks; }
+		u64 GetRays() const { return rays; }
+		BotPlayers();
+	private:
+		// what a bot is up to
+		struct BotState {
+			u32 held; // buttons it held last step (so it can tell which ones it's pressing this step)
+			u32 scan; // next direction it'll scan
+			bool aiming; // whether it's found a way to hit someone, and is turning to it
+			Angle aim;
+			int aimBounces;
+			int aimAge;
+			int fireDelay; // steps until it can shoot again
+			int wander; // steps until it starts scanning again
+		};
+		u32 players;
+		BotState states[MAX_PLAYERS];
+		u32 updates;
+		u64 ticks;
+		u64 maxTicks;
+		u64 rays;
+		// works out the buttons for one bot's tank (the tanks' centers are in targets, this tank's at index self)
+		u32 UpdateBot(BotState* state, Tank* tank, const Vec2* targets, int targetCount, int self, Map* map);
+};
+
+#endif
\ No newline at end of file
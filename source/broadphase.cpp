@@ -0,0 +1,129 @@
+#include "broadphase.h"
+#include "tank.h"
+
+// empties the broadphase, sets its counters back to 0, and makes room for the most tanks and bullets there can be
+void ResetBroadphase(Broadphase* broadphase, int maxTanks, int maxBullets) {
+	broadphase->entries.clear();
+	broadphase->tankCount = 0;
+	broadphase->bulletCount = 0;
+	broadphase->tanks.clear();
+	broadphase->pairs.clear();
+	broadphase->updates = 0;
+	broadphase->swaps = 0;
+	broadphase->pairsFound = 0;
+	broadphase->entries.reserve(maxTanks + maxBullets);
+	broadphase->tanks.reserve(maxTanks);
+	broadphase->pairs.reserve(maxTanks * maxBullets);
+	broadphase->activeTanks.reserve(maxTanks);
+	broadphase->activeBullets.reserve(maxBullets);
+}
+
+// sorts pairs by tank, then bullet
+static bool PairBefore(const BroadphasePair& pair, const BroadphasePair& other) { return pair.tank != other.tank ? pair.tank < other.tank : pair.bullet < other.bullet; }
+
+// works out every tank's and bullet's bounds, sorts them, and sweeps them for this step's pairs
+void UpdateBroadphase(Broadphase* broadphase, LayerManager* tankManager, const BulletSystem* bullets) {
+	std::vector<BroadphaseEntry>& entries = broadphase->entries;
+	int tankCount = tankManager->GetSize();
+	int bulletCount = bullets->GetCount();
+	broadphase->updates++;
+	broadphase->tanks.resize(tankCount);
+	for (int i = 0; i < tankCount; i++) broadphase->tanks[i] = (Tank*) tankManager->GetLayerAt(i);
+	// drop the entries for tanks and bullets that are gone (the rest stay in order), then add entries for new ones
+	// (a removed bullet's index is taken by the last bullet, so an entry can be for a different bullet than last step; it's just further out of place for the sort to fix)
+	int kept = 0;
+	for (int i = 0; i < (int) entries.size(); i++) {
+		int id = entries[i].id;
+		if (id >= 0 ? id < bulletCount : -1 - id < tankCount) entries[kept++] = entries[i];
+	}
+	entries.resize(kept);
+	for (int i = broadphase->bulletCount; i < bulletCount; i++) entries.push_back({0, 0, 0, 0, i});
+	for (int i = broadphase->tankCount; i < tankCount; i++) entries.push_back({0, 0, 0, 0, -1 - i});
+	broadphase->tankCount = tankCount;
+	broadphase->bulletCount = bulletCount;
+	// work out where everything is now
+	for (int i = 0; i < (int) entries.size(); i++) {
+		BroadphaseEntry* entry = &entries[i];
+		Vec2 center, bounds;
+		if (entry->id >= 0) {
+			OrientedBox box = bullets->GetBox(entry->id);
+			center = box.center;
+			bounds = box.halfExtents; // the box is axis aligned
+		}
+		else {
+			Tank* tank = broadphase->tanks[-1 - entry->id];
+			center = tank->GetBox()->center;
+			bounds = tank->GetBounds();
+		}
+		entry->minX = center.x - bounds.x;
+		entry->maxX = center.x + bounds.x;
+		entry->minY = center.y - bounds.y;
+		entry->maxY = center.y + bounds.y;
+	}
+	// put them back in order (each entry only has to move past the few it passed, or was passed by, since the last step)
+	for (int i = 1; i < (int) entries.size(); i++) {
+		BroadphaseEntry entry = entries[i];
+		int j = i;
+		for (; j > 0 && entries[j - 1].minX > entry.minX; j--) entries[j] = entries[j - 1];
+		broadphase->swaps += i - j;
+		entries[j] = entry;
+	}
+	// sweep: each entry is checked against the active entries of the other kind, which are the ones that started before it and haven't ended yet
+	// (ones that ended before it started are dropped on the way, since they can't reach anything after it either)
+	broadphase->pairs.clear();
+	broadphase->activeTanks.clear();
+	broadphase->activeBullets.clear();
+	for (int i = 0; i < (int) entries.size(); i++) {
+		const BroadphaseEntry* entry = &entries[i];
+		bool isTank = entry->id < 0;
+		std::vector<int>& others = isTank ? broadphase->activeBullets : broadphase->activeTanks;
+		for (int j = 0; j < (int) others.size();) {
+			const BroadphaseEntry* other = &entries[others[j]];
+			if (other->maxX < entry->minX) {
+				others[j] = others.back();
+				others.pop_back();
+				continue;
+			}
+			if (other->minY <= entry->maxY && entry->minY <= other->maxY) {
+				const BroadphaseEntry* tank = isTank ? entry : other;
+				const BroadphaseEntry* bullet = isTank ? other : entry;
+				broadphase->pairs.push_back({-1 - tank->id, bullet->id});
+			}
+			j++;
+		}
+		(isTank ? broadphase->activeTanks : broadphase->activeBullets).push_back(i);
+	}
+	std::sort(broadphase->pairs.begin(), broadphase->pairs.end(), PairBefore);
+	broadphase->pairsFound += broadphase->pairs.size();
+}
+
+// fixes up the pairs from firstPair on after a bullet's been removed (and the last bullet moved into its place)
+void RemoveBroadphaseBullet(Broadphase* broadphase, int bullet, int last, int firstPair) {
+	std::vector<BroadphasePair>& pairs = broadphase->pairs;
+	int kept = firstPair;
+	for (int i = firstPair; i < (int) pairs.size(); i++) {
+		BroadphasePair pair = pairs[i];
+		if (pair.bullet == bullet) continue;
+		if (pair.bullet == last) pair.bullet = bullet;
+		pairs[kept++] = pair;
+	}
+	pairs.resize(kept);
+}
+
+// the narrowphase: tests each pair's tank against its bullet, removing every bullet that hits and destroying tanks that run out of life
+void HitTanks(Broadphase* broadphase, LayerManager* tankManager, BulletSystem* bullets, LayerManager* explosionManager, u32 (*kills)[MAX_PLAYERS]) {
+	for (int i = 0; i < (int) broadphase->pairs.size(); i++) {
+		BroadphasePair pair = broadphase->pairs[i];
+		Tank* tank = broadphase->tanks[pair.tank];
+		if (!tank || !tank->TestHit(bullets, pair.bullet)) continue;
+		int shooter = bullets->GetPlayer(pair.bullet);
+		// the bullet's used up, and the last bullet takes its index, so the pairs still to come are changed to match before going on
+		bullets->Remove(pair.bullet);
+		RemoveBroadphaseBullet(broadphase, pair.bullet, bullets->GetCount(), i + 1);
+		if (!tank->IsAlive()) {
+			if (kills) kills[shooter][tank->GetPlayer()]++;
+			tank->Destroy(tankManager, explosionManager);
+			broadphase->tanks[pair.tank] = NULL;
+		}
+	}
+}
\ No newline at end of file
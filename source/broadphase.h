@@ -0,0 +1,65 @@
+#ifndef TANK_BROADPHASE_H
+#define TANK_BROADPHASE_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+#include <vector>
+
+#include "bulletsystem.h"
+
+using namespace wsp;
+
+class Tank;
+
+// sort and sweep over x for the things that move, which finds every tank/bullet pair whose bounds overlap once per step (after everything has moved),
+// so the full collision test (the narrowphase, see HitTanks) only runs on those pairs instead of on every bullet for every tank
+// the entries are kept sorted from one step to the next, and since nothing moves far in a step, an insertion sort puts them back in order in close to one pass;
+// a sweep along them then only has to compare each tank with the bullets whose x ranges it crosses
+
+// one tank or bullet's axis aligned bounds
+struct BroadphaseEntry {
+	f32 minX;
+	f32 maxX;
+	f32 minY;
+	f32 maxY;
+	int id; // a bullet's index, or for a tank, -1 - its index in the tank manager
+};
+
+// a tank and a bullet whose bounds overlap (the tank is an index into Broadphase::tanks)
+struct BroadphasePair {
+	int tank;
+	int bullet;
+};
+
+struct Broadphase {
+	std::vector<BroadphaseEntry> entries; // sorted by minX (kept between steps, for the insertion sort)
+	int tankCount; // number of tanks and bullets the entries are for (the tank manager's first tankCount tanks and the first bulletCount bullets)
+	int bulletCount;
+	std::vector<Tank*> tanks; // the tanks this step's pairs are for (a tank that's destroyed is set to NULL)
+	std::vector<BroadphasePair> pairs; // this step's pairs, in tank order and then bullet order
+	std::vector<int> activeTanks; // entries whose x ranges the sweep is in (only used during UpdateBroadphase)
+	std::vector<int> activeBullets;
+	// counters (reset with ResetBroadphase), for checking how much work the insertion sort and the sweep are doing
+	u32 updates;
+	u32 swaps; // entries the insertion sort moved past each other
+	u32 pairsFound;
+};
+
+// empties the broadphase, sets its counters back to 0, and makes room for the most tanks and bullets there can be (so it doesn't allocate while they're in play)
+void ResetBroadphase(Broadphase* broadphase, int maxTanks, int maxBullets);
+
+// works out every tank's and bullet's bounds, sorts them, and sweeps them for this step's pairs
+// (tanks and bullets come and go between steps; entries for ones that are gone are dropped and new ones are added at the end, where the sort picks them up)
+void UpdateBroadphase(Broadphase* broadphase, LayerManager* tankManager, const BulletSystem* bullets);
+
+// fixes up the pairs from firstPair on after BulletSystem::Remove has taken out a bullet and moved the last bullet (now at index last) into its place:
+// pairs with the removed bullet are dropped, and pairs with the last one are pointed at its new index
+void RemoveBroadphaseBullet(Broadphase* broadphase, int bullet, int last, int firstPair);
+
+// the narrowphase: tests each pair's tank against its bullet, removing every bullet that hits and destroying tanks that run out of life
+// (a tank's pairs are in bullet order, so it's hit by the same bullet it would be if it tested every bullet in turn; removed bullets are taken out of the pairs still to come)
+// each tank destroyed is counted in kills[the bullet's player][the tank's player] (NULL to not count them)
+void HitTanks(Broadphase* broadphase, LayerManager* tankManager, BulletSystem* bullets, LayerManager* explosionManager, u32 (*kills)[MAX_PLAYERS] = NULL);
+
+#endif
\ No newline at end of file
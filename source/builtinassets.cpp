@@ -0,0 +1,19 @@
+#include "assetarchive.h"
+
+#include "assets_wta.h"
+
+// the archive of everything in data, built into the game (opened the first time it's asked for; it's never closed, since it's only a table over bytes that are always there)
+const AssetArchive* GetBuiltInAssets() {
+	static AssetArchive archive;
+	static bool opened = OpenAssetArchive(&archive, assets_wta, assets_wta_size);
+	(void) opened; // if it's somehow not valid, it's just empty
+	return &archive;
+}
+
+// returns a built in asset's bytes and fills in its info (NULL if there's no asset by that name)
+const u8* GetBuiltInAsset(const char* name, const AssetInfo** info) {
+	const AssetArchive* archive = GetBuiltInAssets();
+	const AssetInfo* asset = FindAsset(archive, name);
+	if (info) *info = asset;
+	return asset ? LoadAsset(archive, asset) : NULL;
+}
\ No newline at end of file
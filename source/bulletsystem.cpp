@@ -0,0 +1,231 @@
+#include "bulletsystem.h"
+#include "replay.h"
+using namespace wsp;
+
+// adds a bullet centered at (x, y) heading the given way, and returns its index (or -1 if there's no room)
+int BulletSystem::Spawn(int player, f32 x, f32 y, Angle heading, f32 radius, f32 speed, int life) { // default lifespan is 5 seconds (60 fps)
+	if (count == capacity) {
+		failedSpawns++;
+		return -1;
+	}
+	int bullet = count++;
+	if (count > highWater) highWater = count;
+	this->x[bullet] = x;
+	this->y[bullet] = y;
+	previousX[bullet] = x;
+	previousY[bullet] = y;
+	directionX[bullet] = AngleCosine(heading);
+	directionY[bullet] = AngleSine(heading);
+	this->heading[bullet] = heading;
+	this->speed[bullet] = speed;
+	this->radius[bullet] = radius;
+	this->life[bullet] = life;
+	this->player[bullet] = player;
+	playerCounts[player]++;
+	return bullet;
+}
+
+// removes a bullet (the last bullet takes its index)
+void BulletSystem::Remove(int bullet) {
+	playerCounts[player[bullet]]--;
+	int last = --count;
+	if (bullet == last) return;
+	x[bullet] = x[last];
+	y[bullet] = y[last];
+	previousX[bullet] = previousX[last];
+	previousY[bullet] = previousY[last];
+	directionX[bullet] = directionX[last];
+	directionY[bullet] = directionY[last];
+	heading[bullet] = heading[last];
+	speed[bullet] = speed[last];
+	radius[bullet] = radius[last];
+	life[bullet] = life[last];
+	player[bullet] = player[last];
+}
+
+// removes every bullet
+void BulletSystem::Clear() {
+	count = 0;
+	for (int i = 0; i < MAX_PLAYERS; i++) playerCounts[i] = 0;
+}
+
+// moves every bullet (scaled by the simulation's time scale), bouncing them off walls, and removes the ones that have run out of life or left the screen (returns how many times they bounced)
+int BulletSystem::Update(f32 timeScale, WallGrid* wallGrid) {
+	// age every bullet and get rid of the ones that are done, before anything moves (a removed bullet's index is taken by the last one, so it's looked at again)
+	for (int i = 0; i < count; i++) {
+		life[i] -= timeScale;
+		bool outOfBounds = x[i] + radius[i] < 0 || x[i] - radius[i] > screenWidth || y[i] + radius[i] < 0 || y[i] - radius[i] > screenHeight;
+		if (life[i] <= 0 || outOfBounds) {
+			Remove(i);
+			i--;
+		}
+	}
+	// then move them all (with no walls, like in the menu, that's just a straight line)
+	if (!wallGrid) {
+		for (int i = 0; i < count; i++) {
+			f32 distance = speed[i] * timeScale;
+			x[i] += directionX[i] * distance;
+			y[i] += directionY[i] * distance;
+		}
+		return 0;
+	}
+	if (wallEntries.size() < wallGrid->wallIds.size()) wallEntries.resize(wallGrid->wallIds.size());
+	int bounces = 0;
+	for (int i = 0; i < count; i++) {
+		int bulletBounces = Move(i, speed[i] * timeScale, wallGrid);
+		// make hit sound (the queue only plays it once however many bullets bounce this frame)
+		if (bulletBounces && sounds) sounds->Post(SOUND_HIT);
+		bounces += bulletBounces;
+	}
+	return bounces;
+}
+
+// moves one bullet along its path, bouncing it off the given walls, and returns how many times it bounced
+// the bullet is swept along its path as a circle, and each time it hits a wall it's stopped exactly where it touched,
+// reflected off the wall's true surface normal, and sent on its way for the rest of the frame's distance (so it can't skip through walls at any speed)
+int BulletSystem::Move(int bullet, f32 distance, WallGrid* wallGrid) {
+	Vec2 position = {x[bullet], y[bullet]};
+	Vec2 direction = {directionX[bullet], directionY[bullet]};
+	f32 bulletRadius = radius[bullet];
+	f32 remaining = distance;
+	int bounces = 0;
+	// every wall the bullet could reach this frame, whichever way it bounces (however fast it is, since there's room for all of them)
+	f32 reach = remaining + bulletRadius;
+	int* entries = wallEntries.data();
+	int entryCount = GatherWallGrid(wallGrid, position.x - reach, position.y - reach, position.x + reach, position.y + reach, entries, (int) wallEntries.size());
+	// the sweep never ends inside a wall, but bullets can still start in one (spinners move into them, and tanks fire them from right up against walls),
+	// so first get out of any wall the bullet is already in (using the square around the bullet's circle)
+	for (int i = 0; i < entryCount; i++) {
+		OrientedBox box = {position, {bulletRadius, bulletRadius}, {1, 0}};
+		OrientedBox wall = GetWallBox(&wallGrid->walls, entries[i]);
+		Contact collision = Collision(&box, &wall);
+		if (collision.overlap == 0) continue;
+		// axis * overlap points out of the wall, so flip the direction if it's heading back in
+		Vec2 outwards = {collision.axis.x * collision.overlap, collision.axis.y * collision.overlap};
+		position.x += outwards.x;
+		position.y += outwards.y;
+		Vec2 normal = NormalizeVector(outwards);
+		f32 approach = DotProduct(direction, normal);
+		if (approach < 0) {
+			direction.x -= 2 * approach * normal.x;
+			direction.y -= 2 * approach * normal.y;
+			bounces++;
+		}
+	}
+	// then sweep, bouncing up to a few times per frame (only corners can take more than that, and the remaining distance there is tiny)
+	const int maxBounces = 4;
+	const f32 skin = .01; // stop just short of each wall so the next sweep starts outside it
+	for (int bounce = 0; bounce <= maxBounces && remaining > 0; bounce++) {
+		// find the first wall the bullet would hit
+		f32 hitDistance = remaining;
+		Vec2 hitNormal;
+		bool hit = false;
+		for (int i = 0; i < entryCount; i++) {
+			OrientedBox wall = GetWallBox(&wallGrid->walls, entries[i]);
+			f32 wallDistance;
+			Vec2 normal;
+			if (SweepCircle(position, direction, hitDistance, bulletRadius, &wall, &wallDistance, &normal)) {
+				hitDistance = wallDistance;
+				hitNormal = normal;
+				hit = true;
+			}
+		}
+		if (!hit || bounce == maxBounces) { // nothing in the way (or out of bounces), so use up the rest of the distance
+			if (hit) remaining = std::max(hitDistance - skin, 0.0f);
+			position.x += direction.x * remaining;
+			position.y += direction.y * remaining;
+			break;
+		}
+		// move up to the wall and reflect
+		f32 travel = std::max(hitDistance - skin, 0.0f);
+		position.x += direction.x * travel;
+		position.y += direction.y * travel;
+		remaining -= hitDistance;
+		f32 approach = DotProduct(direction, hitNormal);
+		direction.x -= 2 * approach * hitNormal.x;
+		direction.y -= 2 * approach * hitNormal.y;
+		bounces++;
+	}
+	x[bullet] = position.x;
+	y[bullet] = position.y;
+	if (bounces) {
+		directionX[bullet] = direction.x;
+		directionY[bullet] = direction.y;
+		heading[bullet] = ArcTangent(direction.y, direction.x);
+	}
+	return bounces;
+}
+
+// saves where every bullet is now, for drawing them part way between this and where they are after the next step
+void BulletSystem::SavePoses() {
+	std::copy(x, x + count, previousX);
+	std::copy(y, y + count, previousY);
+}
+
+// draws every bullet part way (0-1) between its saved position and its current one
+void BulletSystem::Draw(RenderQueue* queue, f32 interpolation) {
+	const Image* image = sprite.GetImage();
+	for (int i = 0; i < count; i++) {
+		// the image is stretched to the bullet's size (rotation is in degrees/2)
+		sprite.SetStretchWidth(radius[i] * 2 / image->GetWidth());
+		sprite.SetStretchHeight(radius[i] * 2 / image->GetHeight());
+		sprite.SetRotation(AngleToHalfDegrees(heading[i]));
+		f32 drawX = previousX[i] + (x[i] - previousX[i]) * interpolation;
+		f32 drawY = previousY[i] + (y[i] - previousY[i]) * interpolation;
+		sprite.SetPosition(drawX - sprite.GetWidth() / 2, drawY - sprite.GetHeight() / 2);
+		queue->AddSprite(RENDER_PASS_BULLETS, &sprite);
+	}
+}
+
+// adds every bullet to a state hash (see replay.h)
+u32 BulletSystem::HashState(u32 hash) const {
+	hash = AddToStateHash(hash, (u32) count);
+	for (int i = 0; i < count; i++) {
+		hash = AddToStateHash(hash, x[i]);
+		hash = AddToStateHash(hash, y[i]);
+		hash = AddToStateHash(hash, directionX[i]);
+		hash = AddToStateHash(hash, directionY[i]);
+		hash = AddToStateHash(hash, life[i]);
+		hash = AddToStateHash(hash, (u32) player[i]);
+	}
+	return hash;
+}
+
+BulletSystem::BulletSystem(int capacity, f32 screenWidth, f32 screenHeight, TextureCache* textures, SoundQueue* sounds) {
+	this->capacity = capacity;
+	this->screenWidth = screenWidth;
+	this->screenHeight = screenHeight;
+	this->textures = textures;
+	this->sounds = sounds;
+	x = new f32[capacity];
+	y = new f32[capacity];
+	previousX = new f32[capacity];
+	previousY = new f32[capacity];
+	directionX = new f32[capacity];
+	directionY = new f32[capacity];
+	heading = new Angle[capacity];
+	speed = new f32[capacity];
+	radius = new f32[capacity];
+	life = new f32[capacity];
+	player = new int[capacity];
+	count = 0;
+	highWater = 0;
+	failedSpawns = 0;
+	Clear();
+	sprite.SetImage(textures->Acquire(TEXTURE_BULLET)); // every bullet shares the one image
+}
+
+BulletSystem::~BulletSystem() {
+	delete[] x;
+	delete[] y;
+	delete[] previousX;
+	delete[] previousY;
+	delete[] directionX;
+	delete[] directionY;
+	delete[] heading;
+	delete[] speed;
+	delete[] radius;
+	delete[] life;
+	delete[] player;
+	textures->Release(TEXTURE_BULLET);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef TANK_BULLETSYSTEM_H
+#define TANK_BULLETSYSTEM_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "platform.h"
+#include "audio.h"
+#include "texturecache.h"
+#include "angle.h"
+#include "collision.h"
+#include "wallgrid.h"
+#include "renderer.h"
+
+using namespace wsp;
+
+// every bullet in play, kept as arrays of each of their properties (positions, directions, lifetimes, owners...) rather than as one sprite per bullet,
+// so updating them is one pass over contiguous memory and there's nothing to allocate or delete when they're shot or die
+// bullets are indices into the arrays; removing one moves the last bullet into its place, so the live bullets are always the first GetCount()
+// they're only turned into a sprite (one shared sprite, moved to each bullet in turn) when they're drawn
+class BulletSystem {
+	public:
+		// adds a bullet centered at (x, y) heading the given way, and returns its index (or -1 if there's no room)
+		int Spawn(int player, f32 x, f32 y, Angle heading, f32 radius, f32 speed, int life = 60 * 5);
+		// removes a bullet (the last bullet takes its index)
+		void Remove(int bullet);
+		// removes every bullet
+		void Clear();
+		// moves every bullet (scaled by the simulation's time scale), bouncing them off walls, and removes the ones that have run out of life or left the screen
+		// (returns how many times they bounced)
+		int Update(f32 timeScale, WallGrid* wallGrid);
+		// saves where every bullet is now, for drawing them part way between this and where they are after the next step
+		void SavePoses();
+		// adds every bullet to a render queue, part way (0-1) between its saved position and its current one
+		void Draw(RenderQueue* queue, f32 interpolation = 1);
+		int GetCount() const { return count; }
+		int GetCapacity() const { return capacity; }
+		int GetHighWater() const { return highWater; } // most bullets that have been in play at once
+		int GetFailedSpawns() const { return failedSpawns; } // bullets that couldn't be shot because there was no room
+		// number of bullets a player has in play (kept as bullets are added and removed, so it's free to ask)
+		int GetPlayerCount(int player) const { return playerCounts[player]; }
+		int GetPlayer(int bullet) const { return player[bullet]; }
+		Vec2 GetPosition(int bullet) const { return {x[bullet], y[bullet]}; }
+		// adds every bullet to a state hash (see replay.h)
+		u32 HashState(u32 hash) const;
+		// the box a bullet hits tanks with (an axis aligned box, so its half width/height are also its bounds)
+		// it's the size the old bullet sprite's collision rectangle worked out to: 2 * radius whole pixels, scaled by the stretch that fits the image to 2 * radius
+		// (just the middle of the bullet, which is what the game has always been tuned around; with the whole bullet, a tank driving forwards would run into its own shots)
+		OrientedBox GetBox(int bullet) const {
+			const Image* image = sprite.GetImage();
+			f32 collisionSize = (u32) (radius[bullet] * 2);
+			Vec2 size = {collisionSize * radius[bullet] / image->GetWidth(), collisionSize * radius[bullet] / image->GetHeight()};
+			return {{x[bullet], y[bullet]}, size, {1, 0}};
+		}
+		// bullets are kept within the screen's width/height, drawn with the bullet image from the texture cache, and post a hit sound to the sound queue when they bounce (NULL for none)
+		BulletSystem(int capacity, f32 screenWidth, f32 screenHeight, TextureCache* textures, SoundQueue* sounds);
+		~BulletSystem();
+	private:
+		int capacity;
+		int count;
+		int highWater;
+		int failedSpawns;
+		f32 screenWidth;
+		f32 screenHeight;
+		int playerCounts[MAX_PLAYERS];
+		// one entry per bullet in each of these
+		f32* x; // center
+		f32* y;
+		f32* previousX; // center before the last step
+		f32* previousY;
+		f32* directionX; // unit vector the bullet is moving along
+		f32* directionY;
+		Angle* heading; // direction as an angle, for drawing (only worked out again when the bullet bounces)
+		f32* speed;
+		f32* radius;
+		f32* life; // steps left (at normal speed)
+		int* player;
+		TextureCache* textures;
+		SoundQueue* sounds;
+		Sprite sprite; // what every bullet is drawn with
+		std::vector<int> wallEntries; // the walls near the bullet being moved (sized for every wall in the grid, so a gather can never be cut short)
+		// moves one bullet along its path, bouncing it off the given walls, and returns how many times it bounced
+		int Move(int bullet, f32 distance, WallGrid* wallGrid);
+		// the system owns its arrays, so it can't be copied
+		BulletSystem(const BulletSystem&);
+		BulletSystem& operator=(const BulletSystem&);
+};
+
+#endif
\ No newline at end of file
@@ -15,10 +15,15 @@ void Button::Deselect() {
 
 int Button::GetID() { return id; }
 
-Button::Button(int id, const unsigned char* normalImgData, const unsigned char* overImgData) {
+Button::Button(int id, TextureCache* textures, TextureId normalTexture, TextureId overTexture) {
 	this->id = id;
-	normalImg = new Image();
-	normalImg->LoadImage(normalImgData);
-	overImg = new Image();
-	overImg->LoadImage(overImgData);
+	this->textures = textures;
+	this->normalTexture = normalTexture;
+	this->overTexture = overTexture;
+	normalImg = textures->Acquire(normalTexture);
+	overImg = textures->Acquire(overTexture);
+}
+Button::~Button() {
+	textures->Release(normalTexture);
+	textures->Release(overTexture);
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <gccore.h>
 #include <wiisprite.h>
 
+#include "texturecache.h"
+
 using namespace wsp;
 
 class Button : public Sprite {
@@ -12,9 +14,14 @@ class Button : public Sprite {
 		void Select();
 		void Deselect();
 		int GetID();
-		Button(int id, const unsigned char* normalImgData, const unsigned char* overImgData);
+		// the button's normal and selected images come from the given texture cache
+		Button(int id, TextureCache* textures, TextureId normalTexture, TextureId overTexture);
+		~Button();
 	private:
 		int id;
+		TextureCache* textures;
+		TextureId normalTexture;
+		TextureId overTexture;
 		Image* normalImg;
 		Image* overImg;
 };
@@ -0,0 +1,66 @@
+#include "clock.h"
+using namespace wsp;
+
+// sets up a clock with the given step length and catch-up limit, at normal speed
+void InitSimulationClock(SimulationClock* clock, f64 step, int maxSteps) {
+	clock->step = step;
+	clock->maxSteps = maxSteps;
+	clock->accumulator = 0;
+	clock->timeScale = 1;
+	clock->frames = 0;
+	clock->steps = 0;
+	clock->skippedSteps = 0;
+}
+
+// adds the real time that passed since the last frame, and returns how many steps to run this frame
+int AdvanceSimulationClock(SimulationClock* clock, f64 seconds) {
+	clock->accumulator += seconds;
+	int steps = (int) (clock->accumulator / clock->step);
+	if (steps > clock->maxSteps) {
+		// too far behind to catch up without making the next frame even later, so skip the extra time
+		clock->skippedSteps += steps - clock->maxSteps;
+		steps = clock->maxSteps;
+		clock->accumulator = steps * clock->step;
+	}
+	clock->accumulator -= steps * clock->step;
+	clock->frames++;
+	clock->steps += steps;
+	return steps;
+}
+
+// returns how far between the last step and the next one the current frame is (0-1)
+f32 GetSimulationInterpolation(const SimulationClock* clock) {
+	return std::min((f32) (clock->accumulator / clock->step), 1.0f);
+}
+
+// gets/sets a layer's pose
+LayerPose GetPose(Sprite* sprite) {
+	LayerPose pose = {sprite->GetX(), sprite->GetY(), sprite->GetRotation()};
+	return pose;
+}
+LayerPose GetPose(Quad* quad) {
+	LayerPose pose = {quad->GetX(), quad->GetY(), quad->GetRotation()};
+	return pose;
+}
+void SetPose(Sprite* sprite, const LayerPose* pose) {
+	sprite->SetPosition(pose->x, pose->y);
+	sprite->SetRotation(pose->rotation);
+}
+void SetPose(Quad* quad, const LayerPose* pose) {
+	quad->SetPosition(pose->x, pose->y);
+	quad->SetRotation(pose->rotation);
+}
+
+// returns the pose part way (0-1) between two poses (rotation goes the short way around)
+LayerPose InterpolatePose(const LayerPose* from, const LayerPose* to, f32 amount) {
+	Angle fromAngle = HalfDegreesToAngle(from->rotation);
+	// the difference between the angles wraps into -half a turn to half a turn as a signed int, which is the short way around
+	s32 turn = (s32) (HalfDegreesToAngle(to->rotation) - fromAngle).turns;
+	Angle rotation = {fromAngle.turns + (u32) (s32) (turn * amount)};
+	LayerPose pose = {
+		from->x + (to->x - from->x) * amount,
+		from->y + (to->y - from->y) * amount,
+		AngleToHalfDegrees(rotation)
+	};
+	return pose;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef TANK_CLOCK_H
+#define TANK_CLOCK_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+
+#include "angle.h"
+
+using namespace wsp;
+
+// length of a simulation step in seconds (all the per-step speeds in the game were tuned for 60 steps a second)
+#define SIMULATION_STEP (1.0 / 60)
+// most simulation steps run in one frame when catching up, before the rest of the time is skipped
+#define SIMULATION_MAX_STEPS 4
+
+// fixed timestep clock: real time is added up each frame, and the simulation runs however many whole steps fit in it, so it runs at the same speed
+// whatever the frame rate is (50hz pal, 60hz ntsc, or a slow frame); the leftover time is how far between steps the frame is, for drawing
+struct SimulationClock {
+	f64 step; // seconds per step
+	int maxSteps; // most steps run per frame
+	f64 accumulator; // real time that hasn't been simulated yet
+	f32 timeScale; // how fast simulation time passes (1 is normal, .5 is slow mo); everything that moves scales its per-step movement by this
+	// counters, for checking how often frames overrun
+	u32 frames;
+	u32 steps;
+	u32 skippedSteps;
+};
+
+// sets up a clock with the given step length and catch-up limit, at normal speed
+void InitSimulationClock(SimulationClock* clock, f64 step = SIMULATION_STEP, int maxSteps = SIMULATION_MAX_STEPS);
+
+// adds the real time that passed since the last frame, and returns how many steps to run this frame
+// (frames that overrun are caught up on with extra steps, up to maxSteps; past that, the time is skipped so a long stall doesn't snowball)
+int AdvanceSimulationClock(SimulationClock* clock, f64 seconds);
+
+// returns how far between the last step and the next one the current frame is (0-1), for drawing things part way between their last two positions
+f32 GetSimulationInterpolation(const SimulationClock* clock);
+
+// a layer's position and rotation at one point in time
+struct LayerPose {
+	f32 x;
+	f32 y;
+	f32 rotation;
+};
+
+// gets/sets a layer's pose
+LayerPose GetPose(Sprite* sprite);
+LayerPose GetPose(Quad* quad);
+void SetPose(Sprite* sprite, const LayerPose* pose);
+void SetPose(Quad* quad, const LayerPose* pose);
+
+// returns the pose part way (0-1) between two poses (rotation goes the short way around)
+LayerPose InterpolatePose(const LayerPose* from, const LayerPose* to, f32 amount);
+
+#endif
\ No newline at end of file
@@ -1,18 +1,64 @@
 #include "collision.h"
+#include "profiler.h"
 using namespace wsp;
 
-// returns a 2d vector containing the vertices of a tilted rectangle (based on https://math.stackexchange.com/questions/2518607)
-std::vector<std::vector<f32>> TiltedRectVertices(TiltedRect* rect) {
-	return {
-		{rect->x - rect->width * cos(rect->angle) - rect->height * sin(rect->angle), rect->y - rect->width * sin(rect->angle) + rect->height * cos(rect->angle)},
-		{rect->x + rect->width * cos(rect->angle) - rect->height * sin(rect->angle), rect->y + rect->width * sin(rect->angle) + rect->height * cos(rect->angle)},
-		{rect->x + rect->width * cos(rect->angle) + rect->height * sin(rect->angle), rect->y + rect->width * sin(rect->angle) - rect->height * cos(rect->angle)},
-		{rect->x - rect->width * cos(rect->angle) + rect->height * sin(rect->angle), rect->y - rect->width * sin(rect->angle) - rect->height * cos(rect->angle)}
+// returns the vertices of a tilted rectangle (based on https://math.stackexchange.com/questions/2518607)
+OBB TiltedRectVertices(const TiltedRect* rect) {
+	f32 cosAngle = AngleCosine(rect->angle);
+	f32 sinAngle = AngleSine(rect->angle);
+	OBB obb = {{
+		{rect->x - rect->width * cosAngle - rect->height * sinAngle, rect->y - rect->width * sinAngle + rect->height * cosAngle},
+		{rect->x + rect->width * cosAngle - rect->height * sinAngle, rect->y + rect->width * sinAngle + rect->height * cosAngle},
+		{rect->x + rect->width * cosAngle + rect->height * sinAngle, rect->y + rect->width * sinAngle - rect->height * cosAngle},
+		{rect->x - rect->width * cosAngle + rect->height * sinAngle, rect->y - rect->width * sinAngle - rect->height * cosAngle}
+	}};
+	return obb;
+}
+
+// returns the half width/height of the axis aligned box around an oriented box
+Vec2 GetBoxBounds(const OrientedBox* box) {
+	Vec2 bounds = {
+		box->halfExtents.x * (f32) fabs(box->axis.x) + box->halfExtents.y * (f32) fabs(box->axis.y),
+		box->halfExtents.x * (f32) fabs(box->axis.y) + box->halfExtents.y * (f32) fabs(box->axis.x)
 	};
+	return bounds;
+}
+
+// returns true if the axis aligned boxes around two centers (with the given half widths/heights) overlap; a cheap check to do before Collision
+bool BoundsOverlap(Vec2 center1, Vec2 bounds1, Vec2 center2, Vec2 bounds2) {
+	return fabs(center1.x - center2.x) <= bounds1.x + bounds2.x && fabs(center1.y - center2.y) <= bounds1.y + bounds2.y;
+}
+
+// returns the oriented box of a tilted rectangle
+OrientedBox TiltedRectBox(const TiltedRect* rect) {
+	OrientedBox box = {{rect->x, rect->y}, {rect->width, rect->height}, {AngleCosine(rect->angle), AngleSine(rect->angle)}};
+	return box;
+}
+
+// returns a sprite's oriented box (same dimensions as GetVertices)
+OrientedBox GetOrientedBox(Sprite* sprite) {
+	TiltedRect rect;
+	rect.x = sprite->GetX() + sprite->GetWidth() / 2;
+	rect.y = sprite->GetY() + sprite->GetHeight() / 2;
+	rect.width = (f32) sprite->GetCollisionRectangle()->width * sprite->GetStretchWidth() / 2;
+	rect.height = (f32) sprite->GetCollisionRectangle()->height * sprite->GetStretchHeight() / 2;
+	rect.angle = HalfDegreesToAngle(sprite->GetRotation());
+	return TiltedRectBox(&rect);
+}
+
+// returns a quad's oriented box (same dimensions as GetVertices)
+OrientedBox GetOrientedBox(Quad* quad) {
+	TiltedRect rect;
+	rect.width = (f32) quad->GetWidth() / 2;
+	rect.height = (f32) quad->GetHeight() / 2;
+	rect.x = quad->GetX() + rect.width;
+	rect.y = quad->GetY() + rect.height;
+	rect.angle = HalfDegreesToAngle(quad->GetRotation());
+	return TiltedRectBox(&rect);
 }
 
 // returns a sprite's vertices
-std::vector<std::vector<f32>> GetVertices(Sprite* sprite) {
+OBB GetVertices(Sprite* sprite) {
 	TiltedRect rect;
 	// x and y are centered based on sprite dimensions (stretching is automatically applied from center so no need to account for that)
 	rect.x = sprite->GetX() + sprite->GetWidth() / 2;
@@ -20,14 +66,14 @@ std::vector<std::vector<f32>> GetVertices(Sprite* sprite) {
 	// width and height have stretching and custom collision rectangles accounted for
 	rect.width = (f32) sprite->GetCollisionRectangle()->width * sprite->GetStretchWidth() / 2;
 	rect.height = (f32) sprite->GetCollisionRectangle()->height * sprite->GetStretchHeight() / 2;
-	// angle is doubled and converted to radians
-	rect.angle = sprite->GetRotation() * 2.0 * (M_PI / 180.0);
+	// angle is converted from degrees/2
+	rect.angle = HalfDegreesToAngle(sprite->GetRotation());
 	// vertices are calculated
 	return TiltedRectVertices(&rect);
 }
 
 // returns a quad's vertices
-std::vector<std::vector<f32>> GetVertices(Quad* quad) {
+OBB GetVertices(Quad* quad) {
 	TiltedRect rect;
 	// width and height are calculated first since they're used for x and y (quads are simpler than sprites because they lack stretching and custom collision rectangles)
 	rect.width = (f32) quad->GetWidth() / 2;
@@ -35,121 +81,202 @@ std::vector<std::vector<f32>> GetVertices(Quad* quad) {
 	// x and y are centered
 	rect.x = quad->GetX() + rect.width;
 	rect.y = quad->GetY() + rect.height;
-	// angle is doubled and converted to radians
-	rect.angle = quad->GetRotation() * 2.0 * (M_PI / 180.0);
+	// angle is converted from degrees/2
+	rect.angle = HalfDegreesToAngle(quad->GetRotation());
 	// vertices are calculated
 	return TiltedRectVertices(&rect);
 }
 
-// returns the dot product of two 2d vectors defined by f32 arrays
-f32 DotProduct(std::vector<f32> vector1, std::vector<f32> vector2) {
-	return (vector1[0] * vector2[0] + vector1[1] * vector2[1]);
+// returns the dot product of two 2d vectors
+f32 DotProduct(Vec2 vector1, Vec2 vector2) {
+	return (vector1.x * vector2.x + vector1.y * vector2.y);
 }
 
 // returns the normalized version of the vector passed in by dividing each of its components by its magnitude
-std::vector<f32> NormalizeVector(std::vector<f32> vector) {
-	f32 magnitude = sqrt(pow(vector[0], 2) + pow(vector[1], 2));
-	return {
-		vector[0] / magnitude,
-		vector[1] / magnitude
-	};
+Vec2 NormalizeVector(Vec2 vector) {
+	f32 magnitude = sqrt(vector.x * vector.x + vector.y * vector.y);
+	Vec2 normalized = {vector.x / magnitude, vector.y / magnitude};
+	return normalized;
 }
 
-// returns the 2 normal vectors to a vector
-std::vector<std::vector<f32>> GetNormalVectors(std::vector<f32> vector) {
-	std::vector<std::vector<f32>> normals = {
-		{-vector[1], vector[0]}, // (-y, x)
-		{vector[1], -vector[0]} // (y, -x)
-	};
-	return normals;
+// returns the first of the 2 normal vectors to a vector (the other is just its negation)
+Vec2 GetNormalVector(Vec2 vector) {
+	Vec2 normal = {-vector.y, vector.x}; // (-y, x)
+	return normal;
 }
 
-// returns an array of normalized edges given a polygon defined by an array of vertices
-std::vector<std::vector<f32>> GetEdgesFromVertices(std::vector<std::vector<f32>> vertices) {
-	int edgeCount = vertices.size();
-	std::vector<std::vector<f32>> edges(edgeCount, std::vector<f32>(2)); // as many edges as there are vertices; 2 components per edge (x/y)
-	for (int vertex = 0; vertex < edgeCount; vertex++) {
-		edges[vertex][0] = vertices[(vertex + 1) % edgeCount][0] - vertices[vertex][0];
-		edges[vertex][1] = vertices[(vertex + 1) % edgeCount][1] - vertices[vertex][1];
-		edges[vertex] = NormalizeVector(edges[vertex]);
+// fills edges with the 4 normalized edges of an obb
+void GetEdgesFromVertices(const OBB* obb, Vec2 edges[4]) {
+	for (int vertex = 0; vertex < 4; vertex++) {
+		const Vec2& current = obb->vertices[vertex];
+		const Vec2& next = obb->vertices[(vertex + 1) % 4];
+		Vec2 edge = {next.x - current.x, next.y - current.y};
+		edges[vertex] = NormalizeVector(edge);
 	}
-	return edges;
 }
 
-// returns an array of the normals to an array of edges (note: normal count will be double edge count, since a vertex has 2 normals in opposite directions)
-std::vector<std::vector<f32>> GetNormalsFromEdges(std::vector<std::vector<f32>> edges) {
-	int edgeCount = edges.size();
-	std::vector<std::vector<f32>> normals(edgeCount * 2, std::vector<f32>(2)); // 2x as many normals as there are edges, 2 components per normal (x/y)
-	for (int vertex = 0; vertex < edgeCount; vertex++) {
-		std::vector<std::vector<f32>> edgeNormals = GetNormalVectors(edges[vertex]);
-		normals[vertex * 2 + 0] = edgeNormals[0];
-		normals[vertex * 2 + 1] = edgeNormals[1];
+// fills normals with one normal per edge (the opposite normals are skipped, since they'd just give the same axes in reverse)
+void GetNormalsFromEdges(const Vec2 edges[4], Vec2 normals[4]) {
+	for (int edge = 0; edge < 4; edge++) {
+		normals[edge] = GetNormalVector(edges[edge]);
 	}
-	return normals;
 }
 
-// returns the interval that a polygon (defined by a set of vertices) takes up on a given axis
-std::vector<f32> GetIntervalOnAxis(std::vector<std::vector<f32>> vertices, std::vector<f32> axis) {
-	std::vector<f32> interval(2);
-	for (int vertex = 0; vertex < (int) vertices.size(); vertex++) { // loop through all vertices to find the min and max
-		f32 d = DotProduct(axis, vertices[vertex]);
-		if (vertex == 0) { // on the first iteration, set the min and max to the current vertex
-			interval[0] = d;
-			interval[1] = d;
-		}
-		if (interval[0] > d) interval[0] = d;
-		if (interval[1] < d) interval[1] = d;
+// returns the interval that an obb takes up on a given axis
+Interval GetIntervalOnAxis(const OBB* obb, Vec2 axis) {
+	// start with the first vertex as the min and max, then loop through the rest to expand it
+	f32 d = DotProduct(axis, obb->vertices[0]);
+	Interval interval = {d, d};
+	for (int vertex = 1; vertex < 4; vertex++) {
+		d = DotProduct(axis, obb->vertices[vertex]);
+		if (interval.min > d) interval.min = d;
+		if (interval.max < d) interval.max = d;
 	}
 	return interval;
 }
 
-// returns the overlap between two polygons (defined by sets of vertices) on a given axis
-f32 GetOverlapOnAxis(std::vector<std::vector<f32>> vertices1, std::vector<std::vector<f32>> vertices2, std::vector<f32> axis) {
+// returns the overlap between two obbs on a given axis
+f32 GetOverlapOnAxis(const OBB* obb1, const OBB* obb2, Vec2 axis) {
 	f32 overlap = 0.0;
-	std::vector<f32> interval1 = GetIntervalOnAxis(vertices1, axis);
-	std::vector<f32> interval2 = GetIntervalOnAxis(vertices2, axis);
-	if ((interval2[0] < interval1[1]) && (interval1[0] < interval2[1])) overlap = interval2[0] - interval1[1]; // there is overlap, so return amount of overlap (otherwise 0)
+	Interval interval1 = GetIntervalOnAxis(obb1, axis);
+	Interval interval2 = GetIntervalOnAxis(obb2, axis);
+	if ((interval2.min < interval1.max) && (interval1.min < interval2.max)) overlap = interval2.min - interval1.max; // there is overlap, so return amount of overlap (otherwise 0)
 	return overlap;
 }
 
-// returns info (penetrating axis and amount on axis) regarding a collision (or the lack thereof) between two convex polygons (defined by sets of vertices)
-std::vector<f32> Collision(std::vector<std::vector<f32>> vertices1, std::vector<std::vector<f32>> vertices2) {
-	int vertexCount1 = vertices1.size();
-	int vertexCount2 = vertices2.size();
-	std::vector<std::vector<f32>> axes(vertexCount1 + vertexCount2, std::vector<f32>(2)); // (total vertices) vertices, 2 coords per vertex (x/y)
-	std::vector<std::vector<f32>> normals1 = GetNormalsFromEdges(GetEdgesFromVertices(vertices1));
-	std::vector<std::vector<f32>> normals2 = GetNormalsFromEdges(GetEdgesFromVertices(vertices2));
-	std::vector<std::vector<f32>> collisionInfo(vertexCount1 + vertexCount2, std::vector<f32>(3)); // 1 set of info for each axis, 3 floats per info (x, y, distance)
-	int penetratingIndex = 0;
-	// only use every other normal, since half are just duplicates in opposite directions
-	for (int i = 0; i < vertexCount1; i++) {
-		axes[i] = normals1[i * 2];
-	}
-	for (int i = 0; i < vertexCount2; i++) {
-		axes[vertexCount1 + i] = normals2[i * 2];
-	}
+// returns info (penetrating axis and amount on axis) regarding a collision (or the lack thereof) between two obbs
+Contact Collision(const OBB* obb1, const OBB* obb2) {
+	CountProfileEvent(PROFILE_COLLISION_PAIRS);
+	Vec2 edges[4];
+	Vec2 axes[8]; // 4 axes from each obb
+	GetEdgesFromVertices(obb1, edges);
+	GetNormalsFromEdges(edges, axes);
+	GetEdgesFromVertices(obb2, edges);
+	GetNormalsFromEdges(edges, axes + 4);
 	// axes have been evaluated, time to get overlap for each one and evaluate collision
-	for (int i = 0; i < vertexCount1 + vertexCount2; i++) {
-		collisionInfo[i][0] = axes[i][0];
-		collisionInfo[i][1] = axes[i][1];
-		collisionInfo[i][2] = GetOverlapOnAxis(vertices1, vertices2, axes[i]);
-		if (abs(collisionInfo[i][2]) < abs(collisionInfo[penetratingIndex][2])) penetratingIndex = i; // update penetrating index if current axis has a smaller overlap interval
+	Contact contact;
+	for (int i = 0; i < 8; i++) {
+		f32 overlap = GetOverlapOnAxis(obb1, obb2, axes[i]);
+		if (i == 0 || fabs(overlap) < fabs(contact.overlap)) { // update penetrating axis if current axis has a smaller overlap interval
+			contact.axis = axes[i];
+			contact.overlap = overlap;
+		}
+		if (overlap == 0) break; // a separating axis was found, so nothing later can beat it
 	}
-	return collisionInfo[penetratingIndex];
+	return contact;
 }
 
 // a few function overloads to make collision easy
-std::vector<f32> Collision(Sprite* collider1, Sprite* collider2) {
-	return Collision(GetVertices(collider1), GetVertices(collider2));
+Contact Collision(Sprite* collider1, Sprite* collider2) {
+	OBB obb1 = GetVertices(collider1);
+	OBB obb2 = GetVertices(collider2);
+	return Collision(&obb1, &obb2);
+}
+Contact Collision(Sprite* collider1, Quad* collider2) {
+	OBB obb1 = GetVertices(collider1);
+	OBB obb2 = GetVertices(collider2);
+	return Collision(&obb1, &obb2);
 }
-std::vector<f32> Collision(Sprite* collider1, Quad* collider2) {
-	return Collision(GetVertices(collider1), GetVertices(collider2));
+Contact Collision(Quad* collider1, Sprite* collider2) {
+	OBB obb1 = GetVertices(collider1);
+	OBB obb2 = GetVertices(collider2);
+	return Collision(&obb1, &obb2);
 }
-std::vector<f32> Collision(Quad* collider1, Sprite* collider2) {
-	return Collision(GetVertices(collider1), GetVertices(collider2));
+Contact Collision(Quad* collider1, Quad* collider2) {
+	OBB obb1 = GetVertices(collider1);
+	OBB obb2 = GetVertices(collider2);
+	return Collision(&obb1, &obb2);
 }
-std::vector<f32> Collision(Quad* collider1, Quad* collider2) {
-	return Collision(GetVertices(collider1), GetVertices(collider2));
+
+// returns the same info as Collision, but for two oriented boxes (only the 2 axes of each box are tested, since the other 2 are just their reverses)
+Contact Collision(const OrientedBox* box1, const OrientedBox* box2) {
+	CountProfileEvent(PROFILE_COLLISION_PAIRS);
+	Vec2 offset = {box2->center.x - box1->center.x, box2->center.y - box1->center.y};
+	Vec2 axes[4] = {box1->axis, GetNormalVector(box1->axis), box2->axis, GetNormalVector(box2->axis)};
+	// cos/sin of the angle between the boxes; every projected radius is made of these (see BatchCollision in wallbatch.cpp)
+	f32 cosAbs = fabs(DotProduct(box1->axis, box2->axis));
+	f32 sinAbs = fabs(DotProduct(axes[1], box2->axis));
+	f32 radii[4] = {
+		box1->halfExtents.x + box2->halfExtents.x * cosAbs + box2->halfExtents.y * sinAbs,
+		box1->halfExtents.y + box2->halfExtents.x * sinAbs + box2->halfExtents.y * cosAbs,
+		box2->halfExtents.x + box1->halfExtents.x * cosAbs + box1->halfExtents.y * sinAbs,
+		box2->halfExtents.y + box1->halfExtents.x * sinAbs + box1->halfExtents.y * cosAbs
+	};
+	Contact contact;
+	for (int i = 0; i < 4; i++) {
+		f32 distance = DotProduct(offset, axes[i]);
+		f32 overlap = radii[i] - fabs(distance); // how far box1 would have to move along the axis to be clear of box2
+		if (overlap <= 0) { // a separating axis was found
+			contact.axis = axes[i];
+			contact.overlap = 0;
+			return contact;
+		}
+		if (i == 0 || overlap < fabs(contact.overlap)) {
+			// the axis is always the box's own, and the overlap's sign points away from box2, so moving box1 by axis * overlap pushes it out of box2
+			// (the vertex version always gives a negative overlap, on whichever of the axis and its reverse points at box2; the push out's the same)
+			contact.axis = axes[i];
+			contact.overlap = distance >= 0 ? -overlap : overlap;
+		}
+	}
+	return contact;
+}
+
+// sweeps a circle from start along direction (a unit vector) for up to maxDistance, and returns true if it hits the box on the way
+// on a hit, distance is set to how far the circle got before touching the box and normal to the box's surface normal at the contact
+// (this is a ray cast against the box grown by the radius, with rounded corners, so it's exact; circles that start inside the box don't count as hits)
+bool SweepCircle(Vec2 start, Vec2 direction, f32 maxDistance, f32 radius, const OrientedBox* box, f32* distance, Vec2* normal) {
+	CountProfileEvent(PROFILE_COLLISION_PAIRS);
+	// work in the box's space, where it's axis aligned and centered on the origin
+	Vec2 heightAxis = GetNormalVector(box->axis);
+	Vec2 offset = {start.x - box->center.x, start.y - box->center.y};
+	f32 position[2] = {DotProduct(offset, box->axis), DotProduct(offset, heightAxis)};
+	f32 velocity[2] = {DotProduct(direction, box->axis), DotProduct(direction, heightAxis)};
+	f32 halfExtents[2] = {box->halfExtents.x, box->halfExtents.y};
+	// slab test against the box grown by the radius on every side
+	f32 enter = -INFINITY;
+	f32 exit = INFINITY;
+	int enterAxis = 0;
+	for (int axis = 0; axis < 2; axis++) {
+		f32 extent = halfExtents[axis] + radius;
+		if (fabs(velocity[axis]) < 1e-6) { // parallel to this slab, so it has to already be between its sides
+			if (fabs(position[axis]) > extent) return false;
+			continue;
+		}
+		f32 slabNear = (-extent - position[axis]) / velocity[axis];
+		f32 slabFar = (extent - position[axis]) / velocity[axis];
+		if (slabNear > slabFar) std::swap(slabNear, slabFar);
+		if (slabNear > enter) {
+			enter = slabNear;
+			enterAxis = axis;
+		}
+		exit = std::min(exit, slabFar);
+	}
+	if (enter > exit || exit < 0 || enter > maxDistance) return false;
+	// where it first touches the grown box (or where it starts, if it starts inside the grown box)
+	f32 hit[2] = {position[0] + velocity[0] * std::max(enter, 0.0f), position[1] + velocity[1] * std::max(enter, 0.0f)};
+	f32 localNormal[2] = {0, 0};
+	if (fabs(hit[0]) > halfExtents[0] && fabs(hit[1]) > halfExtents[1]) {
+		// the grown box has square corners but the real shape's corners are rounded, so redo the test against the circle around the corner
+		// (this also covers starting in the gap between the square corner and the rounded one, which is still outside)
+		f32 corner[2] = {copysign(halfExtents[0], hit[0]), copysign(halfExtents[1], hit[1])};
+		f32 fromCorner[2] = {position[0] - corner[0], position[1] - corner[1]};
+		f32 b = fromCorner[0] * velocity[0] + fromCorner[1] * velocity[1];
+		f32 c = fromCorner[0] * fromCorner[0] + fromCorner[1] * fromCorner[1] - radius * radius;
+		f32 discriminant = b * b - c;
+		if (c < 0 || discriminant < 0) return false; // started inside, or went past the corner without touching it
+		enter = -b - sqrt(discriminant);
+		if (enter < 0 || enter > maxDistance) return false;
+		localNormal[0] = (fromCorner[0] + velocity[0] * enter) / radius;
+		localNormal[1] = (fromCorner[1] + velocity[1] * enter) / radius;
+	}
+	else {
+		if (enter < 0) return false; // started inside
+		localNormal[enterAxis] = velocity[enterAxis] > 0 ? -1 : 1; // a face, so the normal points back against the direction of travel
+	}
+	*distance = enter;
+	normal->x = localNormal[0] * box->axis.x + localNormal[1] * heightAxis.x;
+	normal->y = localNormal[0] * box->axis.y + localNormal[1] * heightAxis.y;
+	return true;
 }
 
 // returns true if layers 1 and 2 are close enough to possibly collide (the parameters are gross but this lets me generalize it to all layers rather than, say, just sprites)
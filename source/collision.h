@@ -5,57 +5,114 @@
 #include <gccore.h>
 #include <wiisprite.h>
 #include <math.h>
-#include <vector>
+#include <algorithm>
+
+#include "angle.h"
 
 using namespace wsp;
 
-// rectangle structure for determining collision (note: height/width represent true height/width divided by 2, also angle is in radians)
+// rectangle structure for determining collision (note: height/width represent true height/width divided by 2)
 struct TiltedRect {
 	f32 x;
 	f32 y;
 	f32 width;
 	f32 height;
-	f32 angle;
+	Angle angle;
+};
+
+// plain 2d vector (used for positions, edges, and axes)
+struct Vec2 {
+	f32 x;
+	f32 y;
+};
+
+// oriented bounding box, stored as its 4 vertices in the winding order produced by TiltedRectVertices
+struct OBB {
+	Vec2 vertices[4];
+};
+
+// the interval a polygon takes up on an axis
+struct Interval {
+	f32 min;
+	f32 max;
 };
 
-// returns a 2d vector containing the vertices of a tilted rectangle (based on https://math.stackexchange.com/questions/2518607)
-std::vector<std::vector<f32>> TiltedRectVertices(TiltedRect* rect);
+// info regarding a collision between two polygons: the penetrating axis and the amount of overlap on it (overlap is 0 if there's no collision)
+struct Contact {
+	Vec2 axis;
+	f32 overlap;
+};
+
+// oriented bounding box, stored as its center, half width/height, and the unit vector along its width (the unit vector along its height is just the normal of that)
+// this is what the batched collision kernel works on, since it's cheaper to project than 4 vertices
+struct OrientedBox {
+	Vec2 center;
+	Vec2 halfExtents;
+	Vec2 axis;
+};
+
+// returns the half width/height of the axis aligned box around an oriented box
+Vec2 GetBoxBounds(const OrientedBox* box);
+
+// returns true if the axis aligned boxes around two centers (with the given half widths/heights) overlap; a cheap check to do before Collision
+bool BoundsOverlap(Vec2 center1, Vec2 bounds1, Vec2 center2, Vec2 bounds2);
+
+// returns the vertices of a tilted rectangle (based on https://math.stackexchange.com/questions/2518607)
+OBB TiltedRectVertices(const TiltedRect* rect);
+
+// returns the oriented box of a tilted rectangle
+OrientedBox TiltedRectBox(const TiltedRect* rect);
+
+// returns a sprite's oriented box
+OrientedBox GetOrientedBox(Sprite* sprite);
+
+// returns a quad's oriented box
+OrientedBox GetOrientedBox(Quad* quad);
 
 // returns a sprite's vertices
-std::vector<std::vector<f32>> GetVertices(Sprite* sprite);
+OBB GetVertices(Sprite* sprite);
 
 // returns a quad's vertices
-std::vector<std::vector<f32>> GetVertices(Quad* quad);
+OBB GetVertices(Quad* quad);
 
-// returns the dot product of two 2d vectors defined by f32 arrays
-f32 DotProduct(std::vector<f32> vector1, std::vector<f32> vector2);
+// returns the dot product of two 2d vectors
+f32 DotProduct(Vec2 vector1, Vec2 vector2);
 
 // returns the normalized version of the vector passed in by dividing each of its components by its magnitude
-std::vector<f32> NormalizeVector(std::vector<f32> vector);
+Vec2 NormalizeVector(Vec2 vector);
 
-// returns the 2 normal vectors to a vector
-std::vector<std::vector<f32>> GetNormalVectors(std::vector<f32> vector);
+// returns the first of the 2 normal vectors to a vector (the other is just its negation)
+Vec2 GetNormalVector(Vec2 vector);
 
-// returns an array of normalized edges given a polygon defined by an array of vertices
-std::vector<std::vector<f32>> GetEdgesFromVertices(std::vector<std::vector<f32>> vertices);
+// fills edges with the 4 normalized edges of an obb
+void GetEdgesFromVertices(const OBB* obb, Vec2 edges[4]);
 
-// returns an array of the normals to an array of edges (note: normal count will be double edge count, since a vertex has 2 normals in opposite directions)
-std::vector<std::vector<f32>> GetNormalsFromEdges(std::vector<std::vector<f32>> edges);
+// fills normals with one normal per edge (the opposite normals are skipped, since they'd just give the same axes in reverse)
+void GetNormalsFromEdges(const Vec2 edges[4], Vec2 normals[4]);
 
-// returns the interval that a polygon (defined by a set of vertices) takes up on a given axis
-std::vector<f32> GetIntervalOnAxis(std::vector<std::vector<f32>> vertices, std::vector<f32> axis);
+// returns the interval that an obb takes up on a given axis
+Interval GetIntervalOnAxis(const OBB* obb, Vec2 axis);
 
-// returns the overlap between two polygons (defined by sets of vertices) on a given axis
-f32 GetOverlapOnAxis(std::vector<std::vector<f32>> vertices1, std::vector<std::vector<f32>> vertices2, std::vector<f32> axis);
+// returns the overlap between two obbs on a given axis
+f32 GetOverlapOnAxis(const OBB* obb1, const OBB* obb2, Vec2 axis);
 
-// returns info (penetrating axis and amount on axis) regarding a collision (or the lack thereof) between two convex polygons (defined by sets of vertices)
-std::vector<f32> Collision(std::vector<std::vector<f32>> vertices1, std::vector<std::vector<f32>> vertices2);
+// returns info (penetrating axis and amount on axis) regarding a collision (or the lack thereof) between two obbs
+Contact Collision(const OBB* obb1, const OBB* obb2);
 
 // a few function overloads to make collision easy
-std::vector<f32> Collision(Sprite* collider1, Sprite* collider2);
-std::vector<f32> Collision(Sprite* collider1, Quad* collider2);
-std::vector<f32> Collision(Quad* collider1, Sprite* collider2);
-std::vector<f32> Collision(Quad* collider1, Quad* collider2);
+Contact Collision(Sprite* collider1, Sprite* collider2);
+Contact Collision(Sprite* collider1, Quad* collider2);
+Contact Collision(Quad* collider1, Sprite* collider2);
+Contact Collision(Quad* collider1, Quad* collider2);
+
+// returns the same info as Collision, but for two oriented boxes (only the 2 axes of each box are tested, since the other 2 are just their reverses)
+// the axis is never reversed, so the overlap is positive when box2 is on the far side of it; axis * overlap is the same push out as the vertex version's
+Contact Collision(const OrientedBox* box1, const OrientedBox* box2);
+
+// sweeps a circle from start along direction (a unit vector) for up to maxDistance, and returns true if it hits the box on the way
+// on a hit, distance is set to how far the circle got before touching the box and normal to the box's surface normal at the contact
+// (this is a ray cast against the box grown by the radius, with rounded corners, so it's exact; circles that start inside the box don't count as hits)
+bool SweepCircle(Vec2 start, Vec2 direction, f32 maxDistance, f32 radius, const OrientedBox* box, f32* distance, Vec2* normal);
 
 // returns true if layers 1 and 2 may be colliding (note: all the parameters are kinda gross but this lets me generalize it to all layers rather than, say, just sprites)
 bool CollisionPossible(Layer* layer1, Layer* layer2, f32 rotation1 = 0.0, f32 rotation2 = 0.0, f32 stretchX1 = 0.0, f32 stretchY1 = 0.0, f32 stretchX2 = 0.0, f32 stretchY2 = 0.0);
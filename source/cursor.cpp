@@ -1,21 +1,20 @@
 #include "cursor.h"
 using namespace wsp;
 
-int Cursor::Update(LayerManager* buttonManager) { // updates cursor and returns id of button pressed (0 if none)
-    ir_t ir;
-	WPAD_IR(player, &ir);
-	SetPosition(ir.sx-WSP_POINTER_CORRECTION_X, ir.sy-WSP_POINTER_CORRECTION_Y); // use sx and sy (s for smoothed) for best ir detection; sx/sy require offsets
+int Cursor::Update(const InputState* input, LayerManager* buttonManager) { // updates cursor and returns id of button pressed (0 if none)
+	const PlayerInput* playerInput = &input->players[player];
+	SetPosition(playerInput->pointerX, playerInput->pointerY); // the pointer position already has libwiisprite's offsets applied
 	Move(-((f32)GetWidth()/2), -((f32)GetHeight()/2)); // center by moving up/left by half cursor height/width
-	SetRotation(ir.angle/2); // set angle, must be divided by 2 to translate correctly
+	SetRotation(playerInput->pointerAngle/2); // set angle, must be divided by 2 to translate correctly
 	// check button selection
 	for (int i = 0; i < (int) buttonManager->GetSize(); i++) {
 		Button* button = (Button*) buttonManager->GetLayerAt(i);
 		if (CollisionPossible(this, button)) {
-			std::vector<f32> collision = Collision(this, button);
-			if (collision[2] != 0) {
+			Contact collision = Collision(this, button);
+			if (collision.overlap != 0) {
 				// there is a collision between cursor and button, so select button
 				button->Select();
-				if (WPAD_ButtonsDown(player) & WPAD_BUTTON_A) { // a is pressed, so press button
+				if (playerInput->down & BUTTON_A) { // a is pressed, so press button
 					return button->GetID();
 				}
 			}
@@ -24,12 +23,13 @@ int Cursor::Update(LayerManager* buttonManager) { // updates cursor and returns
 	return 0;
 }
 
-Cursor::Cursor(int player) {
+Cursor::Cursor(int player, TextureCache* textures) {
 	this->player = player;
-	// set image; the image contains 4 cursors, so use setframe to set it to the appropriate one for this player
-	Image* cursorImg = new Image();
-	cursorImg->LoadImage(cursors_png); // cursors_png is an image that comes from an image include
+	this->textures = textures;
+	// set image; the image contains 4 cursors, so use setframe to set it to the appropriate one for this player (every cursor shares one copy of it)
+	Image* cursorImg = textures->Acquire(TEXTURE_CURSORS);
 	SetImage(cursorImg, cursorImg->GetWidth()/4, cursorImg->GetHeight()); // image is a 4x1 of cursors
 	SetFrame(player);
 	DefineCollisionRectangle(0, 0, 4, 4); // the collision rectangle for cursors is small, as it's just at the fingertip
-}
\ No newline at end of file
+}
+Cursor::~Cursor() { textures->Release(TEXTURE_CURSORS); }
\ No newline at end of file
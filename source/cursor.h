@@ -4,10 +4,9 @@
 #include <stdlib.h>
 #include <gccore.h>
 #include <wiisprite.h>
-#include <wiiuse/wpad.h>
-
-#include "cursors_png.h"
 
+#include "platform.h"
+#include "texturecache.h"
 #include "button.h"
 #include "collision.h"
 
@@ -15,10 +14,13 @@ using namespace wsp;
 
 class Cursor : public Sprite {
 	public:
-		int Update(LayerManager* buttonManager);
-		Cursor(int player);
+		int Update(const InputState* input, LayerManager* buttonManager);
+		// the cursor shares its image from the given texture cache
+		Cursor(int player, TextureCache* textures);
+		~Cursor();
 	private:
 		int player;
+		TextureCache* textures;
 };
 
 #endif
\ No newline at end of file
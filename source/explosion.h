@@ -4,20 +4,23 @@
 #include <stdlib.h>
 #include <gccore.h>
 #include <wiisprite.h>
-#include <asndlib.h>
-#include <mp3player.h>
 
-#include "explosion_png.h"
-#include "explode_pcm.h"
+#include "platform.h"
+#include "audio.h"
+#include "pool.h"
+#include "texturecache.h"
 
 using namespace wsp;
 
-class Explosion : public Sprite {
+class Explosion : public Sprite, public Pooled<Explosion> {
 	public:
 		void Update(LayerManager* explosionManager);
         void Destroy(LayerManager* explosionManager);
-		Explosion(f32 x, f32 y);
+		// the explosion shares its image from the given texture cache, and posts its sound to the given queue (NULL for none)
+		Explosion(f32 x, f32 y, TextureCache* textures, SoundQueue* sounds);
+		~Explosion();
 	private:
+		TextureCache* textures;
 		int life;
 		int frameLength; // length of time in game frames for which each frame of the explosion animation should be played
 };
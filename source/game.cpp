@@ -0,0 +1,506 @@
+#include "game.h"
+#include "assetarchive.h"
+
+#include <sys/stat.h>
+
+using namespace wsp;
+
+// mixes a seed up into another one (murmur3's finalizer), for getting each game's seed from the last and each round's from its game's
+static u32 MixSeed(u32 seed) {
+	seed ^= seed >> 16;
+	seed *= 0x85ebca6b;
+	seed ^= seed >> 13;
+	seed *= 0xc2b2ae35;
+	seed ^= seed >> 16;
+	return seed;
+}
+
+// deletes every layer in a layer manager
+void ClearLayerManager(LayerManager* manager) {
+	while (true) {
+		Layer* layer = manager->GetLayerAt(0);
+		if (layer) {
+			manager->Remove(layer);
+			delete layer;
+		}
+		else break;
+	}
+}
+
+// runs however many simulation steps are due after the given amount of real time has passed (returns false if the game should exit after this frame)
+bool Game::Frame(const InputState* input, f64 seconds) {
+	int steps = AdvanceSimulationClock(&clock, seconds);
+	// button presses only go to one step (the first one this frame, or a later frame's first one if there isn't one this frame)
+	InputState stepInput = *input;
+	for (int player = 0; player < MAX_PLAYERS; player++) pendingDown[player] |= input->players[player].down;
+	bool running = true;
+	for (int step = 0; step < steps && running; step++) {
+		for (int player = 0; player < MAX_PLAYERS; player++) {
+			stepInput.players[player].down = pendingDown[player];
+			pendingDown[player] = 0;
+		}
+		running = Update(&stepInput);
+	}
+	PlaySounds();
+	return running;
+}
+
+// runs one simulation step given every player's input (returns false if the game should exit after this step)
+bool Game::Update(const InputState* input) {
+
+	// replays give their own input in place of the live input
+	InputState replayInput;
+	u32 replayHash = 0;
+	if (playback) {
+		if (!ReadReplayStep(playback, &replayInput, &replayHash)) return false; // the replay's over
+		input = &replayInput;
+	}
+	// bots press their players' buttons in place of whatever's there (before the step's recorded, so a replay plays a game with bots back without them)
+	InputState botInput;
+	if (bots.GetPlayers() && !playback && !inMenu && map) {
+		ProfileScope scope(profiler, PROFILE_BOTS);
+		botInput = *input;
+		bots.Update(&botInput, tankManager, map);
+		input = &botInput;
+	}
+	// a game that starts during this step is recorded from the next one (which is the first one it plays)
+	bool recordStep = recording;
+
+	// music (looped by starting it again whenever it's over)
+	UpdateMusic();
+	if (music && !IsMusicPlaying()) StartMusic();
+
+	// this is set to true when an exit condition is met to indicate that this will be the final frame
+	bool lastFrame = false;
+
+	// player inputs
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		// exit (home)
+		if (input->players[player].down & BUTTON_HOME) lastFrame = true;
+		// stop/start music (-)
+		if (input->players[player].down & BUTTON_MINUS) {
+			if (IsMusicPlaying()) {
+				music = false;
+				StopMusic();
+				musicStream->Close();
+			}
+			else {
+				music = true;
+			}
+		}
+		// go to menu (+)
+		if (!inMenu && input->players[player].down & BUTTON_PLUS) {
+			// play explosion sound and go to menu
+			sounds.Post(SOUND_EXPLOSION);
+			GoToMenu();
+		}
+	}
+
+	// menu bullet spawning
+	if (inMenu && !bullets->GetCount()) { // spawn a bullet when there are no more
+		f32 bulletRadius = 2.0;
+		f32 bulletSpeed = 2.0;
+		bullets->Spawn(0, logo->GetX() + 274, logo->GetY() + 32, HalfDegreesToAngle(135), bulletRadius, bulletSpeed); // 0 for no player, centered on turret in logo (arbitrary position), facing up
+	}
+
+	// once the round's decided, start making the next round's map in the background while the last explosion plays out
+	if (!inMenu && tankManager->GetSize() <= 1 && explosionManager->GetSize()) mapBuilder->Start(MixSeed(gameSeed + gameRound));
+
+	// new game if 1 or fewer tanks remain and all explosions have died
+	if (!inMenu && tankManager->GetSize() <= 1 && !explosionManager->GetSize()) {
+		if (map) EndRound(); // (there's no map when the game's just started, so no round to end)
+		NewRound();
+	}
+	if (!inMenu) roundStep++;
+
+	// slow mo if explosions exist (this is the one place the game's speed is set; everything that moves reads it from the clock)
+	clock.timeScale = explosionManager->GetSize() ? .5 : 1;
+
+	// remember where everything was before this step, for drawing in between steps
+	bullets->SavePoses();
+	for (int i = 0; i < (int) tankManager->GetSize(); i++) ((Tank*) tankManager->GetLayerAt(i))->SavePose();
+	spinnerPoses.resize(map && wallManager->GetSize() ? map->GetSpinningWalls() : 0);
+	for (int i = 0; i < (int) spinnerPoses.size(); i++) spinnerPoses[i] = GetPose((Quad*) wallManager->GetLayerAt(i));
+
+	// update rotating walls
+	{
+		ProfileScope scope(profiler, PROFILE_SPINNERS);
+		for (int i = 0; i < (int) spinnerPoses.size(); i++) {
+			Quad* spinningWall = (Quad*) wallManager->GetLayerAt(i);
+			f32 spinningWallSpeed = .5 * clock.timeScale;
+			spinningWall->SetRotation(AngleToHalfDegrees(HalfDegreesToAngle(spinningWall->GetRotation()) + HalfDegreesToAngle(spinningWallSpeed)));
+		}
+		if (map) map->UpdateWallGrid(wallManager);
+	}
+	WallGrid* wallGrid = map ? map->GetWallGrid() : NULL;
+
+	// update bullets (all at once)
+	{
+		ProfileScope scope(profiler, PROFILE_BULLETS);
+		stats.bounces += bullets->Update(clock.timeScale, wallGrid);
+	}
+
+	// update tanks: move them all, then find the bullets that might be hitting them (once, for every tank), test just those, and let the tanks that are left shoot
+	// (new bullets aren't tested until they've moved, since they start just inside their tank's turret)
+	{
+		ProfileScope scope(profiler, PROFILE_TANKS);
+		for (int i = 0; i < (int) tankManager->GetSize(); i++) ((Tank*) tankManager->GetLayerAt(i))->Update(input, clock.timeScale, wallGrid);
+		UpdateBroadphase(&broadphase, tankManager, bullets);
+		HitTanks(&broadphase, tankManager, bullets, explosionManager, stats.kills);
+		for (int i = 0; i < (int) tankManager->GetSize(); i++) {
+			if (((Tank*) tankManager->GetLayerAt(i))->Fire(input, bullets)) stats.shots++;
+		}
+	}
+
+	// update explosions (these play at full speed, since they're what causes the slow mo)
+	{
+		ProfileScope scope(profiler, PROFILE_EXPLOSIONS);
+		for (int i = 0; i < (int) explosionManager->GetSize(); i++) {
+			Explosion* explosion = (Explosion*) explosionManager->GetLayerAt(i);
+			explosion->Update(explosionManager);
+			if (!explosion) i--; // repeat index because object died
+		}
+	}
+
+	// update cursors and buttons (a round started from the menu counts as part of this)
+	{
+		ProfileScope scope(profiler, PROFILE_CURSORS);
+		// deselect buttons (re-selected if cursors are still hovering in cursor update)
+		for (int i = 0; i < (int) buttonManager->GetSize(); i++) {
+			((Button*) buttonManager->GetLayerAt(i))->Deselect();
+		}
+
+		// update cursors
+		for (int i = 0; i < (int) cursorManager->GetSize(); i++) {
+			int buttonPressed = ((Cursor*) cursorManager->GetLayerAt(i))->Update(input, buttonManager);
+			// press buttons on menu
+			if (inMenu) {
+				if (buttonPressed) sounds.Post(SOUND_SHOOT); // any: shoot sound
+				if (buttonPressed >= 1 && buttonPressed <= 3) { // buttons 1-3: start game
+					StartGame(buttonPressed + 1);
+				}
+				if (buttonPressed == 4) { // button 4: exit
+					lastFrame = true;
+				}
+			}
+		}
+	}
+
+	// record the step (or check it against the replay being played)
+	if (recordStep && recording) RecordReplayStep(&recordingReplay, input, GetStateHash());
+	if (playback && replayDivergence < 0 && GetStateHash() != replayHash) replayDivergence = playback->step - 1;
+	if (lastFrame) StopRecording();
+
+	return !lastFrame;
+
+}
+
+// adds a manager's sprites to a render queue part way between their poses from before the last step and now
+template <typename LayerType> static void AddInterpolated(RenderQueue* queue, RenderPass pass, LayerManager* manager, f32 interpolation) {
+	for (int i = 0; i < (int) manager->GetSize(); i++) {
+		LayerType* layer = (LayerType*) manager->GetLayerAt(i);
+		LayerPose current = GetPose(layer);
+		LayerPose pose = InterpolatePose(layer->GetPreviousPose(), &current, interpolation);
+		SetPose(layer, &pose);
+		queue->AddSprite(pass, layer); // the queue takes the quad it draws as, so the layer can go straight back
+		SetPose(layer, &current);
+	}
+}
+
+// streams the music from music.pcm or music.mp3 in the given directory (if one's there) instead of playing the track built into the game
+// (the directories are searched in the order they're given, the first time the music starts)
+void Game::StreamMusicFrom(const char* directory) { musicDirectories.push_back(directory); }
+
+// starts the music from the top: streamed from the first music file found, or else the track built in
+void Game::StartMusic() {
+	StopMusic();
+	musicStream->Close();
+	if (!musicSearched) {
+		static const char* names[] = {"music.pcm", "music.mp3"}; // pcm first, since the dsp plays it without any decoding
+		for (int i = 0; i < (int) musicDirectories.size() && musicPath.empty(); i++) {
+			for (int name = 0; name < 2 && musicPath.empty(); name++) {
+				std::string path = musicDirectories[i] + "/" + names[name];
+				struct stat info;
+				if (!stat(path.c_str(), &info)) musicPath = path;
+			}
+		}
+		musicSearched = true;
+	}
+	if (!musicPath.empty() && musicStream->Open(musicPath.c_str()) && PlayMusicStream(musicStream)) return;
+	musicStream->Close();
+	const AssetInfo* track;
+	const u8* mp3 = GetBuiltInAsset("music.mp3", &track);
+	PlayMusic(mp3, mp3 ? track->size : 0);
+}
+
+// plays the sounds the steps since the last call asked for (Frame does this after its steps)
+void Game::PlaySounds() { sounds.Play(); }
+
+// draws the game part way (0-1) between the last step and the one before it (it still has to be flushed to the screen)
+void Game::Draw(f32 interpolation) {
+	bool between = interpolation < 1;
+	renderQueue.AddSprite(RENDER_PASS_BACKGROUND, background, 0, 5); // background is drawn at y=5 because for some reason if it's drawn at (0, 0) it's 5 px above everything else
+	bullets->Draw(&renderQueue, interpolation);
+	if (inMenu) {
+		renderQueue.AddSprite(RENDER_PASS_MENU, logo);
+		renderQueue.AddSprites(RENDER_PASS_MENU, buttonManager);
+		renderQueue.AddSprites(RENDER_PASS_CURSORS, cursorManager);
+	}
+	else  {
+		// spinning walls only turn, so just their rotation is put in between
+		int spinnerCount = map ? std::min(map->GetSpinningWalls(), (int) wallManager->GetSize()) : 0;
+		for (int i = 0; i < spinnerCount; i++) {
+			Quad* spinningWall = (Quad*) wallManager->GetLayerAt(i);
+			LayerPose current = GetPose(spinningWall);
+			if (between && i < (int) spinnerPoses.size()) {
+				LayerPose pose = InterpolatePose(&spinnerPoses[i], &current, interpolation);
+				SetPose(spinningWall, &pose);
+			}
+			renderQueue.AddQuad(RENDER_PASS_WALLS, spinningWall);
+			SetPose(spinningWall, &current);
+		}
+		// the rest of the walls never move, so they're drawn from the display list made when the round started
+		if (staticWalls) renderQueue.AddDisplayList(RENDER_PASS_WALLS, staticWalls);
+		else renderQueue.AddQuads(RENDER_PASS_WALLS, wallManager, spinnerCount);
+		if (between) AddInterpolated<Tank>(&renderQueue, RENDER_PASS_TANKS, tankManager, interpolation);
+		else renderQueue.AddSprites(RENDER_PASS_TANKS, tankManager);
+		renderQueue.AddSprites(RENDER_PASS_EXPLOSIONS, explosionManager);
+	}
+	renderQueue.Flush();
+}
+
+// how far between steps the current frame is, for Draw
+f32 Game::GetInterpolation() { return GetSimulationInterpolation(&clock); }
+const SimulationClock* Game::GetClock() { return &clock; }
+
+// leaves the menu and starts a round with the given number of tanks (the round itself starts on the next update)
+void Game::StartGame(int tankCount) {
+	if (botMissingPlayers) SetBots(~GetConnectedPlayers() & ((1 << tankCount) - 1));
+	u32 seed = nextSeed;
+	nextSeed = MixSeed(nextSeed);
+	BeginGame(tankCount, seed);
+	if (!replayDirectory.empty()) {
+		StartReplayRecording(&recordingReplay, seed, tankCount, tankAmmo);
+		recording = true;
+	}
+}
+
+// leaves the menu and starts a game with the given number of tanks and seed
+void Game::BeginGame(int tankCount, u32 seed) {
+	this->tankCount = tankCount;
+	gameSeed = seed;
+	gameRound = 0;
+	inMenu = false;
+}
+
+// records every game from now on, saving each one (when it ends) as a replay named after its seed in the given directory
+void Game::RecordReplays(const char* directory) {
+	replayDirectory = directory;
+	mkdir(directory, 0777); // (fails harmlessly if it's already there)
+}
+
+// saves the game being recorded, if there is one
+void Game::StopRecording() {
+	if (!recording) return;
+	recording = false;
+	char path[32];
+	snprintf(path, sizeof(path), "/%08x.wtr", (unsigned int) recordingReplay.seed);
+	SaveReplay(&recordingReplay, (replayDirectory + path).c_str());
+}
+
+// starts playing a replay back in place of the input passed to Frame/Update, until it runs out (which ends the game, like exiting)
+bool Game::PlayReplay(Replay* replay) {
+	if (replay->ammo != tankAmmo || replay->tankCount < 1 || replay->tankCount > MAX_PLAYERS) return false; // the bullet system is sized for the ammo
+	GoToMenu();
+	RewindReplay(replay);
+	playback = replay;
+	replayDivergence = -1;
+	BeginGame(replay->tankCount, replay->seed);
+	return true;
+}
+
+bool Game::IsPlayingReplay() { return playback != NULL; }
+int Game::GetReplayDivergence() { return replayDivergence; }
+
+// a hash of everything that affects how the game plays out (see replay.h)
+u32 Game::GetStateHash() {
+	u32 hash = STATE_HASH_START;
+	hash = AddToStateHash(hash, (u32) inMenu);
+	hash = AddToStateHash(hash, (u32) gameRound);
+	hash = AddToStateHash(hash, (u32) tankManager->GetSize());
+	for (int i = 0; i < (int) tankManager->GetSize(); i++) {
+		Tank* tank = (Tank*) tankManager->GetLayerAt(i);
+		hash = AddToStateHash(hash, tank->GetX());
+		hash = AddToStateHash(hash, tank->GetY());
+		hash = AddToStateHash(hash, tank->GetRotation());
+	}
+	hash = bullets->HashState(hash);
+	hash = AddToStateHash(hash, (u32) explosionManager->GetSize());
+	for (int i = 0; i < (int) explosionManager->GetSize(); i++) hash = AddToStateHash(hash, (u32) ((Explosion*) explosionManager->GetLayerAt(i))->GetFrame());
+	for (int i = 0; map && i < map->GetSpinningWalls(); i++) hash = AddToStateHash(hash, ((Quad*) wallManager->GetLayerAt(i))->GetRotation());
+	return hash;
+}
+
+// ends the current round and goes back to the menu
+void Game::GoToMenu() {
+	StopRecording();
+	inMenu = true;
+	// delete all tanks, bullets, and explosions & reset map
+	ClearLayerManager(tankManager);
+	bullets->Clear();
+	ClearLayerManager(explosionManager);
+	if (map) {
+		map->Destroy(wallManager);
+		map = NULL;
+	};
+	FreeRenderDisplayList(staticWalls);
+	staticWalls = NULL;
+	mapBuilder->Cancel(); // the next round's map won't be needed
+}
+
+bool Game::InMenu() { return inMenu; }
+int Game::GetRoundCount() { return roundCount; }
+const GameStats* Game::GetStats() { return &stats; }
+Map* Game::GetMap() { return map; }
+const EntityPools* Game::GetPools() { return pools; }
+const TextureCache* Game::GetTextures() { return textures; }
+LayerManager* Game::GetTankManager() { return tankManager; }
+BulletSystem* Game::GetBullets() { return bullets; }
+LayerManager* Game::GetExplosionManager() { return explosionManager; }
+LayerManager* Game::GetWallManager() { return wallManager; }
+const MapBuilder* Game::GetMapBuilder() { return mapBuilder; }
+const SoundQueue* Game::GetSounds() { return &sounds; }
+const MusicStream* Game::GetMusicStream() { return musicStream; }
+const RenderQueue* Game::GetRenderQueue() { return &renderQueue; }
+void Game::SetProfiler(Profiler* profiler) { this->profiler = profiler; }
+void Game::SetBots(u32 players) { bots.SetPlayers(players); }
+void Game::BotMissingPlayers(bool enabled) { botMissingPlayers = enabled; }
+const BotPlayers* Game::GetBots() { return &bots; }
+
+// clears out the last round and starts a new one
+void Game::NewRound() {
+	// delete all tanks, bullets, and explosions
+	ClearLayerManager(tankManager);
+	bullets->Clear();
+	ClearLayerManager(explosionManager);
+	// reset map & spawn new tanks
+	if (map) map->Destroy(wallManager);
+	map = mapBuilder->Take(MixSeed(gameSeed + gameRound), &wallManager); // usually made already, while the last round's explosion played
+	gameRound++;
+	FreeRenderDisplayList(staticWalls);
+	staticWalls = CompileQuadLayers(wallManager, map->GetSpinningWalls(), wallManager->GetSize()); // every wall but the spinners stays put for the whole round
+#ifdef POOL_DEBUG
+	pools->Report();
+	textures->Report();
+#endif
+	map->SpawnTanks(tankCount, tankManager, tankAmmo, pools, textures, &sounds);
+	bots.Reset();
+	roundCount++;
+	roundStep = 0;
+}
+
+// adds the round that's just been decided to the stats (the tank that's left, if there is one, won it)
+void Game::EndRound() {
+	stats.rounds++;
+	stats.roundSteps += roundStep;
+	if (stats.rounds == 1 || roundStep < stats.shortestRound) stats.shortestRound = roundStep;
+	if (roundStep > stats.longestRound) stats.longestRound = roundStep;
+	if (tankManager->GetSize()) stats.wins[((Tank*) tankManager->GetLayerAt(0))->GetPlayer()]++;
+	else stats.draws++;
+}
+
+Game::Game(u32 screenWidth, u32 screenHeight, u32 seed, int tankAmmo) {
+	this->screenWidth = screenWidth;
+	this->screenHeight = screenHeight;
+	this->tankAmmo = tankAmmo; // tanks have 6 shots unless told otherwise
+
+	// a few constants for manager sizes/map creation
+	const int mapWidth = 8;
+	const int mapHeight = 6;
+	const int wallThickness = 8;
+
+	// decode every image up front, so nothing has to be decoded in the middle of a round (everything made from here on shares these)
+	textures = new TextureCache();
+	textures->Preload();
+
+	// create layer managers, and pools to make what goes in them from (sized the same way, so nothing is ever made that its manager can't hold)
+	int bulletLimit = MAX_PLAYERS * tankAmmo + 1; // max of (number of tanks)*ammo bullets on the map at once, plus one decorative bullet in the menu
+	int explosionLimit = MAX_PLAYERS; // one per tank
+	cursorManager = new LayerManager(MAX_PLAYERS);
+	tankManager = new LayerManager(MAX_PLAYERS);
+	bullets = new BulletSystem(bulletLimit, screenWidth, screenHeight, textures, &sounds);
+	ResetBroadphase(&broadphase, MAX_PLAYERS, bulletLimit);
+	explosionManager = new LayerManager(explosionLimit);
+	pools = new EntityPools(MAX_PLAYERS, explosionLimit);
+	int wallLimit = mapWidth * mapHeight * 2 + mapWidth + mapHeight; // north/west side of each cell (2wh), plus east/bottom borders (w+h)
+	wallManager = new LayerManager(wallLimit);
+	mapBuilder = new MapBuilder(screenWidth, screenHeight, mapWidth, mapHeight, wallThickness, wallLimit); // 8x6 maps w/ 8-pixel-thick walls that take up the whole screen
+	buttonManager = new LayerManager(4);
+	map = NULL;
+	staticWalls = NULL;
+
+	// create background & logo
+	background = new Sprite();
+	background->SetImage(textures->Acquire(TEXTURE_BACKGROUND));
+
+	logo = new Sprite();
+	logo->SetImage(textures->Acquire(TEXTURE_LOGO));
+	logo->SetPosition((screenWidth - logo->GetWidth()) / 2, 64); // arbitrary numbers for logo positioning
+
+	// create buttons
+	for (int i = 0; i < 4; i++) {
+		Button* button;
+		if (i == 0) button = new Button(i + 1, textures, TEXTURE_BTN_2_PLAYERS, TEXTURE_BTN_2_PLAYERS_OVER);
+		if (i == 1) button = new Button(i + 1, textures, TEXTURE_BTN_3_PLAYERS, TEXTURE_BTN_3_PLAYERS_OVER);
+		if (i == 2) button = new Button(i + 1, textures, TEXTURE_BTN_4_PLAYERS, TEXTURE_BTN_4_PLAYERS_OVER);
+		if (i == 3) button = new Button(i + 1, textures, TEXTURE_BTN_EXIT, TEXTURE_BTN_EXIT_OVER);
+		button->SetPosition(166, 192 + 68 * i); // arbitrary numbers for button positioning
+		buttonManager->Append(button);
+	}
+
+	// create cursors
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		cursorManager->Append(new Cursor(player, textures));
+	}
+
+	// initialize a few variables that will need to be kept between frames
+	inMenu = true;
+	music = true;
+	musicStream = new MusicStream();
+	musicSearched = false;
+	tankCount = 0;
+	roundCount = 0;
+	memset(&stats, 0, sizeof(stats));
+	roundStep = 0;
+	nextSeed = seed;
+	gameSeed = seed;
+	gameRound = 0;
+	recording = false;
+	playback = NULL;
+	replayDivergence = -1;
+	botMissingPlayers = false;
+	profiler = NULL;
+	InitSimulationClock(&clock);
+	for (int player = 0; player < MAX_PLAYERS; player++) pendingDown[player] = 0;
+}
+
+Game::~Game() {
+	GoToMenu();
+	ClearLayerManager(buttonManager);
+	ClearLayerManager(cursorManager);
+	delete cursorManager;
+	delete tankManager;
+	delete bullets;
+	delete explosionManager;
+	delete wallManager;
+	delete mapBuilder;
+	StopMusic(); // before the stream it might be playing goes
+	delete musicStream;
+	delete buttonManager;
+	delete pools; // after the managers are cleared, since that gives everything back to its pool
+	delete background;
+	textures->Release(TEXTURE_BACKGROUND);
+	delete logo;
+	textures->Release(TEXTURE_LOGO);
+	delete textures; // last, since everything above was using its images
+}
\ No newline at end of file
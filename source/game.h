@@ -0,0 +1,167 @@
+#ifndef TANK_GAME_H
+#define TANK_GAME_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+
+#include <vector>
+#include <string>
+
+#include "platform.h"
+#include "clock.h"
+#include "texturecache.h"
+#include "button.h"
+#include "cursor.h"
+#include "bulletsystem.h"
+#include "broadphase.h"
+#include "tank.h"
+#include "explosion.h"
+#include "map.h"
+#include "mapbuilder.h"
+#include "replay.h"
+#include "audio.h"
+#include "musicstream.h"
+#include "renderer.h"
+#include "profiler.h"
+#include "bots.h"
+
+using namespace wsp;
+
+// deletes every layer in a layer manager
+void ClearLayerManager(LayerManager* manager);
+
+// what's happened in the rounds played since the game was made (for tuning and regression testing: see host/batch.cpp)
+// a player's tank always starts in the same corner (see Map::SpawnTanks), so everything by player is also by spawn corner
+struct GameStats {
+	int rounds; // rounds that have been decided (down to one tank or none, with the explosions over)
+	u32 roundSteps; // steps those rounds took, in total
+	u32 shortestRound; // in steps
+	u32 longestRound;
+	int draws; // rounds that ended with no tanks left
+	int wins[MAX_PLAYERS];
+	u32 shots; // bullets fired by tanks
+	u32 bounces; // times bullets bounced off walls
+	u32 kills[MAX_PLAYERS][MAX_PLAYERS]; // tanks destroyed, by the player whose bullet did it and then the player whose tank it was
+};
+
+// the whole game (menu and rounds), independent of where its input comes from and where it's drawn, so the same code runs on the wii and headless on a pc
+class Game {
+	public:
+		// runs however many simulation steps are due after the given amount of real time has passed (returns false if the game should exit after this frame)
+		bool Frame(const InputState* input, f64 seconds);
+		// runs one simulation step given every player's input (returns false if the game should exit after this step)
+		// (the sounds it asks for are played by the next call to Frame or PlaySounds)
+		bool Update(const InputState* input);
+		// plays the sounds the steps since the last call asked for (Frame does this after its steps)
+		void PlaySounds();
+		// streams the music from music.pcm or music.mp3 in the given directory (if one's there) instead of playing the track built into the game
+		// (can be called for several directories, which are searched in order, the first time the music starts)
+		void StreamMusicFrom(const char* directory);
+		// draws the game part way (0-1) between the last step and the one before it (it still has to be flushed to the screen)
+		void Draw(f32 interpolation = 1);
+		// how far between steps the current frame is, for Draw
+		f32 GetInterpolation();
+		const SimulationClock* GetClock();
+		// leaves the menu and starts a round with the given number of tanks (what the player count buttons do)
+		void StartGame(int tankCount);
+		// records every game from now on, saving each one (when it ends) as a replay named after its seed in the given directory
+		void RecordReplays(const char* directory);
+		// starts playing a replay back in place of the input passed to Frame/Update, until it runs out (which ends the game, like exiting)
+		// (returns false if the replay can't be played, which is when it was recorded with different ammo)
+		bool PlayReplay(Replay* replay);
+		bool IsPlayingReplay();
+		// the first step of the replay being played back where the game's state didn't match the recording (-1 if it's matched so far)
+		int GetReplayDivergence();
+		// a hash of everything that affects how the game plays out (see replay.h)
+		u32 GetStateHash();
+		// ends the current round and goes back to the menu
+		void GoToMenu();
+		bool InMenu();
+		// number of rounds that have been started
+		int GetRoundCount();
+		const GameStats* GetStats();
+		Map* GetMap();
+		const EntityPools* GetPools();
+		const TextureCache* GetTextures();
+		LayerManager* GetTankManager();
+		BulletSystem* GetBullets();
+		LayerManager* GetExplosionManager();
+		LayerManager* GetWallManager();
+		const MapBuilder* GetMapBuilder();
+		// what's happened to the sounds the game's asked for
+		const SoundQueue* GetSounds();
+		// the music being streamed (which isn't open if the music's the track built in)
+		const MusicStream* GetMusicStream();
+		// what the last Draw drew (how many batches, texture changes and quads)
+		const RenderQueue* GetRenderQueue();
+		// times each part of every step from now on in the profiler's current frame (NULL to stop)
+		void SetProfiler(Profiler* profiler);
+		// sets which players the computer plays (a bit for each player; their own input's ignored while they're bots, but can be changed at any time)
+		void SetBots(u32 players);
+		// has each game started from the menu give the tanks of players without a controller to bots (decided once as it starts, so a controller
+		// dropping out part way through doesn't hand a tank over)
+		void BotMissingPlayers(bool enabled);
+		// the bots, and what they've cost
+		const BotPlayers* GetBots();
+		// every game's maps come from the seed, so the same seed and inputs always play out the same
+		// tanks get tankAmmo shots each (the bullet system is sized to fit all of them, so it can be raised as far as memory allows)
+		Game(u32 screenWidth, u32 screenHeight, u32 seed, int tankAmmo = 6);
+		~Game();
+	private:
+		u32 screenWidth;
+		u32 screenHeight;
+		int tankAmmo;
+		LayerManager* cursorManager;
+		LayerManager* tankManager;
+		BulletSystem* bullets;
+		Broadphase broadphase; // finds which bullets might be hitting which tanks each step
+		BotPlayers bots; // the computer players (none unless SetBots says so)
+		bool botMissingPlayers; // set by BotMissingPlayers
+		LayerManager* explosionManager;
+		LayerManager* wallManager;
+		LayerManager* buttonManager;
+		Map* map;
+		MapBuilder* mapBuilder; // makes each round's map (in the background, while the round before it ends)
+		EntityPools* pools;
+		TextureCache* textures; // every sprite's image comes from here
+		Sprite* background;
+		Sprite* logo;
+		bool inMenu; // indicates whether or not the menu is active (false if game is being played)
+		bool music; // indicates whether music should be played
+		MusicStream* musicStream; // what the music's streamed through, when it's from a file
+		std::vector<std::string> musicDirectories; // where to look for a music file
+		bool musicSearched; // whether the directories have been searched yet
+		std::string musicPath; // the music file that was found (empty if none was, so the music's the track built in)
+		int tankCount; // number of tanks to be spawned at the beginning of each game (defaults to 0 but must be selected on the menu before any games are started)
+		int roundCount;
+		u32 nextSeed; // seed for the next game
+		u32 gameSeed; // seed for the current game (each round's map seed comes from this and the round number)
+		int gameRound; // rounds started in the current game
+		std::string replayDirectory; // where to save replays (empty if games aren't being recorded)
+		bool recording;
+		Replay recordingReplay;
+		Replay* playback; // replay being played back (NULL if none)
+		int replayDivergence;
+		Profiler* profiler; // NULL if steps aren't being profiled
+		SimulationClock clock;
+		u32 pendingDown[MAX_PLAYERS]; // button presses that haven't been given to a step yet
+		std::vector<LayerPose> spinnerPoses; // spinning walls' poses from before the last step
+		SoundQueue sounds; // every sound effect's posted to this, and played once a frame
+		RenderQueue renderQueue; // everything's drawn through this
+		RenderDisplayList* staticWalls; // every wall but the spinners, compiled when the round started (NULL in the menu, or if it couldn't be compiled)
+		GameStats stats;
+		u32 roundStep; // steps the current round has taken
+		// adds the round that's just been decided to the stats
+		void EndRound();
+		// clears out the last round and starts a new one
+		void NewRound();
+		// starts the music from the top
+		void StartMusic();
+		// leaves the menu and starts a game with the given number of tanks and seed
+		void BeginGame(int tankCount, u32 seed);
+		// saves the game being recorded, if there is one
+		void StopRecording();
+};
+
+#endif
\ No newline at end of file
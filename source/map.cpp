@@ -1,31 +1,7 @@
 #include "map.h"
+#include <math.h>
 using namespace wsp;
 
-// recursive backtracking algorithm for maze generation
-std::vector<std::vector<MazeCell>> RecursiveBacktrackingMaze(int row, int column, std::vector<std::vector<MazeCell>> maze, std::default_random_engine rng) {
-	maze[row][column].visited = true;
-	char directions[4] = {'n', 's', 'e', 'w'};
-	std::shuffle(std::begin(directions), std::end(directions), rng);
-	for (int i = 0; i < 4; i++) { // go in each direction
-		char dir = directions[i];
-		int x = column;
-		int y = row;
-		if (dir == 'n') y--;
-		if (dir == 's') y++;
-		if (dir == 'e') x++;
-		if (dir == 'w') x--;
-		if (y >= 0 && y < (int) maze.size() && x >= 0 && x < (int) maze[0].size() && !maze[y][x].visited) { // if the neighbor is an unvisited cell in bounds
-			// update edges and then call again for the new cell
-			if (dir == 'n') maze[y + 1][x].north = false;
-			if (dir == 's') maze[y][x].north = false;
-			if (dir == 'e') maze[y][x].west = false;
-			if (dir == 'w') maze[y][x + 1].west = false;
-			maze = RecursiveBacktrackingMaze(y, x, maze, rng);
-		}
-	}
-	return maze;
-}
-
 int Map::GetSpinningWalls() { return spinningWallCount; }
 // delete the map and clear out the wall manager if one is supplied
 void Map::Destroy(LayerManager* wallManager) {
@@ -41,10 +17,24 @@ void Map::Destroy(LayerManager* wallManager) {
 void Map::GenerateWalls(LayerManager* wallManager) {
 	AddSpinners(wallManager);
 	AddWallsFromCells(wallManager);
+	// index the walls by cell (one extra row/column for the south/east borders)
+	BuildWallGrid(&wallGrid, wallManager, spinningWallCount, width + 1, height + 1, cellWidth, cellHeight);
 }
-void Map::SpawnTanks(int tankCount, LayerManager* tankManager, int ammo) {
+// returns the spatial index of the walls made by GenerateWalls
+WallGrid* Map::GetWallGrid() { return &wallGrid; }
+const Maze* Map::GetMaze() { return &maze; }
+MazeDistances* Map::GetMazeDistances() { return &mazeDistances; }
+int Map::GetWidth() { return width; }
+int Map::GetHeight() { return height; }
+f32 Map::GetCellWidth() { return cellWidth; }
+f32 Map::GetCellHeight() { return cellHeight; }
+int Map::GetWallThickness() { return wallThickness; }
+// updates the wall grid after the spinning walls have rotated
+void Map::UpdateWallGrid(LayerManager* wallManager) { UpdateWallGridSpinners(&wallGrid, wallManager); }
+void Map::SpawnTanks(int tankCount, LayerManager* tankManager, int ammo, EntityPools* pools, TextureCache* textures, SoundQueue* sounds) {
 	for (int player = 0; player < tankCount; player++) {
-		Tank* tank = new Tank(player, ammo);
+		Tank* tank = new (&pools->tanks) Tank(player, ammo, pools, textures, sounds);
+		if (!tank) break; // no room (can't happen as long as the pool is sized for every player)
 		// set initial tank positions (1 in each corner)
 		f32 tankXOffset = (cellWidth - tank->GetWidth() + wallThickness) / 2;
 		f32 tankYOffset = (cellHeight - tank->GetHeight() + wallThickness) / 2;
@@ -57,42 +47,31 @@ void Map::SpawnTanks(int tankCount, LayerManager* tankManager, int ammo) {
 		tankManager->Append(tank);
 	}
 }
-Map::Map(int screenWidth, int screenHeight, int width, int height, int wallThickness) {
+Map::Map(int screenWidth, int screenHeight, int width, int height, int wallThickness, u32 seed) {
 	this->width = width;
 	this->height = height;
 	this->wallThickness = wallThickness;
 	this->cellWidth = (screenWidth - wallThickness) / (f32) width;
 	this->cellHeight = (screenHeight - wallThickness) / (f32) height;
 	this->spinningWallCount = 0;
-	this->rng = std::default_random_engine(time(NULL)); // rng w/ current time (updates each second) as seed
-	// initialize and generate a 2d vector w/ a maze
-	std::vector<std::vector<MazeCell>> maze(height, std::vector<MazeCell>(width));
-	for (int row = 0; row < height; row++) {
-		for (int column = 0; column < width; column++) {
-			maze[row][column].visited = false;
-			maze[row][column].north = true;
-			maze[row][column].west = true;
-		}
-	}
-	cells = RecursiveBacktrackingMaze(0, 0, maze, rng);
-	// open up the maze a little and create the walls
-	OpenUp();
-}
-void Map::OpenUp() {
-	// deletes some walls to make the map more open
-	for (int row = 0; row < height; row++) {
-		for (int column = 0; column < width; column++) {
-			// for each cell, there's a 1/4 chance to take away the north side and a 1/4 chance to take away the west side
-			if (!(rng() % 4) && row) cells[row][column].north = false;
-			if (!(rng() % 4) && column) cells[row][column].west = false;
-		}
-	}
+	this->unmergedWallCount = 0;
+	BuildWallGrid(&wallGrid, NULL, 0, width + 1, height + 1, cellWidth, cellHeight); // empty until GenerateWalls
+	SeedRandom(&rng, seed);
+	// generate a maze
+	InitMaze(&maze, width, height);
+	GenerateMaze(&maze, &rng);
+	// open up the maze a little (each inside wall has a 1/4 chance of going)
+	OpenUpMaze(&maze, &rng);
+	ResetMazeDistances(&mazeDistances, width * height); // nothing's searched until the bots need it
 }
 void Map::AddSpinners(LayerManager* wallManager) {
-	// adds spinning walls
+	// adds spinning walls (each open 2x2 of cells has a 1/4 chance of getting one)
+	std::vector<u64> corners(maze.rowWords * height);
+	FindOpenCorners(&maze, &corners[0]);
 	for (int y = 1; y < height; y++) {
-		for (int x = 1; x < width; x++) {
-			if (!(rng() % 4) && !cells[y][x].north && !cells[y][x].west && !cells[y][x - 1].north && !cells[y - 1][x].west) { // if an open 2x2 of cells, 1/4 chance to add
+		for (int word = 0; word < maze.rowWords; word++) {
+			for (u64 chosen = corners[y * maze.rowWords + word] & RandomQuarterBits(&rng); chosen; chosen &= chosen - 1) {
+				int x = word * 64 + __builtin_ctzll(chosen);
 				spinningWallCount++;
 				Quad* wall = CreateWall(wallManager);
 				wall->SetHeight(wallThickness);
@@ -100,30 +79,49 @@ void Map::AddSpinners(LayerManager* wallManager) {
 				int wallX = cellWidth * x - wall->GetWidth() / 2 + wallThickness / 2;
 				int wallY = cellHeight * y - wall->GetHeight() / 2 + wallThickness / 2;
 				wall->SetPosition(wallX, wallY);
-				wall->SetRotation(rng() % 180);
+				wall->SetRotation(RandomBelow(&rng, 180));
 			}
 		}
 	}
 }
 void Map::AddWallsFromCells(LayerManager* wallManager) {
-	// creates the walls
+	// creates the walls, merging each run of edges in a line into one long wall (so there are fewer to draw and test, and no seams between them for bullets to catch on)
+	unmergedWallCount = spinningWallCount;
+	// north side of each cell & south border (the whole bottom edge)
 	for (int row = 0; row <= height; row++) {
-		for (int column = 0; column <= width; column++) {
-			if ((row < height && column < width && cells[row][column].north) || (row == height && column < width)) { // north side of each cell & south border
-				Quad* wall = CreateWall(wallManager);
-				wall->SetPosition(cellWidth * column, cellHeight * row);
-				wall->SetHeight(wallThickness);
-				wall->SetWidth(cellWidth + wallThickness - 1);
+		for (int column = 0; column < width;) {
+			if (row < height && !MazeNorth(&maze, column, row)) {
+				column++;
+				continue;
 			}
-			if ((row < height && column < width && cells[row][column].west) || (row < height && column == width)) { // west side of each cell & east border
-				Quad* wall = CreateWall(wallManager);
-				wall->SetPosition(cellWidth * column, cellHeight * row);
-				wall->SetWidth(wallThickness);
-				wall->SetHeight(cellWidth + wallThickness - 1);
+			int first = column;
+			while (column < width && (row == height || MazeNorth(&maze, column, row))) column++;
+			Quad* wall = CreateWall(wallManager);
+			wall->SetPosition(cellWidth * first, cellHeight * row);
+			wall->SetHeight(wallThickness);
+			wall->SetWidth(ceilf(cellWidth * (column - first - 1) + cellWidth + wallThickness - 1)); // as far as the last edge in the run would've gone
+			unmergedWallCount += column - first;
+		}
+	}
+	// west side of each cell & east border (the whole right edge)
+	for (int column = 0; column <= width; column++) {
+		for (int row = 0; row < height;) {
+			if (column < width && !MazeWest(&maze, column, row)) {
+				row++;
+				continue;
 			}
+			int first = row;
+			while (row < height && (column == width || MazeWest(&maze, column, row))) row++;
+			Quad* wall = CreateWall(wallManager);
+			wall->SetPosition(cellWidth * column, cellHeight * first);
+			wall->SetWidth(wallThickness);
+			wall->SetHeight(ceilf(cellHeight * (row - first - 1) + cellHeight + wallThickness - 1)); // as far as the last edge in the run would've gone
+			unmergedWallCount += row - first;
 		}
 	}
 }
+// number of walls (including spinners) there'd be if each cell edge was its own wall, for comparing with how many there are after merging
+int Map::GetUnmergedWallCount() { return unmergedWallCount; }
 // makes a stylized wall quad
 Quad* Map::CreateWall(LayerManager* wallManager) {
 	Quad* wall = new Quad();
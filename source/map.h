@@ -5,43 +5,52 @@
 #include <gccore.h>
 #include <wiisprite.h>
 #include <vector>
-#include <time.h>
-#include <algorithm>
-#include <random>
 
 #include "tank.h"
+#include "wallgrid.h"
+#include "maze.h"
+#include "random.h"
 
 using namespace wsp;
 
-// contains info about a cell in a maze, used for map generation; only north and west edges are described since the adjacent cells will have info about the other edges
-struct MazeCell {
-	bool visited;
-	bool north;
-	bool west;
-};
-
-// recursive backtracking algorithm for maze generation
-std::vector<std::vector<MazeCell>> RecursiveBacktrackingMaze(int row, int column, std::vector<std::vector<MazeCell>> maze, std::default_random_engine rng);
-
 class Map {
 	public:
 	 	int GetSpinningWalls();
+		// number of walls (including spinners) there'd be if each cell edge was its own wall (GenerateWalls merges edges in a line into one wall)
+		int GetUnmergedWallCount();
 		// delete the map and clear out the wall manager if one is supplied
 		void Destroy(LayerManager* wallManager = NULL);
 		// turn the map data into physical walls
 		void GenerateWalls(LayerManager* wallManager);
-		void SpawnTanks(int tankCount, LayerManager* tankManager, int ammo);
-	 	Map(int screenWidth, int screenHeight, int width, int height, int wallThickness);
+		// makes tanks from the given pools (their explosions come from there too), with images from the given texture cache and sounds going to the given queue
+		void SpawnTanks(int tankCount, LayerManager* tankManager, int ammo, EntityPools* pools, TextureCache* textures, SoundQueue* sounds);
+		// returns the spatial index of the walls made by GenerateWalls
+		WallGrid* GetWallGrid();
+		// updates the wall grid after the spinning walls have rotated
+		void UpdateWallGrid(LayerManager* wallManager);
+		// the maze the walls were made from, and the shortest paths through it (each target's worked out the first time it's asked for, with GetMazeField, and kept for the whole round)
+		const Maze* GetMaze();
+		MazeDistances* GetMazeDistances();
+		// size in cells, and of each cell on screen (cell (x, y)'s walls are centered on the lines cellWidth * x + wallThickness / 2 and cellHeight * y + wallThickness / 2)
+		int GetWidth();
+		int GetHeight();
+		f32 GetCellWidth();
+		f32 GetCellHeight();
+		int GetWallThickness();
+	 	// the same seed always makes the same map
+	 	Map(int screenWidth, int screenHeight, int width, int height, int wallThickness, u32 seed);
 	private:
-	 	std::vector<std::vector<MazeCell>> cells;
+	 	Maze maze;
+		MazeDistances mazeDistances;
 		int width;
 		int height;
 		f32 cellWidth;
 		f32 cellHeight;
 		int wallThickness;
 		int spinningWallCount;
-		std::default_random_engine rng;
-		void OpenUp();
+		int unmergedWallCount;
+		Random rng;
+		WallGrid wallGrid;
 		void AddSpinners(LayerManager* wallManager);
 		void AddWallsFromCells(LayerManager* wallManager);
 		Quad* CreateWall(LayerManager* wallManager);
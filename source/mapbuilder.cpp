@@ -0,0 +1,80 @@
+#include "mapbuilder.h"
+using namespace wsp;
+
+// starts making the map with the given seed in the background (does nothing if it's already being made)
+void MapBuilder::Start(u32 seed) {
+	if (pending && this->seed == seed) return;
+	Cancel();
+	this->seed = seed;
+	pending = true;
+	finished.store(false, std::memory_order_relaxed);
+	thread = StartBackgroundThread(BuildInBackground, this);
+	if (!thread) Build(); // no thread, so just make it now
+}
+
+// returns the map with the given seed, with its walls in *wallManager
+Map* MapBuilder::Take(u32 seed, LayerManager** wallManager) {
+	if (pending && this->seed == seed) {
+		if (finished.load(std::memory_order_acquire)) readyCount++;
+		else waitCount++;
+		if (thread) JoinBackgroundThread(thread); // returns straight away if it's done
+		thread = NULL;
+	}
+	else {
+		// it was never started (or a different map was), so make it here
+		Cancel();
+		synchronousCount++;
+		this->seed = seed;
+		Build();
+	}
+	Map* taken = map;
+	map = NULL;
+	pending = false;
+	LayerManager* emptyWalls = *wallManager;
+	*wallManager = walls;
+	walls = emptyWalls;
+	return taken;
+}
+
+// throws away the map being made, if there is one
+void MapBuilder::Cancel() {
+	if (thread) JoinBackgroundThread(thread);
+	thread = NULL;
+	if (map) map->Destroy(walls);
+	map = NULL;
+	pending = false;
+}
+
+int MapBuilder::GetReadyCount() const { return readyCount; }
+int MapBuilder::GetWaitCount() const { return waitCount; }
+int MapBuilder::GetSynchronousCount() const { return synchronousCount; }
+
+// makes the map: the maze (made by its constructor), then the walls and the grid over them
+void MapBuilder::Build() {
+	map = new Map(screenWidth, screenHeight, width, height, wallThickness, seed);
+	map->GenerateWalls(walls);
+	finished.store(true, std::memory_order_release);
+}
+
+void MapBuilder::BuildInBackground(void* builder) { ((MapBuilder*) builder)->Build(); }
+
+MapBuilder::MapBuilder(int screenWidth, int screenHeight, int width, int height, int wallThickness, int wallCapacity) : finished(false) {
+	this->screenWidth = screenWidth;
+	this->screenHeight = screenHeight;
+	this->width = width;
+	this->height = height;
+	this->wallThickness = wallThickness;
+	walls = new LayerManager(wallCapacity);
+	map = NULL;
+	seed = 0;
+	pending = false;
+	thread = NULL;
+	readyCount = 0;
+	waitCount = 0;
+	synchronousCount = 0;
+}
+
+MapBuilder::~MapBuilder() {
+	Cancel();
+	delete walls;
+}
\ No newline at end of file
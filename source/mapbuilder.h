@@ -0,0 +1,55 @@
+#ifndef TANK_MAPBUILDER_H
+#define TANK_MAPBUILDER_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+#include <atomic>
+
+#include "platform.h"
+#include "map.h"
+
+using namespace wsp;
+
+// makes maps (maze, walls and wall grid) ahead of time on a background thread, so starting a round only has to swap in walls that are already made
+// each map is made in the builder's own spare wall manager, which is swapped with the game's when the map's taken; if the map isn't ready by then,
+// it's finished (or made from scratch) right there instead, so a round always gets the map its seed says, however long the thread takes
+class MapBuilder {
+	public:
+		// starts making the map with the given seed in the background (does nothing if it's already being made)
+		void Start(u32 seed);
+		// returns the map with the given seed, with its walls in *wallManager (which must be empty; it's swapped with the one the walls were made in)
+		Map* Take(u32 seed, LayerManager** wallManager);
+		// throws away the map being made, if there is one
+		void Cancel();
+		// how many maps were taken ready made, were still being made (so had to be waited for), or weren't started (so were made on the spot)
+		int GetReadyCount() const;
+		int GetWaitCount() const;
+		int GetSynchronousCount() const;
+		// the maps are made to fit a screen of the given size, with the given number of cells and wall thickness (wallCapacity is the most walls one can have)
+		MapBuilder(int screenWidth, int screenHeight, int width, int height, int wallThickness, int wallCapacity);
+		~MapBuilder();
+	private:
+		int screenWidth;
+		int screenHeight;
+		int width;
+		int height;
+		int wallThickness;
+		LayerManager* walls; // where the next map's walls are made
+		bool pending; // whether a map's being made (or is made and waiting to be taken)
+		u32 seed; // its seed
+		Map* map; // the map (only touched by the thread making it until it's joined)
+		BackgroundThread* thread; // thread making it (NULL if it's being made on the spot)
+		std::atomic<bool> finished; // set by the thread once the map's done
+		int readyCount;
+		int waitCount;
+		int synchronousCount;
+		// makes the map (on whichever thread)
+		void Build();
+		static void BuildInBackground(void* builder);
+		// the builder owns its thread and spare walls, so it can't be copied
+		MapBuilder(const MapBuilder&);
+		MapBuilder& operator=(const MapBuilder&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "maze.h"
+#include <algorithm>
+
+// mask of the bits in a row's word that are inside the maze
+static u64 RowWordMask(const Maze* maze, int word) {
+	int bits = maze->width - word * 64;
+	return bits >= 64 ? ~(u64) 0 : ((u64) 1 << bits) - 1;
+}
+
+// sets the maze to the given size with every wall up and nothing visited
+void InitMaze(Maze* maze, int width, int height) {
+	maze->width = width;
+	maze->height = height;
+	maze->rowWords = (width + 63) / 64;
+	maze->north.assign(maze->rowWords * height, 0);
+	maze->west.assign(maze->rowWords * height, 0);
+	maze->visited.assign(maze->rowWords * height, 0);
+	for (int y = 0; y < height; y++) {
+		for (int word = 0; word < maze->rowWords; word++) {
+			maze->north[y * maze->rowWords + word] = RowWordMask(maze, word);
+			maze->west[y * maze->rowWords + word] = RowWordMask(maze, word);
+		}
+	}
+}
+
+// steps to each neighbor (n, s, e, w)
+static const int neighborX[4] = {0, 0, 1, -1};
+static const int neighborY[4] = {-1, 1, 0, 0};
+
+// carves a maze by iterative backtracking from the given cell
+void GenerateMaze(Maze* maze, Random* random, int startX, int startY) {
+	maze->stack.clear();
+	maze->stack.reserve(maze->width * maze->height);
+	maze->visited[MazeWord(maze, startX, startY)] |= MazeBit(startX);
+	maze->stack.push_back(startY << 16 | startX);
+	while (!maze->stack.empty()) {
+		int x = maze->stack.back() & 0xffff;
+		int y = maze->stack.back() >> 16;
+		// find the unvisited neighbors (n, s, e, w)
+		int directions[4];
+		int count = 0;
+		for (int dir = 0; dir < 4; dir++) {
+			int neighborColumn = x + neighborX[dir];
+			int neighborRow = y + neighborY[dir];
+			directions[count] = dir;
+			count += neighborColumn >= 0 && neighborColumn < maze->width && neighborRow >= 0 && neighborRow < maze->height
+				&& !(maze->visited[MazeWord(maze, neighborColumn, neighborRow)] & MazeBit(neighborColumn));
+		}
+		if (!count) { // dead end, so back up
+			maze->stack.pop_back();
+			continue;
+		}
+		// knock down the wall to a random one of them and move there (the wall between is on the north/west side of whichever of the two cells is further south/east)
+		int dir = directions[RandomBelow(random, count)];
+		int nextX = x + neighborX[dir];
+		int nextY = y + neighborY[dir];
+		int wallX = std::max(x, nextX);
+		int wallY = std::max(y, nextY);
+		std::vector<u64>* walls = dir < 2 ? &maze->north : &maze->west;
+		(*walls)[MazeWord(maze, wallX, wallY)] &= ~MazeBit(wallX);
+		maze->visited[MazeWord(maze, nextX, nextY)] |= MazeBit(nextX);
+		maze->stack.push_back(nextY << 16 | nextX);
+	}
+}
+
+// removes each inside north/west wall with a 1/4 chance, to make the maze more open
+void OpenUpMaze(Maze* maze, Random* random) {
+	for (int y = 0; y < maze->height; y++) {
+		for (int word = 0; word < maze->rowWords; word++) {
+			int index = y * maze->rowWords + word;
+			u64 inside = RowWordMask(maze, word);
+			// the top row's north walls and the left column's west walls are the border, so they stay
+			if (y) maze->north[index] &= ~(RandomQuarterBits(random) & inside);
+			maze->west[index] &= ~(RandomQuarterBits(random) & inside & (word ? ~(u64) 0 : ~(u64) 1));
+		}
+	}
+}
+
+// fills cells with the cells whose north west corner is the middle of an open 2x2 of cells, and returns how many there are
+int FindOpenCorners(const Maze* maze, u64* cells) {
+	int count = 0;
+	for (int word = 0; word < maze->rowWords; word++) cells[word] = 0; // the top row's corners are on the border
+	for (int y = 1; y < maze->height; y++) {
+		for (int word = 0; word < maze->rowWords; word++) {
+			int index = y * maze->rowWords + word;
+			// a corner is open when the cell's north and west walls, the north wall of the cell to its west, and the west wall of the cell to its north are all down
+			u64 westNorth = (maze->north[index] << 1) | (word ? maze->north[index - 1] >> 63 : 0);
+			u64 walls = maze->north[index] | maze->west[index] | westNorth | maze->west[index - maze->rowWords];
+			cells[index] = ~walls & RowWordMask(maze, word) & (word ? ~(u64) 0 : ~(u64) 1);
+			count += __builtin_popcountll(cells[index]);
+		}
+	}
+	return count;
+}
+
+// returns true if there's no wall between a cell and its neighbor in the given direction (the outside edges are always walls)
+bool MazeOpen(const Maze* maze, int x, int y, int direction) {
+	int neighborCellX = x + neighborX[direction];
+	int neighborCellY = y + neighborY[direction];
+	if (neighborCellX < 0 || neighborCellY < 0 || neighborCellX >= maze->width || neighborCellY >= maze->height) return false;
+	// only north and west edges are kept, so a south or east edge is the neighbor's north or west one
+	if (direction == MAZE_NORTH) return !GetMazeCell(maze, x, y).north;
+	if (direction == MAZE_WEST) return !GetMazeCell(maze, x, y).west;
+	if (direction == MAZE_SOUTH) return !GetMazeCell(maze, neighborCellX, neighborCellY).north;
+	return !GetMazeCell(maze, neighborCellX, neighborCellY).west;
+}
+
+// forgets every field, ready for a maze with the given number of cells (the fields' memory is kept for the next map)
+void ResetMazeDistances(MazeDistances* distances, int cells) {
+	distances->cells = cells;
+	distances->fields.assign(cells, -1);
+	distances->steps.clear();
+	distances->directions.clear();
+	distances->steps.reserve(cells * MAX_PLAYERS);
+	distances->directions.reserve(cells * MAX_PLAYERS);
+	distances->queue.resize(cells);
+	distances->searches = 0;
+}
+
+// returns where target's field starts, searching for it first if it hasn't been (a breadth first search out from the target, so cells work)
+int GetMazeField(MazeDistances* distances, const Maze* maze, int target) {
+	if (distances->fields[target] >= 0) return distances->fields[target];
+	int cells = distances->cells;
+	int field = distances->steps.size();
+	distances->fields[target] = field;
+	distances->searches++;
+	distances->steps.resize(field + cells, MAZE_UNREACHABLE);
+	distances->directions.resize(field + cells, MAZE_NOWHERE);
+	u16* steps = &distances->steps[field];
+	u8* directions = &distances->directions[field];
+	int* queue = &distances->queue[0];
+	int queueStart = 0;
+	int queueEnd = 0;
+	steps[target] = 0;
+	queue[queueEnd++] = target;
+	while (queueStart < queueEnd) {
+		int cell = queue[queueStart++];
+		int x = cell % maze->width;
+		int y = cell / maze->width;
+		for (int direction = 0; direction < 4; direction++) {
+			if (!MazeOpen(maze, x, y, direction)) continue;
+			int neighbor = (y + neighborY[direction]) * maze->width + x + neighborX[direction];
+			if (steps[neighbor] != MAZE_UNREACHABLE) continue;
+			steps[neighbor] = steps[cell] + 1;
+			directions[neighbor] = direction ^ 1; // back the way the search came
+			queue[queueEnd++] = neighbor;
+		}
+	}
+	return field;
+}
\ No newline at end of file
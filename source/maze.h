@@ -0,0 +1,88 @@
+#ifndef TANK_MAZE_H
+#define TANK_MAZE_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <vector>
+
+#include "platform.h"
+#include "random.h"
+
+// info about a cell in a maze; only north and west edges are described since the adjacent cells will have info about the other edges
+struct MazeCell {
+	bool visited;
+	bool north;
+	bool west;
+};
+
+// a maze as bit masks: each row is rowWords 64 bit words, with bit x%64 of word x/64 for column x, so whole rows can be worked on a word at a time
+// (bits past the width are always 0)
+struct Maze {
+	int width;
+	int height;
+	int rowWords;
+	std::vector<u64> north; // walls on the north side of each cell
+	std::vector<u64> west; // walls on the west side of each cell
+	std::vector<u64> visited;
+	std::vector<u32> stack; // cells (as y << 16 | x) on the generator's path, kept so it doesn't have to allocate each time
+};
+
+// sets the maze to the given size with every wall up and nothing visited
+void InitMaze(Maze* maze, int width, int height);
+
+// carves a maze by iterative backtracking from the given cell (it follows a random path until it gets stuck, then backs up along it to the last cell with unvisited neighbors)
+// the path is kept on maze->stack instead of the call stack, so any size of maze can be generated
+void GenerateMaze(Maze* maze, Random* random, int startX = 0, int startY = 0);
+
+// removes each inside north/west wall with a 1/4 chance, to make the maze more open (a row at a time)
+void OpenUpMaze(Maze* maze, Random* random);
+
+// fills cells (a row-major mask for the whole maze, rowWords per row) with the cells whose north west corner is the middle of an open 2x2 of cells
+// (cells that aren't on the north or west edge and have no walls touching that corner), and returns how many there are
+int FindOpenCorners(const Maze* maze, u64* cells);
+
+// the ways out of a cell (in the same order as the generator's neighbors, so the opposite of a direction is direction ^ 1)
+enum MazeDirection {
+	MAZE_NORTH,
+	MAZE_SOUTH,
+	MAZE_EAST,
+	MAZE_WEST,
+	MAZE_NOWHERE
+};
+
+// returns true if there's no wall between a cell and its neighbor in the given direction (the outside edges are always walls)
+bool MazeOpen(const Maze* maze, int x, int y, int direction);
+
+// shortest paths through a maze to the cells something's heading for, each a field from a breadth first search out of that cell (cells are numbered y * width + x)
+// it's for the bots, which then only have to look up which way to go; a target's field is worked out the first time it's asked for and kept for the rest of the map,
+// so a map nobody's heading anywhere in never searches, and one with bots only ever searches from the cells tanks have been in
+#define MAZE_UNREACHABLE 0xffff
+struct MazeDistances {
+	int cells;
+	std::vector<int> fields; // fields[target]: where target's field starts in steps and directions (-1 until it's worked out)
+	std::vector<u16> steps; // steps[fields[target] + cell]: cells from cell to target (MAZE_UNREACHABLE if there's no path)
+	std::vector<u8> directions; // directions[fields[target] + cell]: which way to go from cell to get one cell closer to target (MAZE_NOWHERE at the target, or if there's no path)
+	std::vector<int> queue; // the search's queue, kept so it doesn't have to allocate each time
+	int searches; // fields worked out since the last reset
+};
+
+// forgets every field, ready for a maze with the given number of cells (with room for a field per tank, so a round only allocates once tanks have been
+// in more cells than that)
+void ResetMazeDistances(MazeDistances* distances, int cells);
+
+// returns where target's field starts in distances->steps and distances->directions, searching the maze for it first if it hasn't been
+int GetMazeField(MazeDistances* distances, const Maze* maze, int target);
+
+// returns the word and bit for a cell in a maze's masks
+static inline int MazeWord(const Maze* maze, int x, int y) { return y * maze->rowWords + (x >> 6); }
+static inline u64 MazeBit(int x) { return (u64) 1 << (x & 63); }
+
+static inline bool MazeNorth(const Maze* maze, int x, int y) { return maze->north[MazeWord(maze, x, y)] & MazeBit(x); }
+static inline bool MazeWest(const Maze* maze, int x, int y) { return maze->west[MazeWord(maze, x, y)] & MazeBit(x); }
+static inline MazeCell GetMazeCell(const Maze* maze, int x, int y) {
+	int word = MazeWord(maze, x, y);
+	u64 bit = MazeBit(x);
+	return (MazeCell) {(maze->visited[word] & bit) != 0, (maze->north[word] & bit) != 0, (maze->west[word] & bit) != 0};
+}
+
+#endif
\ No newline at end of file
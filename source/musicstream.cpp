@@ -0,0 +1,162 @@
+#include "musicstream.h"
+#include <string.h>
+#include <strings.h>
+#include <malloc.h>
+using namespace wsp;
+
+// each chunk goes round from empty, to being read into (by the background thread), to read, to taken (by whatever's playing it), and back to empty
+// the thread (or interrupt) on the far side of each handoff only looks at a chunk once the state says it's theirs, so the chunks themselves need no locking
+enum MusicChunkState {
+	MUSIC_CHUNK_EMPTY,
+	MUSIC_CHUNK_READING,
+	MUSIC_CHUNK_READ,
+	MUSIC_CHUNK_TAKEN
+};
+
+// opens a music file and starts reading it, returning false if it can't be opened
+bool MusicStream::Open(const char* path) {
+	Close();
+	file = fopen(path, "rb");
+	if (!file) return false;
+	const char* extension = strrchr(path, '.');
+	format = extension && !strcasecmp(extension, ".pcm") ? MUSIC_FORMAT_PCM : MUSIC_FORMAT_MP3;
+	for (int chunk = 0; chunk < MUSIC_CHUNKS; chunk++) {
+		chunks[chunk] = (u8*) memalign(32, MUSIC_CHUNK_SIZE);
+		chunkSizes[chunk] = 0;
+		chunkStates[chunk].store(MUSIC_CHUNK_EMPTY, std::memory_order_relaxed);
+	}
+	nextRead = 0;
+	nextTake = 0;
+	nextRelease = 0;
+	endOfFile = false;
+	finished.store(false, std::memory_order_relaxed);
+	readerWaiting.store(false, std::memory_order_relaxed);
+	stopping.store(false, std::memory_order_relaxed);
+	readerSignal = CreateBackgroundSignal();
+	reader = StartBackgroundThread(ReadInBackground, this);
+	Pump();
+	return true;
+}
+
+// stops reading and closes the file
+void MusicStream::Close() {
+	if (!file) return;
+	if (reader) {
+		stopping.store(true); // (set before the flag's checked, so the reader either sees it or gets woken)
+		if (readerWaiting.exchange(false)) WakeBackgroundSignal(readerSignal);
+		JoinBackgroundThread(reader);
+		reader = NULL;
+	}
+	FreeBackgroundSignal(readerSignal);
+	readerSignal = NULL;
+	fclose(file);
+	file = NULL;
+	for (int chunk = 0; chunk < MUSIC_CHUNKS; chunk++) {
+		free(chunks[chunk]);
+		chunks[chunk] = NULL;
+	}
+}
+
+bool MusicStream::IsOpen() const { return file; }
+MusicFormat MusicStream::GetFormat() const { return format; }
+
+// wakes the reader when there's a free chunk for it
+// (chunks are read, taken and released in the same order, so if any chunk's empty, the one the reader's waiting on is)
+void MusicStream::Pump() {
+	if (!file) return;
+	if (!reader) {
+		// no thread, so just read it now
+		if (!endOfFile && chunkStates[nextRead].load(std::memory_order_acquire) == MUSIC_CHUNK_EMPTY) Read();
+		return;
+	}
+	if (!readerWaiting.load(std::memory_order_relaxed)) return;
+	for (int chunk = 0; chunk < MUSIC_CHUNKS; chunk++) {
+		if (chunkStates[chunk].load(std::memory_order_relaxed) != MUSIC_CHUNK_EMPTY) continue;
+		if (readerWaiting.exchange(false)) WakeBackgroundSignal(readerSignal);
+		return;
+	}
+}
+
+// returns the next chunk that's been read, or NULL if it hasn't been read yet or the file's over
+const u8* MusicStream::TakeChunk(u32* size) {
+	if (!file || finished.load(std::memory_order_relaxed)) return NULL;
+	if (chunkStates[nextTake].load(std::memory_order_acquire) != MUSIC_CHUNK_READ) {
+		underruns.fetch_add(1, std::memory_order_relaxed);
+		return NULL;
+	}
+	if (!chunkSizes[nextTake]) {
+		finished.store(true, std::memory_order_relaxed);
+		return NULL;
+	}
+	chunkStates[nextTake].store(MUSIC_CHUNK_TAKEN, std::memory_order_relaxed);
+	*size = chunkSizes[nextTake];
+	const u8* chunk = chunks[nextTake];
+	nextTake = (nextTake + 1) % MUSIC_CHUNKS;
+	return chunk;
+}
+
+// gives back the oldest chunk that's been taken, so it can be read into again
+void MusicStream::ReleaseChunk() {
+	chunkStates[nextRelease].store(MUSIC_CHUNK_EMPTY, std::memory_order_release);
+	nextRelease = (nextRelease + 1) % MUSIC_CHUNKS;
+}
+
+bool MusicStream::IsFinished() const { return finished.load(std::memory_order_relaxed); }
+int MusicStream::GetUnderruns() const { return underruns.load(std::memory_order_relaxed); }
+int MusicStream::GetChunksRead() const { return chunksRead.load(std::memory_order_relaxed); }
+
+// reads the next chunk and moves on to the one after (a short read is the end of the file, and the chunk after it is left empty to mark it)
+void MusicStream::Read() {
+	chunkStates[nextRead].store(MUSIC_CHUNK_READING, std::memory_order_relaxed);
+	u8* chunk = chunks[nextRead];
+	u32 size = fread(chunk, 1, MUSIC_CHUNK_SIZE, file);
+	if (format == MUSIC_FORMAT_PCM) {
+		// pcm has to be whole stereo samples, and the dsp reads it in 32 byte blocks, so a short last chunk is padded out with silence
+		size &= ~3;
+		u32 padded = (size + 31) & ~31;
+		memset(chunk + size, 0, padded - size);
+		size = padded;
+	}
+	chunkSizes[nextRead] = size;
+	chunkStates[nextRead].store(MUSIC_CHUNK_READ, std::memory_order_release);
+	if (!size) endOfFile = true;
+	chunksRead.fetch_add(1, std::memory_order_relaxed);
+	nextRead = (nextRead + 1) % MUSIC_CHUNKS;
+}
+
+// the reader's loop: reads chunks as they're freed, until the end of the file or Close
+void MusicStream::ReadChunks() {
+	while (!endOfFile && !stopping.load()) {
+		if (chunkStates[nextRead].load(std::memory_order_acquire) == MUSIC_CHUNK_EMPTY) {
+			Read();
+			continue;
+		}
+		// nothing to read into, so sleep until Pump (or Close) wakes it; the chunk's checked again after saying so, since Pump may have looked just before,
+		// and if the flag's already been cleared by then, the wake's on its way and the wait just takes it
+		readerWaiting.store(true);
+		if (chunkStates[nextRead].load(std::memory_order_acquire) == MUSIC_CHUNK_EMPTY || stopping.load()) {
+			if (readerWaiting.exchange(false)) continue;
+		}
+		WaitForBackgroundSignal(readerSignal);
+	}
+}
+
+void MusicStream::ReadInBackground(void* stream) { ((MusicStream*) stream)->ReadChunks(); }
+
+MusicStream::MusicStream() : readerWaiting(false), stopping(false), finished(false), underruns(0), chunksRead(0) {
+	file = NULL;
+	format = MUSIC_FORMAT_MP3;
+	for (int chunk = 0; chunk < MUSIC_CHUNKS; chunk++) {
+		chunks[chunk] = NULL;
+		chunkSizes[chunk] = 0;
+		chunkStates[chunk].store(MUSIC_CHUNK_EMPTY, std::memory_order_relaxed);
+	}
+	nextRead = 0;
+	nextTake = 0;
+	nextRelease = 0;
+	reader = NULL;
+	readerSignal = NULL;
+	endOfFile = false;
+}
+
+MusicStream::~MusicStream() { Close(); }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef TANK_MUSICSTREAM_H
+#define TANK_MUSICSTREAM_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <gccore.h>
+#include <atomic>
+
+#include "platform.h"
+
+using namespace wsp;
+
+// how much of a music file is read at a time (a multiple of 32, since the dsp plays pcm chunks straight out of memory)
+#define MUSIC_CHUNK_SIZE (32 * 1024)
+// chunks in memory at once: one playing, one queued up behind it, and one being read into
+#define MUSIC_CHUNKS 3
+
+// formats music files can be streamed in (from their extension)
+enum MusicFormat {
+	MUSIC_FORMAT_MP3, // decoded as it plays (.mp3)
+	MUSIC_FORMAT_PCM // already decoded, so there's nothing for the cpu to do (.pcm: 16-bit stereo 44.1khz little endian, like the sound effects)
+};
+
+// streams a music file a chunk at a time, so only MUSIC_CHUNKS chunks of the track are ever in memory rather than all of it
+// the reads happen on one background thread per stream, which sleeps whenever every chunk is full until Pump sees one's been given back, and the chunks
+// are handed in order to whatever plays the music with TakeChunk/ReleaseChunk, which can be called from another thread (or an interrupt) while the game thread pumps
+class MusicStream {
+	public:
+		// opens a music file and starts reading it, returning false if it can't be opened
+		bool Open(const char* path);
+		// stops reading and closes the file (whatever's playing the stream has to have stopped first)
+		void Close();
+		bool IsOpen() const;
+		MusicFormat GetFormat() const;
+		// called regularly on the game thread: wakes the reader when there's a free chunk for it
+		void Pump();
+		// returns the next chunk that's been read (they're handed out in order), or NULL if it hasn't been read yet or the file's over
+		const u8* TakeChunk(u32* size);
+		// gives back the oldest chunk that's been taken, so it can be read into again
+		void ReleaseChunk();
+		// true once every chunk in the file has been taken
+		bool IsFinished() const;
+		// number of times a chunk was wanted before it had been read
+		int GetUnderruns() const;
+		int GetChunksRead() const;
+		MusicStream();
+		~MusicStream();
+	private:
+		FILE* file; // NULL if the stream isn't open
+		MusicFormat format;
+		u8* chunks[MUSIC_CHUNKS]; // allocated while the stream's open
+		u32 chunkSizes[MUSIC_CHUNKS]; // bytes in each chunk (a chunk with none marks the end of the file)
+		std::atomic<int> chunkStates[MUSIC_CHUNKS]; // what each chunk's being used for (see musicstream.cpp)
+		int nextRead; // chunk being read into, or the next one to be (reader only)
+		int nextTake; // chunk TakeChunk hands out next (player only)
+		int nextRelease; // chunk ReleaseChunk gives back next (player only)
+		BackgroundThread* reader; // thread doing the reads (NULL if there isn't one, and Pump reads instead)
+		BackgroundSignal* readerSignal; // what the reader sleeps on while there are no free chunks
+		std::atomic<bool> readerWaiting; // set by the reader before it sleeps: whichever thread clears it again is the one that wakes it
+		std::atomic<bool> stopping; // set by Close to stop the reader
+		bool endOfFile; // set once a read reaches the end of the file, so no more are done
+		std::atomic<bool> finished;
+		std::atomic<int> underruns;
+		std::atomic<int> chunksRead;
+		// reads the next chunk and moves on to the one after (on whichever thread's reading)
+		void Read();
+		// the reader's loop: reads chunks as they're freed, until the end of the file or Close
+		void ReadChunks();
+		static void ReadInBackground(void* stream);
+		// the stream owns its file, chunks and thread, so it can't be copied
+		MusicStream(const MusicStream&);
+		MusicStream& operator=(const MusicStream&);
+};
+
+#endif
\ No newline at end of file
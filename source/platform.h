@@ -0,0 +1,105 @@
+#ifndef TANK_PLATFORM_H
+#define TANK_PLATFORM_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+
+using namespace wsp;
+
+// everything the game needs from the console goes through here, so the game code itself never calls wpad/asndlib/mp3player/libfat
+// there are two backends: platform_wii.cpp for the real thing, and host/platform_host.cpp for running headless on a pc
+// (drawing goes through libwiisprite's layers and GameWindow, which the host build swaps for a headless version in host/wiisprite.cpp)
+
+// number of wiimotes/players
+#define MAX_PLAYERS 4
+
+// buttons, as bits of a button mask (these are the same as wpad's, so the wii backend can pass its masks straight through)
+#define BUTTON_2 0x0001
+#define BUTTON_1 0x0002
+#define BUTTON_B 0x0004
+#define BUTTON_A 0x0008
+#define BUTTON_MINUS 0x0010
+#define BUTTON_HOME 0x0080
+#define BUTTON_LEFT 0x0100
+#define BUTTON_RIGHT 0x0200
+#define BUTTON_DOWN 0x0400
+#define BUTTON_UP 0x0800
+#define BUTTON_PLUS 0x1000
+
+// one player's input for a frame
+struct PlayerInput {
+	u32 held; // buttons being held
+	u32 down; // buttons that were just pressed this frame
+	f32 pointerX; // where the wiimote is pointing on screen (already corrected for libwiisprite's offsets)
+	f32 pointerY;
+	f32 pointerAngle; // wiimote roll in degrees
+};
+
+// every player's input for a frame (the game only reads input through this, so it can come from anywhere)
+struct InputState {
+	PlayerInput players[MAX_PLAYERS];
+};
+
+// video, audio, storage, and wiimote initialization
+void InitPlatform(GameWindow* gwd);
+
+// shuts everything down before exiting
+void ShutdownPlatform(GameWindow* gwd);
+
+// reads every player's input for this frame
+void ReadInput(InputState* input);
+// returns which players have a controller connected (a bit for each player)
+u32 GetConnectedPlayers();
+
+// number of voices sound effects can play on at once (the wii has 16, one of which the music uses, so this is a budget rather than a hard limit)
+#define SOUND_VOICES 8
+
+// a sound effect's samples: 16-bit little endian pcm at any rate, mono or stereo (interleaved), 32 byte aligned
+struct SoundSamples {
+	const u8* data;
+	u32 size; // in bytes (0 for a sound that isn't there, which never plays)
+	u32 rate;
+	int channels;
+};
+
+// plays a sound effect on a voice (0 to SOUND_VOICES - 1), cutting off whatever it was playing
+// (the game doesn't call this directly; sounds go through a SoundQueue, which decides which voice each one gets)
+void PlayVoice(int voice, const SoundSamples* sound);
+
+// returns true if a voice is still playing its sound effect
+bool IsVoicePlaying(int voice);
+
+// plays/stops the background music (an mp3 in memory, or a stream from a music file)
+class MusicStream;
+void PlayMusic(const u8* mp3, u32 size);
+// (returns false if the stream's in a format this platform can't play)
+bool PlayMusicStream(MusicStream* stream);
+void StopMusic();
+bool IsMusicPlaying();
+
+// keeps streamed music going: pumps the stream's reads and starts its voice up again if it ran dry (call regularly, from the game thread)
+void UpdateMusic();
+
+// returns the time on a monotonic clock, in ticks (ClockTicksToSeconds converts a number of ticks to seconds)
+u64 GetClockTicks();
+f64 ClockTicksToSeconds(u64 ticks);
+
+// a thread for work that can happen in the background (an lwp thread on the wii, at a lower priority than the game, so it only runs while the game's waiting for the next frame)
+struct BackgroundThread;
+
+// starts running function(argument) on a new background thread (returns NULL if one can't be started)
+BackgroundThread* StartBackgroundThread(void (*function)(void*), void* argument);
+
+// waits for a background thread to finish, then frees it
+void JoinBackgroundThread(BackgroundThread* thread);
+
+// something a background thread can sleep on until another thread wakes it (a semaphore on the wii: each wake lets one wait through, even if it came first)
+struct BackgroundSignal;
+BackgroundSignal* CreateBackgroundSignal();
+void FreeBackgroundSignal(BackgroundSignal* signal);
+// blocks until the signal's woken (not from an interrupt)
+void WaitForBackgroundSignal(BackgroundSignal* signal);
+void WakeBackgroundSignal(BackgroundSignal* signal);
+
+#endif
\ No newline at end of file
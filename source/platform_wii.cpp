@@ -0,0 +1,231 @@
+#include "platform.h"
+#include "musicstream.h"
+#include <string.h>
+#include <unistd.h>
+#include <ogc/lwp_watchdog.h>
+#include <ogc/lwp.h>
+#include <ogc/irq.h>
+#include <fat.h>
+#include <wiiuse/wpad.h>
+#include <asndlib.h>
+#include <mp3player.h>
+using namespace wsp;
+
+// the button bits are passed straight through from wpad, so they have to match
+static_assert(BUTTON_2 == WPAD_BUTTON_2 && BUTTON_1 == WPAD_BUTTON_1 && BUTTON_B == WPAD_BUTTON_B && BUTTON_A == WPAD_BUTTON_A, "button bits don't match wpad");
+static_assert(BUTTON_MINUS == WPAD_BUTTON_MINUS && BUTTON_HOME == WPAD_BUTTON_HOME && BUTTON_PLUS == WPAD_BUTTON_PLUS, "button bits don't match wpad");
+static_assert(BUTTON_LEFT == WPAD_BUTTON_LEFT && BUTTON_RIGHT == WPAD_BUTTON_RIGHT && BUTTON_DOWN == WPAD_BUTTON_DOWN && BUTTON_UP == WPAD_BUTTON_UP, "button bits don't match wpad");
+
+// video, audio, storage, and wiimote initialization
+void InitPlatform(GameWindow* gwd) {
+	// video initialization
+	gwd->InitVideo();
+	// audio initialization
+	ASND_Init();
+	MP3Player_Init();
+	// file initialization
+	fatInitDefault();
+	// wiimote initialization
+	WPAD_Init();
+	WPAD_SetVRes(WPAD_CHAN_ALL, gwd->GetWidth(), gwd->GetHeight());
+	WPAD_SetDataFormat(WPAD_CHAN_ALL, WPAD_FMT_BTNS_ACC_IR);
+}
+
+// shuts everything down before exiting
+void ShutdownPlatform(GameWindow* gwd) {
+	fatUnmount(0);
+	gwd->StopVideo();
+}
+
+// reads every player's input for this frame
+void ReadInput(InputState* input) {
+	WPAD_ScanPads();
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		PlayerInput* playerInput = &input->players[player];
+		playerInput->held = WPAD_ButtonsHeld(player);
+		playerInput->down = WPAD_ButtonsDown(player);
+		ir_t ir;
+		WPAD_IR(player, &ir);
+		playerInput->pointerX = ir.sx - WSP_POINTER_CORRECTION_X; // use sx and sy (s for smoothed) for best ir detection; sx/sy require offsets
+		playerInput->pointerY = ir.sy - WSP_POINTER_CORRECTION_Y;
+		playerInput->pointerAngle = ir.angle;
+	}
+}
+
+// returns which players have a wiimote connected (a bit for each player)
+u32 GetConnectedPlayers() {
+	u32 players = 0;
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		u32 type;
+		if (WPAD_Probe(player, &type) == WPAD_ERR_NONE) players |= 1 << player;
+	}
+	return players;
+}
+
+// sound effects use asndlib's voices after the first, which mp3player plays the music on
+#define SOUND_FIRST_VOICE 1
+static_assert(SOUND_FIRST_VOICE + SOUND_VOICES <= MAX_SND_VOICES, "more sound effect voices than asndlib has");
+
+// plays a sound effect on a voice, cutting off whatever it was playing (the dsp resamples it from its own rate, so the cpu never touches the samples)
+void PlayVoice(int voice, const SoundSamples* sound) {
+	SND_StopVoice(SOUND_FIRST_VOICE + voice);
+	if (!sound->size) return;
+	SND_SetVoice(SOUND_FIRST_VOICE + voice, sound->channels == 2 ? VOICE_STEREO_16BIT_LE : VOICE_MONO_16BIT_LE, sound->rate, 0, (char*) sound->data, sound->size, 255, 255, NULL);
+}
+
+// returns true if a voice is still playing its sound effect
+bool IsVoicePlaying(int voice) { return SND_StatusVoice(SOUND_FIRST_VOICE + voice) == SND_WORKING; }
+
+// plays the background music from an mp3 in memory (an empty one means there's no music built in, so there's nothing to play)
+void PlayMusic(const u8* mp3, u32 size) {
+	StopMusic();
+	if (size) MP3Player_PlayBuffer(mp3, size, NULL);
+}
+
+// the clock is the cpu's timebase
+u64 GetClockTicks() { return gettime(); }
+f64 ClockTicksToSeconds(u64 ticks) { return ticks / (TB_TIMER_CLOCK * 1000.0); }
+
+// background threads are below the main thread's priority, so they never take time from a frame, only from the wait for vsync
+#define BACKGROUND_THREAD_PRIORITY 32
+#define BACKGROUND_THREAD_STACK_SIZE (64 * 1024)
+
+struct BackgroundThread {
+	lwp_t handle;
+	void (*function)(void*);
+	void* argument;
+};
+
+static void* RunBackgroundThread(void* thread) {
+	((BackgroundThread*) thread)->function(((BackgroundThread*) thread)->argument);
+	return NULL;
+}
+
+// starts running function(argument) on a new background thread (returns NULL if one can't be started)
+BackgroundThread* StartBackgroundThread(void (*function)(void*), void* argument) {
+	BackgroundThread* thread = new BackgroundThread();
+	thread->function = function;
+	thread->argument = argument;
+	if (LWP_CreateThread(&thread->handle, RunBackgroundThread, thread, NULL, BACKGROUND_THREAD_STACK_SIZE, BACKGROUND_THREAD_PRIORITY) < 0) {
+		delete thread;
+		return NULL;
+	}
+	return thread;
+}
+
+// waits for a background thread to finish, then frees it
+void JoinBackgroundThread(BackgroundThread* thread) {
+	LWP_JoinThread(thread->handle, NULL);
+	delete thread;
+}
+
+struct BackgroundSignal {
+	sem_t semaphore;
+};
+
+BackgroundSignal* CreateBackgroundSignal() {
+	BackgroundSignal* signal = new BackgroundSignal();
+	LWP_SemInit(&signal->semaphore, 0, 1);
+	return signal;
+}
+
+void FreeBackgroundSignal(BackgroundSignal* signal) {
+	LWP_SemDestroy(signal->semaphore);
+	delete signal;
+}
+
+void WaitForBackgroundSignal(BackgroundSignal* signal) { LWP_SemWait(signal->semaphore); }
+void WakeBackgroundSignal(BackgroundSignal* signal) { LWP_SemPost(signal->semaphore); }
+
+// streamed music: mp3 files are fed to mp3player a chunk at a time through its reader callback, and pcm files go straight to a voice of their own,
+// with each chunk queued up behind the one playing (so the dsp does all the work, and the cpu just reads the file)
+#define MUSIC_VOICE (SOUND_FIRST_VOICE + SOUND_VOICES)
+static_assert(MUSIC_VOICE < MAX_SND_VOICES, "no voice left for streamed music");
+
+static MusicStream* musicStream; // stream being played (NULL if it's the built in track, or nothing)
+static volatile bool musicStopping; // set while the stream's being stopped, so the reader gives up instead of waiting for chunks
+static const u8* musicChunk; // chunk the mp3 reader's part way through (mp3player's thread only)
+static u32 musicChunkSize;
+static u32 musicChunkOffset;
+static const u8* musicQueued[2]; // chunks the pcm voice has, the one playing first (interrupts off, or in its callback, only)
+static int musicQueuedCount;
+
+// mp3player's reader: copies out of the stream's chunks, waiting for the next one to be read if it has to (returns 0 at the end)
+static s32 ReadMusicStream(void* data, void* buffer, s32 size) {
+	// (this runs on mp3player's decoding thread, which is left at its own priority: any lower and the game starves it, and the music drops out)
+	while (musicChunkOffset == musicChunkSize) {
+		if (musicChunk) musicStream->ReleaseChunk();
+		musicChunk = NULL;
+		musicChunkSize = 0;
+		musicChunkOffset = 0;
+		if (musicStopping || musicStream->IsFinished()) return 0;
+		musicChunk = musicStream->TakeChunk(&musicChunkSize);
+		if (!musicChunk) usleep(1000); // not read yet
+	}
+	u32 copied = musicChunkSize - musicChunkOffset < (u32) size ? musicChunkSize - musicChunkOffset : size;
+	memcpy(buffer, musicChunk + musicChunkOffset, copied);
+	musicChunkOffset += copied;
+	return copied;
+}
+
+// the pcm voice's callback (and UpdateMusic, with interrupts off): gives back the chunks the voice is done with, and queues up the next one
+static void FeedMusicVoice(s32 voice) {
+	while (musicQueuedCount && SND_TestPointer(MUSIC_VOICE, (void*) musicQueued[0]) != 1) {
+		musicStream->ReleaseChunk();
+		musicQueued[0] = musicQueued[1];
+		musicQueuedCount--;
+	}
+	if (musicQueuedCount == 2) return;
+	u32 size;
+	const u8* chunk = musicStream->TakeChunk(&size);
+	if (!chunk) return;
+	DCFlushRange((void*) chunk, size);
+	if (!musicQueuedCount) SND_SetVoice(MUSIC_VOICE, VOICE_STEREO_16BIT_LE, 44100, 0, (void*) chunk, size, 255, 255, FeedMusicVoice);
+	else SND_AddVoice(MUSIC_VOICE, (void*) chunk, size);
+	musicQueued[musicQueuedCount++] = chunk;
+}
+
+// plays the background music from a stream
+bool PlayMusicStream(MusicStream* stream) {
+	StopMusic();
+	musicStream = stream;
+	if (stream->GetFormat() == MUSIC_FORMAT_MP3) MP3Player_PlayFile(stream, ReadMusicStream, NULL);
+	else UpdateMusic();
+	return true;
+}
+
+void StopMusic() {
+	musicStopping = true;
+	MP3Player_Stop();
+	SND_StopVoice(MUSIC_VOICE);
+	musicStopping = false;
+	if (musicStream) {
+		if (musicChunk) musicStream->ReleaseChunk();
+		for (int i = 0; i < musicQueuedCount; i++) musicStream->ReleaseChunk();
+	}
+	musicChunk = NULL;
+	musicChunkSize = 0;
+	musicChunkOffset = 0;
+	musicQueuedCount = 0;
+	musicStream = NULL;
+}
+
+bool IsMusicPlaying() {
+	if (musicStream && musicStream->GetFormat() == MUSIC_FORMAT_PCM) return !musicStream->IsFinished() || SND_StatusVoice(MUSIC_VOICE) == SND_WORKING;
+	return MP3Player_IsPlaying();
+}
+
+// keeps streamed music going: pumps the stream's reads and starts its voice up again if it ran dry
+void UpdateMusic() {
+	if (!musicStream) return;
+	musicStream->Pump();
+	if (musicStream->GetFormat() != MUSIC_FORMAT_PCM) return;
+	u32 level = IRQ_Disable();
+	if (SND_StatusVoice(MUSIC_VOICE) != SND_WORKING) {
+		// it's stopped (or hasn't started yet), so nothing it had is in use
+		for (int i = 0; i < musicQueuedCount; i++) musicStream->ReleaseChunk();
+		musicQueuedCount = 0;
+	}
+	FeedMusicVoice(MUSIC_VOICE);
+	IRQ_Restore(level);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef TANK_POOL_H
+#define TANK_POOL_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <gccore.h>
+
+#include "profiler.h"
+
+// fixed capacity storage for objects of one type, allocated once up front so creating/destroying them never touches the heap
+// getting and giving back a slot are both O(1) (free slots are kept on a stack), and the pool keeps track of the most it's ever had in use
+// objects are made with new (pool) T(...) and destroyed with a plain delete (see Pooled below), so code that deletes them doesn't need to know about pools
+template <typename T> class ObjectPool {
+	public:
+		// returns storage for one object, or NULL if the pool is full
+		void* Acquire() {
+			if (!freeCount) {
+				failedAcquires++;
+				return NULL;
+			}
+			CountProfileEvent(PROFILE_ALLOCATIONS);
+			Slot* slot = &slots[freeSlots[--freeCount]];
+			int used = capacity - freeCount;
+			if (used > highWater) highWater = used;
+			return slot->storage;
+		}
+		// gives an object's storage back to the pool it came from (the object has to have been destroyed already)
+		static void Release(void* object) {
+			Slot* slot = (Slot*) ((u8*) object - offsetof(Slot, storage));
+			ObjectPool* pool = slot->pool;
+			pool->freeSlots[pool->freeCount++] = slot - pool->slots;
+		}
+		int GetCapacity() const { return capacity; }
+		int GetUsed() const { return capacity - freeCount; }
+		int GetHighWater() const { return highWater; } // most slots that have been in use at once
+		int GetFailedAcquires() const { return failedAcquires; } // times an object was asked for when the pool was full
+		const char* GetName() const { return name; }
+		// prints the pool's usage (for POOL_DEBUG builds)
+		void Report() const {
+			printf("pool %s: %d/%d in use, high water %d, %d failed\n", name, GetUsed(), capacity, highWater, failedAcquires);
+		}
+		ObjectPool(int capacity, const char* name) {
+			this->capacity = capacity;
+			this->name = name;
+			slots = new Slot[capacity];
+			freeSlots = new int[capacity];
+			// the stack is filled backwards so slots get handed out in order
+			for (int i = 0; i < capacity; i++) {
+				slots[i].pool = this;
+				freeSlots[i] = capacity - 1 - i;
+			}
+			freeCount = capacity;
+			highWater = 0;
+			failedAcquires = 0;
+		}
+		~ObjectPool() {
+			delete[] slots;
+			delete[] freeSlots;
+		}
+	private:
+		// each slot remembers its pool, so objects can be given back with nothing but their address
+		struct Slot {
+			ObjectPool* pool;
+			alignas(T) u8 storage[sizeof(T)];
+		};
+		Slot* slots;
+		int* freeSlots; // stack of free slot indices
+		int freeCount;
+		int capacity;
+		int highWater;
+		int failedAcquires;
+		const char* name;
+		// pools own their slots, so they can't be copied
+		ObjectPool(const ObjectPool&);
+		ObjectPool& operator=(const ObjectPool&);
+};
+
+// base class for pooled objects: new (pool) T(...) makes one in a pool (giving NULL if the pool is full), and delete gives it back
+// (delete goes to the right pool even through a base class pointer, like the deletes in ClearLayerManager, since layers have virtual destructors)
+template <typename T> class Pooled {
+	public:
+		static void* operator new(size_t size, ObjectPool<T>* pool) noexcept { return pool->Acquire(); }
+		static void operator delete(void* object) { if (object) ObjectPool<T>::Release(object); }
+		// only used if a constructor throws
+		static void operator delete(void* object, ObjectPool<T>* pool) { ObjectPool<T>::Release(object); }
+};
+
+#endif
\ No newline at end of file
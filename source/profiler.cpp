@@ -0,0 +1,186 @@
+#include "profiler.h"
+#include <algorithm>
+using namespace wsp;
+
+PROFILE_THREAD_LOCAL u32* profileCounters = NULL;
+#ifdef GEKKO
+lwp_t profileThread = LWP_THREAD_NULL;
+#endif
+
+static const char* const phaseNames[PROFILE_PHASE_COUNT] = {"input", "bots", "spinners", "bullets", "tanks", "explosions", "cursors", "render", "flush"};
+static const char* const counterNames[PROFILE_COUNTER_COUNT] = {"collision_pairs", "allocations"};
+
+// phase colors in the overlay
+static const GXColor phaseColors[PROFILE_PHASE_COUNT] = {
+	{255, 255, 255, 255}, // input
+	{255, 128, 192, 255}, // bots
+	{127, 127, 127, 255}, // spinners
+	{255, 215, 0, 255}, // bullets
+	{64, 160, 255, 255}, // tanks
+	{255, 96, 32, 255}, // explosions
+	{192, 96, 255, 255}, // cursors
+	{64, 224, 96, 255}, // render
+	{0, 127, 64, 255}, // flush
+};
+
+const char* GetProfilePhaseName(ProfilePhase phase) { return phaseNames[phase]; }
+const char* GetProfileCounterName(ProfileCounter counter) { return counterNames[counter]; }
+
+// marks the start of a frame (everything timed or counted until EndFrame goes in it)
+void Profiler::BeginFrame() {
+	// the frame is written in the slot after the last finished one (readers never look at that slot)
+	current = &frames[finishedFrames.load(std::memory_order_relaxed) % PROFILE_FRAMES];
+	for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++) current->phaseTicks[phase] = 0;
+	for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) current->counters[counter] = 0;
+	current->eventCount = 0;
+	current->start = GetClockTicks();
+	current->end = current->start;
+#ifdef GEKKO
+	profileThread = LWP_GetSelf(); // only events on the thread running the frames are counted
+#endif
+	profileCounters = current->counters;
+}
+
+// marks the end of a frame
+void Profiler::EndFrame() {
+	if (!current) return;
+	current->end = GetClockTicks();
+	profileCounters = NULL;
+	current = NULL;
+	// publish the frame (the release makes sure everything written to it is seen by anyone who sees the new count)
+	finishedFrames.store(finishedFrames.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// marks the start of a phase, and returns the event to end it with (-1 if there's no room for it or no frame is being profiled)
+int Profiler::BeginPhase(ProfilePhase phase) {
+	if (!current || current->eventCount == PROFILE_MAX_EVENTS) return -1;
+	int event = current->eventCount++;
+	current->events[event].phase = phase;
+	current->events[event].duration = 0;
+	current->events[event].start = GetClockTicks();
+	return event;
+}
+
+void Profiler::EndPhase(int event) {
+	if (!current || event < 0) return;
+	ProfileEvent* profileEvent = &current->events[event];
+	profileEvent->duration = GetClockTicks() - profileEvent->start;
+	current->phaseTicks[profileEvent->phase] += profileEvent->duration;
+}
+
+// copies (up to maxFrames of) the latest finished frames, oldest first, and returns how many there were
+int Profiler::CopyFrames(ProfileFrame* copies, int maxFrames) const {
+	// the slot after the last finished frame might be being written, so at most PROFILE_FRAMES - 1 can be read
+	u32 finished = finishedFrames.load(std::memory_order_acquire);
+	u32 count = std::min(std::min((u32) maxFrames, finished), (u32) PROFILE_FRAMES - 1);
+	u32 first = finished - count;
+	for (u32 i = 0; i < count; i++) copies[i] = frames[(first + i) % PROFILE_FRAMES];
+	// if more frames were started while copying, the oldest copies may have been written over part way through, so they're dropped
+	std::atomic_thread_fence(std::memory_order_acquire);
+	u32 finishedAfter = finishedFrames.load(std::memory_order_relaxed);
+	u32 overwritten = finishedAfter + 1 > PROFILE_FRAMES ? finishedAfter + 1 - PROFILE_FRAMES : 0; // frames before this one may have been written over
+	if (overwritten > first) {
+		u32 dropped = std::min(overwritten - first, count);
+		for (u32 i = dropped; i < count; i++) copies[i - dropped] = copies[i];
+		count -= dropped;
+	}
+	return count;
+}
+
+// number of frames that have finished
+u32 Profiler::GetFrameCount() const { return finishedFrames.load(std::memory_order_acquire); }
+
+Profiler::Profiler() : finishedFrames(0) {
+	frames = new ProfileFrame[PROFILE_FRAMES];
+	current = NULL;
+}
+
+Profiler::~Profiler() {
+	if (current) profileCounters = NULL;
+	delete[] frames;
+}
+
+// writes the latest frames (up to maxFrames) to a file as chrome trace event json, and returns false if the file can't be written
+// (each frame is an event with its phases inside it, and the counters are counter events at the start of each frame; times are in microseconds from the first frame)
+bool WriteProfileTrace(const Profiler* profiler, const char* path, int maxFrames) {
+	ProfileFrame* frames = new ProfileFrame[PROFILE_FRAMES];
+	int count = profiler->CopyFrames(frames, std::min(maxFrames, PROFILE_FRAMES));
+	FILE* file = fopen(path, "w");
+	if (!file) {
+		delete[] frames;
+		return false;
+	}
+	u64 base = count ? frames[0].start : 0;
+	fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+	fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, \"args\": {\"name\": \"main loop\"}}");
+	for (int i = 0; i < count; i++) {
+		const ProfileFrame* frame = &frames[i];
+		f64 frameStart = ClockTicksToSeconds(frame->start - base) * 1e6;
+		fprintf(file, ",\n{\"name\": \"frame\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f}", frameStart, ClockTicksToSeconds(frame->end - frame->start) * 1e6);
+		for (int event = 0; event < frame->eventCount; event++) {
+			const ProfileEvent* profileEvent = &frame->events[event];
+			fprintf(file, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f}", phaseNames[profileEvent->phase],
+				ClockTicksToSeconds(profileEvent->start - base) * 1e6, ClockTicksToSeconds(profileEvent->duration) * 1e6);
+		}
+		for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) {
+			fprintf(file, ",\n{\"name\": \"%s\", \"ph\": \"C\", \"pid\": 0, \"tid\": 0, \"ts\": %.3f, \"args\": {\"%s\": %u}}", counterNames[counter], frameStart, counterNames[counter], (unsigned int) frame->counters[counter]);
+		}
+	}
+	fprintf(file, "\n]}\n");
+	delete[] frames;
+	return fclose(file) == 0;
+}
+
+// size of the overlay's parts (the graph has a bar this many pixels wide for each frame)
+#define OVERLAY_GRAPH_BAR_WIDTH 2
+#define OVERLAY_GRAPH_HEIGHT 64
+#define OVERLAY_BAR_HEIGHT 8
+#define OVERLAY_FRAME_BUDGET (1.0 / 60)
+
+void ProfileOverlay::Draw(const Profiler* profiler, RenderQueue* queue, f32 x, f32 y) {
+	// add the frame that's finished since the last draw to the graph (the overlay's drawn once a frame, so there's only ever one)
+	u32 frameCount = profiler->GetFrameCount();
+	if (frameCount != lastFrame && profiler->CopyFrames(&last, 1)) {
+		lastFrame = frameCount;
+		frameTimes[nextFrameTime] = ClockTicksToSeconds(last.end - last.start);
+		nextFrameTime = (nextFrameTime + 1) % PROFILE_OVERLAY_FRAMES;
+		if (frameTimeCount < PROFILE_OVERLAY_FRAMES) frameTimeCount++;
+	}
+	f32 width = PROFILE_OVERLAY_FRAMES * OVERLAY_GRAPH_BAR_WIDTH;
+	// background
+	DrawRectangle(queue, x - 4, y - 4, width + 8, OVERLAY_BAR_HEIGHT + OVERLAY_GRAPH_HEIGHT + 12, (GXColor) {0, 0, 0, 160});
+	// phases of the last frame, end to end (the full width is one frame's budget)
+	if (frameTimeCount) {
+		f32 phaseX = x;
+		for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++) {
+			f32 phaseWidth = std::min((f32) (ClockTicksToSeconds(last.phaseTicks[phase]) / OVERLAY_FRAME_BUDGET * width), x + width - phaseX);
+			if (phaseWidth >= 1) DrawRectangle(queue, phaseX, y, phaseWidth, OVERLAY_BAR_HEIGHT, phaseColors[phase]);
+			phaseX += phaseWidth;
+		}
+	}
+	// frame times, newest on the right (the graph goes up to 2 frames' budget, so the budget line is half way up)
+	f32 graphY = y + OVERLAY_BAR_HEIGHT + 4;
+	for (int i = 0; i < frameTimeCount; i++) {
+		f32 frameTime = frameTimes[(nextFrameTime - frameTimeCount + i + PROFILE_OVERLAY_FRAMES) % PROFILE_OVERLAY_FRAMES];
+		f32 barHeight = std::min(frameTime / (2 * OVERLAY_FRAME_BUDGET), 1.0) * OVERLAY_GRAPH_HEIGHT;
+		GXColor color = frameTime > OVERLAY_FRAME_BUDGET ? (GXColor) {255, 64, 64, 255} : (GXColor) {64, 224, 96, 255};
+		f32 barX = x + (PROFILE_OVERLAY_FRAMES - frameTimeCount + i) * OVERLAY_GRAPH_BAR_WIDTH;
+		if (barHeight >= 1) DrawRectangle(queue, barX, graphY + OVERLAY_GRAPH_HEIGHT - barHeight, OVERLAY_GRAPH_BAR_WIDTH, barHeight, color);
+	}
+	DrawRectangle(queue, x, graphY + OVERLAY_GRAPH_HEIGHT / 2, width, 1, (GXColor) {255, 255, 255, 255});
+}
+
+// adds a rectangle to the queue with the quad
+void ProfileOverlay::DrawRectangle(RenderQueue* queue, f32 x, f32 y, f32 width, f32 height, GXColor color) {
+	quad.SetPosition(x, y);
+	quad.SetWidth((u32) width);
+	quad.SetHeight((u32) height);
+	quad.SetFillColor(color);
+	queue->AddQuad(RENDER_PASS_OVERLAY, &quad);
+}
+
+ProfileOverlay::ProfileOverlay() {
+	lastFrame = 0;
+	frameTimeCount = 0;
+	nextFrameTime = 0;
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef TANK_PROFILER_H
+#define TANK_PROFILER_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <gccore.h>
+#include <wiisprite.h>
+#include <atomic>
+
+#include "platform.h"
+#include "renderer.h"
+
+using namespace wsp;
+
+// per frame profiling: the main loop marks where each frame starts and ends, and scoped timers (ProfileScope) mark each phase of it,
+// all timed with GetClockTicks (the cpu's timebase on the wii, a monotonic clock on a pc)
+// the last PROFILE_FRAMES frames are kept in a ring buffer, which can be drawn as an overlay (ProfileOverlay) or written out as a chrome trace (WriteProfileTrace)
+// there's also a count of some things per frame (collision pairs tested, and objects taken from the pools and textures loaded), which the code doing them adds to with CountProfileEvent
+// counting only happens in PROFILE builds (make PROFILE=1), so everywhere else CountProfileEvent is nothing at all; the phases can still be timed in any build
+
+// the parts of a frame that are timed (the simulation's can happen more than once a frame, or not at all, depending on how many steps are due)
+enum ProfilePhase {
+	PROFILE_INPUT,
+	PROFILE_BOTS,
+	PROFILE_SPINNERS,
+	PROFILE_BULLETS,
+	PROFILE_TANKS,
+	PROFILE_EXPLOSIONS,
+	PROFILE_CURSORS,
+	PROFILE_RENDER,
+	PROFILE_FLUSH,
+	PROFILE_PHASE_COUNT
+};
+
+// the things that are counted each frame
+enum ProfileCounter {
+	PROFILE_COLLISION_PAIRS,
+	PROFILE_ALLOCATIONS, // objects taken from a pool, and textures loaded into the cache
+	PROFILE_COUNTER_COUNT
+};
+
+// number of frames kept (a little over 4 seconds at 60hz)
+#define PROFILE_FRAMES 256
+
+// most timed phases kept per frame (enough for every phase at the most steps a frame can run)
+#define PROFILE_MAX_EVENTS 32
+
+// one timed phase in a frame
+struct ProfileEvent {
+	u64 start;
+	u32 duration; // in ticks
+	u32 phase;
+};
+
+// everything recorded about one frame
+struct ProfileFrame {
+	u64 start;
+	u64 end;
+	u64 phaseTicks[PROFILE_PHASE_COUNT]; // total time spent in each phase
+	u32 counters[PROFILE_COUNTER_COUNT];
+	int eventCount;
+	ProfileEvent events[PROFILE_MAX_EVENTS];
+};
+
+// the counters of the frame being profiled on this thread (NULL when there isn't one), for CountProfileEvent
+// (each thread has its own on a pc, so several games can be profiled at once; the wii only runs one)
+#ifdef GEKKO
+	#define PROFILE_THREAD_LOCAL
+#else
+	#define PROFILE_THREAD_LOCAL thread_local
+#endif
+extern PROFILE_THREAD_LOCAL u32* profileCounters;
+
+#ifdef GEKKO
+// there's no thread local storage on the wii, so every thread sees the one profileCounters; this is the thread whose frame it is,
+// and events on any other thread (the map builder's, mp3player's) aren't counted, rather than being added to the game's frame from under it
+extern lwp_t profileThread;
+#endif
+
+// adds to one of the current frame's counters (does nothing if no frame is being profiled on this thread, or this isn't a PROFILE build)
+static inline void CountProfileEvent(ProfileCounter counter, u32 count = 1) {
+#if defined(PROFILE) && defined(GEKKO)
+	if (profileCounters && LWP_GetSelf() == profileThread) profileCounters[counter] += count;
+#elif defined(PROFILE)
+	if (profileCounters) profileCounters[counter] += count;
+#endif
+}
+
+// the frames are written by one thread (the one running the frames) and can be read from any thread without locking (see CopyFrames)
+class Profiler {
+	public:
+		// marks the start/end of a frame (everything timed or counted in between goes in it)
+		void BeginFrame();
+		void EndFrame();
+		// marks the start of a phase, and returns the event to end it with (-1 if there's no room for it or no frame is being profiled)
+		int BeginPhase(ProfilePhase phase);
+		void EndPhase(int event);
+		// copies (up to maxFrames of) the latest finished frames, oldest first, and returns how many there were
+		int CopyFrames(ProfileFrame* frames, int maxFrames) const;
+		// number of frames that have finished
+		u32 GetFrameCount() const;
+		Profiler();
+		~Profiler();
+	private:
+		ProfileFrame* frames;
+		std::atomic<u32> finishedFrames; // frames are written in the slot after the last finished one, so this is bumped (after the frame's written) to publish it
+		ProfileFrame* current; // frame being recorded (NULL between frames)
+		// the profiler owns its frames, so it can't be copied
+		Profiler(const Profiler&);
+		Profiler& operator=(const Profiler&);
+};
+
+// times the rest of the scope it's in as one phase (the profiler can be NULL, in which case it does nothing)
+class ProfileScope {
+	public:
+		ProfileScope(Profiler* profiler, ProfilePhase phase) {
+			this->profiler = profiler;
+			event = profiler ? profiler->BeginPhase(phase) : -1;
+		}
+		~ProfileScope() { if (profiler) profiler->EndPhase(event); }
+	private:
+		Profiler* profiler;
+		int event;
+};
+
+// returns the name of a phase/counter (as used in traces)
+const char* GetProfilePhaseName(ProfilePhase phase);
+const char* GetProfileCounterName(ProfileCounter counter);
+
+// writes the latest frames (up to maxFrames) to a file as chrome trace event json (load it in chrome://tracing or perfetto), and returns false if the file can't be written
+bool WriteProfileTrace(const Profiler* profiler, const char* path, int maxFrames = PROFILE_FRAMES);
+
+// the graph in the overlay shows this many frames
+#define PROFILE_OVERLAY_FRAMES 120
+
+// draws the profiler overlay: a bar for the last frame's phases, and a graph of the latest frames' times, both against the 60hz frame budget (16.7ms, marked with a line)
+// (it only copies the last frame from the profiler each time it's drawn, and keeps its own history of frame times for the graph)
+class ProfileOverlay {
+	public:
+		// adds the overlay to a render queue (in RENDER_PASS_OVERLAY)
+		void Draw(const Profiler* profiler, RenderQueue* queue, f32 x, f32 y);
+		ProfileOverlay();
+	private:
+		ProfileFrame last; // copy of the last finished frame
+		u32 lastFrame; // which frame that was (from the profiler's count)
+		f32 frameTimes[PROFILE_OVERLAY_FRAMES]; // in seconds, as a ring buffer
+		int frameTimeCount;
+		int nextFrameTime;
+		Quad quad; // what everything's drawn with, moved and resized for each bar
+		// adds a rectangle to the queue with the quad
+		void DrawRectangle(RenderQueue* queue, f32 x, f32 y, f32 width, f32 height, GXColor color);
+};
+
+#endif
\ No newline at end of file
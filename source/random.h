@@ -0,0 +1,51 @@
+#ifndef TANK_RANDOM_H
+#define TANK_RANDOM_H
+
+#include <stdlib.h>
+#include <gccore.h>
+
+// small, fast random number generator (xoshiro128**) for everything that has to play out the same from a seed, like maps
+// it's all 32 bit shifts, rotates and multiplies, so it's as fast on the wii's 32 bit cpu as on a pc, and 16 bytes of state are cheap to pass around by pointer
+struct Random {
+	u32 state[4];
+};
+
+static inline u32 RotateLeft(u32 x, int bits) { return (x << bits) | (x >> (32 - bits)); }
+
+// seeds the generator (every seed gives a different stream; the state is filled with splitmix32 so similar seeds don't start out alike)
+static inline void SeedRandom(Random* random, u32 seed) {
+	for (int i = 0; i < 4; i++) {
+		seed += 0x9e3779b9;
+		u32 z = seed;
+		z = (z ^ (z >> 16)) * 0x85ebca6b;
+		z = (z ^ (z >> 13)) * 0xc2b2ae35;
+		random->state[i] = z ^ (z >> 16);
+	}
+	if (!(random->state[0] | random->state[1] | random->state[2] | random->state[3])) random->state[0] = 1; // all zeros would only ever give zeros
+}
+
+// returns the next 32 random bits
+static inline u32 NextRandom(Random* random) {
+	u32* s = random->state;
+	u32 result = RotateLeft(s[1] * 5, 7) * 9;
+	u32 t = s[1] << 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = RotateLeft(s[3], 11);
+	return result;
+}
+
+// returns a random number from 0 up to (not including) bound (scaled with a multiply instead of a divide, which is also less biased than %)
+static inline u32 RandomBelow(Random* random, u32 bound) { return ((u64) NextRandom(random) * bound) >> 32; }
+
+// returns 64 random bits where each bit is set with a 1/4 chance (two random words anded together)
+static inline u64 RandomQuarterBits(Random* random) {
+	u64 a = ((u64) NextRandom(random) << 32) | NextRandom(random);
+	u64 b = ((u64) NextRandom(random) << 32) | NextRandom(random);
+	return a & b;
+}
+
+#endif
\ No newline at end of file
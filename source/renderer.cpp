@@ -0,0 +1,151 @@
+#include "renderer.h"
+#include "angle.h"
+#include <algorithm>
+using namespace wsp;
+
+// fills in a quad's corners for a box centered on (centerX, centerY) with the given half width/height, turned by a libwiisprite rotation (in degrees/2)
+static void SetRenderQuadCorners(RenderQuad* quad, f32 centerX, f32 centerY, f32 halfWidth, f32 halfHeight, f32 rotation) {
+	Angle angle = HalfDegreesToAngle(rotation);
+	f32 cosAngle = AngleCosine(angle);
+	f32 sinAngle = AngleSine(angle);
+	static const f32 cornerX[4] = {-1, 1, 1, -1};
+	static const f32 cornerY[4] = {-1, -1, 1, 1};
+	for (int corner = 0; corner < 4; corner++) {
+		f32 offsetX = cornerX[corner] * halfWidth;
+		f32 offsetY = cornerY[corner] * halfHeight;
+		quad->x[corner] = centerX + offsetX * cosAngle - offsetY * sinAngle;
+		quad->y[corner] = centerY + offsetX * sinAngle + offsetY * cosAngle;
+	}
+}
+
+// works out the quad a sprite draws as: its frame of its image, zoomed/stretched and rotated around its center
+void GetSpriteRenderQuad(const Sprite* sprite, f32 offsetX, f32 offsetY, RenderQuad* quad) {
+	f32 width = sprite->GetWidth();
+	f32 height = sprite->GetHeight();
+	SetRenderQuadCorners(quad, sprite->GetX() + offsetX + width / 2, sprite->GetY() + offsetY + height / 2,
+		width / 2 * sprite->GetZoom() * sprite->GetStretchWidth(), height / 2 * sprite->GetZoom() * sprite->GetStretchHeight(), sprite->GetRotation());
+	// frames go across the image, then down
+	const Image* image = sprite->GetImage();
+	u32 columns = std::max(image->GetWidth() / std::max(sprite->GetWidth(), (u32) 1), (u32) 1);
+	quad->u0 = (sprite->GetFrame() % columns) * width / image->GetWidth();
+	quad->v0 = (sprite->GetFrame() / columns) * height / image->GetHeight();
+	quad->u1 = quad->u0 + width / image->GetWidth();
+	quad->v1 = quad->v0 + height / image->GetHeight();
+	quad->color = (GXColor) {255, 255, 255, sprite->GetTransparency()};
+}
+
+// works out the quad a quad layer draws as: a box filled with its color, rotated around its center
+void GetQuadRenderQuad(const Quad* quad, f32 offsetX, f32 offsetY, RenderQuad* renderQuad) {
+	f32 width = quad->GetWidth();
+	f32 height = quad->GetHeight();
+	SetRenderQuadCorners(renderQuad, quad->GetX() + offsetX + width / 2, quad->GetY() + offsetY + height / 2, width / 2, height / 2, quad->GetRotation());
+	renderQuad->u0 = 0;
+	renderQuad->v0 = 0;
+	renderQuad->u1 = 1;
+	renderQuad->v1 = 1;
+	renderQuad->color = quad->GetFillColor();
+}
+
+// compiles quad layers into a display list
+RenderDisplayList* CompileQuadLayers(const LayerManager* manager, int first, int last) {
+	std::vector<RenderQuad> quads;
+	for (int i = first; i < last; i++) {
+		const Quad* quad = (const Quad*) manager->GetLayerAt(i);
+		if (!quad->IsVisible()) continue;
+		quads.push_back(RenderQuad());
+		GetQuadRenderQuad(quad, 0, 0, &quads.back());
+	}
+	return quads.empty() ? NULL : CompileRenderDisplayList(&quads[0], quads.size(), false);
+}
+
+void RenderQueue::AddSprite(RenderPass pass, const Sprite* sprite, f32 offsetX, f32 offsetY) {
+	if (!sprite->IsVisible() || !sprite->GetImage()) return;
+	RenderQuad quad;
+	GetSpriteRenderQuad(sprite, offsetX, offsetY, &quad);
+	Add(pass, sprite->GetImage(), NULL, &quad);
+}
+
+void RenderQueue::AddQuad(RenderPass pass, const Quad* quad, f32 offsetX, f32 offsetY) {
+	if (!quad->IsVisible()) return;
+	RenderQuad renderQuad;
+	GetQuadRenderQuad(quad, offsetX, offsetY, &renderQuad);
+	Add(pass, NULL, NULL, &renderQuad);
+}
+
+void RenderQueue::AddSprites(RenderPass pass, const LayerManager* manager, int first, int last) {
+	if (last < 0) last = manager->GetSize();
+	for (int i = first; i < last; i++) AddSprite(pass, (const Sprite*) manager->GetLayerAt(i));
+}
+
+void RenderQueue::AddQuads(RenderPass pass, const LayerManager* manager, int first, int last) {
+	if (last < 0) last = manager->GetSize();
+	for (int i = first; i < last; i++) AddQuad(pass, (const Quad*) manager->GetLayerAt(i));
+}
+
+void RenderQueue::AddDisplayList(RenderPass pass, RenderDisplayList* list, const Image* image) {
+	if (list) Add(pass, image, list, NULL);
+}
+
+void RenderQueue::Add(RenderPass pass, const Image* image, RenderDisplayList* list, const RenderQuad* quad) {
+	// textures get slots in the order they're first used, so sorting by slot keeps the draw order the same from frame to frame
+	u32 slot = 0;
+	if (image) {
+		slot = std::find(slots.begin(), slots.end(), image) - slots.begin() + 1;
+		if (slot > slots.size()) slots.push_back(image);
+	}
+	commands.push_back(Command());
+	Command* command = &commands.back();
+	command->key = (u64) pass << 56 | (u64) slot << 32 | (commands.size() - 1);
+	command->image = image;
+	command->list = list;
+	if (quad) command->quad = *quad;
+}
+
+// draws everything that's been added, and empties the queue
+void RenderQueue::Flush() {
+	drawCalls = 0;
+	stateChanges = 0;
+	quadCount = 0;
+	order.resize(commands.size());
+	for (int i = 0; i < (int) commands.size(); i++) order[i] = i;
+	std::sort(order.begin(), order.end(), [this](int a, int b) { return commands[a].key < commands[b].key; });
+	// go through in order, gathering quads into a batch until the texture changes (or a display list comes up), then drawing the batch
+	const Image* texture = NULL;
+	bool textureSet = false;
+	for (int i = 0; i <= (int) order.size(); i++) {
+		const Command* command = i < (int) order.size() ? &commands[order[i]] : NULL;
+		if (!batch.empty() && (!command || command->list || command->image != texture)) {
+			DrawRenderQuads(&batch[0], batch.size());
+			drawCalls++;
+			quadCount += batch.size();
+			batch.clear();
+		}
+		if (!command) break;
+		if (!textureSet || command->image != texture) {
+			SetRenderTexture(command->image);
+			texture = command->image;
+			textureSet = true;
+			stateChanges++;
+		}
+		if (command->list) {
+			CallRenderDisplayList(command->list);
+			drawCalls++;
+			quadCount += GetRenderDisplayListQuadCount(command->list);
+		}
+		else {
+			batch.push_back(command->quad);
+		}
+	}
+	commands.clear();
+	slots.clear();
+}
+
+int RenderQueue::GetDrawCalls() const { return drawCalls; }
+int RenderQueue::GetStateChanges() const { return stateChanges; }
+int RenderQueue::GetQuadCount() const { return quadCount; }
+
+RenderQueue::RenderQueue() {
+	drawCalls = 0;
+	stateChanges = 0;
+	quadCount = 0;
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef TANK_RENDERER_H
+#define TANK_RENDERER_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+#include <vector>
+
+using namespace wsp;
+
+// command buffer for drawing: layers are added to a RenderQueue as screen space quads (in passes, which are drawn in order), and Flush sorts each pass
+// by texture and draws every run of quads with the same texture in one go, so the gpu's state only changes when the texture does
+// things that never move (the walls that don't spin) can be compiled into a display list once and replayed every frame instead
+// the backend (renderer_wii.cpp with gx on the wii, host/renderer_host.cpp on a pc, which records the commands instead of drawing them) is just the few functions at the bottom
+
+// the passes, in the order they're drawn (anything in a later pass is drawn over anything in an earlier one; within a pass, the order is only kept for quads with the same texture)
+enum RenderPass {
+	RENDER_PASS_BACKGROUND,
+	RENDER_PASS_BULLETS,
+	RENDER_PASS_WALLS,
+	RENDER_PASS_TANKS,
+	RENDER_PASS_EXPLOSIONS,
+	RENDER_PASS_MENU,
+	RENDER_PASS_CURSORS,
+	RENDER_PASS_OVERLAY,
+	RENDER_PASS_COUNT
+};
+
+// a quad to draw: its corners on screen (clockwise from the top left, before rotation), the part of its texture to show, and the color to multiply it by (or fill it with, if it has no texture)
+struct RenderQuad {
+	f32 x[4];
+	f32 y[4];
+	f32 u0;
+	f32 v0;
+	f32 u1;
+	f32 v1;
+	GXColor color;
+};
+
+// quads compiled ahead of time so they can be drawn again and again with one call (a gx display list on the wii)
+struct RenderDisplayList;
+
+// works out the quad a sprite/quad layer draws as (in the same place libwiisprite would draw it, with the given offset)
+void GetSpriteRenderQuad(const Sprite* sprite, f32 offsetX, f32 offsetY, RenderQuad* quad);
+void GetQuadRenderQuad(const Quad* quad, f32 offsetX, f32 offsetY, RenderQuad* renderQuad);
+
+// compiles the (untextured) quad layers from first up to (not including) last of a layer manager into a display list (returns NULL if there's nothing to compile, or it can't be)
+RenderDisplayList* CompileQuadLayers(const LayerManager* manager, int first, int last);
+
+class RenderQueue {
+	public:
+		// adds a sprite/quad layer, as it is now (so it can be moved again straight away); invisible layers are skipped
+		void AddSprite(RenderPass pass, const Sprite* sprite, f32 offsetX = 0, f32 offsetY = 0);
+		void AddQuad(RenderPass pass, const Quad* quad, f32 offsetX = 0, f32 offsetY = 0);
+		// adds the layers from first up to (not including) last of a layer manager (last < 0 for all of them), which must all be sprites/quads
+		void AddSprites(RenderPass pass, const LayerManager* manager, int first = 0, int last = -1);
+		void AddQuads(RenderPass pass, const LayerManager* manager, int first = 0, int last = -1);
+		// adds a display list (drawn untextured, or with the given image), which must still exist when the queue's flushed
+		void AddDisplayList(RenderPass pass, RenderDisplayList* list, const Image* image = NULL);
+		// draws everything that's been added, and empties the queue
+		void Flush();
+		// what the last flush did: batches drawn (display lists included), texture/state changes, and quads drawn (display lists' included)
+		int GetDrawCalls() const;
+		int GetStateChanges() const;
+		int GetQuadCount() const;
+		RenderQueue();
+	private:
+		// one thing to draw: a quad, or a display list (sorted by key, which is the pass, then the texture's slot, then the order it was added)
+		struct Command {
+			u64 key;
+			const Image* image;
+			RenderDisplayList* list; // NULL for a quad
+			RenderQuad quad;
+		};
+		std::vector<Command> commands;
+		std::vector<const Image*> slots; // every texture used since the last flush (a texture's slot is its index, plus 1; 0 is no texture)
+		std::vector<int> order; // commands' indices, sorted
+		std::vector<RenderQuad> batch; // quads waiting to be drawn together
+		int drawCalls;
+		int stateChanges;
+		int quadCount;
+		void Add(RenderPass pass, const Image* image, RenderDisplayList* list, const RenderQuad* quad);
+};
+
+// the backend:
+// sets the texture quads are drawn with (NULL to fill them with their color instead)
+void SetRenderTexture(const Image* image);
+// draws quads with the texture that's set
+void DrawRenderQuads(const RenderQuad* quads, int count);
+// compiles quads into a display list (returns NULL if it can't), draws one with the texture that's set, and frees one
+RenderDisplayList* CompileRenderDisplayList(const RenderQuad* quads, int count, bool textured);
+void CallRenderDisplayList(RenderDisplayList* list);
+int GetRenderDisplayListQuadCount(const RenderDisplayList* list);
+void FreeRenderDisplayList(RenderDisplayList* list);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "renderer.h"
+#include "tiledimage.h"
+#include <malloc.h>
+#include <string.h>
+#include <algorithm>
+using namespace wsp;
+
+// the gx backend: quads are sent already in screen space (with an identity position matrix, under libwiisprite's screen sized orthographic projection),
+// as positions (2 f32s), colors (rgba8), and texture coordinates (2 f32s, only when textured) in a vertex format libwiisprite doesn't use
+
+#define RENDER_VTXFMT GX_VTXFMT7
+
+// gx can draw at most 65535 vertices in one go
+#define RENDER_MAX_BATCH_QUADS (65535 / 4)
+
+struct RenderDisplayList {
+	void* data; // 32 byte aligned, as gx needs
+	u32 size;
+	int quadCount;
+};
+
+static bool renderTextured;
+
+static_assert(TILED_TEXTURE_I8 == GX_TF_I8 && TILED_TEXTURE_RGB5A3 == GX_TF_RGB5A3 && TILED_TEXTURE_RGBA8 == GX_TF_RGBA8, "tiled texture formats don't match gx's");
+
+// points a tiled image's texture object (libwiisprite's, so BindTexture loads it like any other image's) straight at its tiles, with the same clamping and filtering libwiisprite uses
+void TiledImage::InitTexture(const u8* tiles) {
+	GX_InitTexObj(&_texObj, (void*) tiles, _width, _height, format, GX_CLAMP, GX_CLAMP, GX_FALSE);
+	GX_InitTexObjLOD(&_texObj, GX_LINEAR, GX_LINEAR, 0, 0, 0, GX_FALSE, GX_FALSE, GX_ANISO_1);
+}
+
+// sets the texture quads are drawn with (NULL to fill them with their color instead)
+void SetRenderTexture(const Image* image) {
+	renderTextured = image != NULL;
+	Mtx identity;
+	guMtxIdentity(identity);
+	GX_LoadPosMtxImm(identity, GX_PNMTX0);
+	GX_ClearVtxDesc();
+	GX_SetVtxDesc(GX_VA_POS, GX_DIRECT);
+	GX_SetVtxDesc(GX_VA_CLR0, GX_DIRECT);
+	GX_SetVtxDesc(GX_VA_TEX0, renderTextured ? GX_DIRECT : GX_NONE);
+	GX_SetVtxAttrFmt(RENDER_VTXFMT, GX_VA_POS, GX_POS_XY, GX_F32, 0);
+	GX_SetVtxAttrFmt(RENDER_VTXFMT, GX_VA_CLR0, GX_CLR_RGBA, GX_RGBA8, 0);
+	GX_SetVtxAttrFmt(RENDER_VTXFMT, GX_VA_TEX0, GX_TEX_ST, GX_F32, 0);
+	if (renderTextured) {
+		((Image*) image)->BindTexture(); // libwiisprite loads it into GX_TEXMAP0
+		GX_SetNumTexGens(1);
+		GX_SetTexCoordGen(GX_TEXCOORD0, GX_TG_MTX2x4, GX_TG_TEX0, GX_IDENTITY);
+		GX_SetTevOrder(GX_TEVSTAGE0, GX_TEXCOORD0, GX_TEXMAP0, GX_COLOR0A0);
+		GX_SetTevOp(GX_TEVSTAGE0, GX_MODULATE);
+	}
+	else {
+		GX_SetNumTexGens(0);
+		GX_SetTevOrder(GX_TEVSTAGE0, GX_TEXCOORDNULL, GX_TEXMAP_NULL, GX_COLOR0A0);
+		GX_SetTevOp(GX_TEVSTAGE0, GX_PASSCLR);
+	}
+}
+
+// sends quads' vertices (inside a GX_Begin/GX_End, or while a display list is being compiled)
+static void SendRenderQuads(const RenderQuad* quads, int count, bool textured) {
+	GX_Begin(GX_QUADS, RENDER_VTXFMT, count * 4);
+	for (int i = 0; i < count; i++) {
+		const RenderQuad* quad = &quads[i];
+		f32 u[4] = {quad->u0, quad->u1, quad->u1, quad->u0};
+		f32 v[4] = {quad->v0, quad->v0, quad->v1, quad->v1};
+		for (int corner = 0; corner < 4; corner++) {
+			GX_Position2f32(quad->x[corner], quad->y[corner]);
+			GX_Color4u8(quad->color.r, quad->color.g, quad->color.b, quad->color.a);
+			if (textured) GX_TexCoord2f32(u[corner], v[corner]);
+		}
+	}
+	GX_End();
+}
+
+// draws quads with the texture that's set
+void DrawRenderQuads(const RenderQuad* quads, int count) {
+	for (int first = 0; first < count; first += RENDER_MAX_BATCH_QUADS) {
+		SendRenderQuads(quads + first, std::min(count - first, RENDER_MAX_BATCH_QUADS), renderTextured);
+	}
+}
+
+// compiles quads into a display list (returns NULL if it can't)
+RenderDisplayList* CompileRenderDisplayList(const RenderQuad* quads, int count, bool textured) {
+	if (count > RENDER_MAX_BATCH_QUADS) return NULL;
+	// room for the draw command (3 bytes) and every vertex, rounded up to gx's 32 bytes (plus 32 more, since gx needs some spare at the end)
+	u32 size = ((3 + count * 4 * (textured ? 20 : 12) + 31) & ~31) + 32;
+	void* data = memalign(32, size);
+	if (!data) return NULL;
+	// gx writes the list through its write gather pipe, so nothing of it can be sitting in the cache
+	DCInvalidateRange(data, size);
+	// the vertex format has to be set up before the vertices go in (and again each time it's called)
+	GX_SetVtxAttrFmt(RENDER_VTXFMT, GX_VA_POS, GX_POS_XY, GX_F32, 0);
+	GX_SetVtxAttrFmt(RENDER_VTXFMT, GX_VA_CLR0, GX_CLR_RGBA, GX_RGBA8, 0);
+	GX_SetVtxAttrFmt(RENDER_VTXFMT, GX_VA_TEX0, GX_TEX_ST, GX_F32, 0);
+	GX_BeginDispList(data, size);
+	SendRenderQuads(quads, count, textured);
+	u32 used = GX_EndDispList();
+	if (!used) { // it didn't fit
+		free(data);
+		return NULL;
+	}
+	RenderDisplayList* list = new RenderDisplayList();
+	list->data = data;
+	list->size = used;
+	list->quadCount = count;
+	return list;
+}
+
+// draws a display list with the texture that's set
+void CallRenderDisplayList(RenderDisplayList* list) { GX_CallDispList(list->data, list->size); }
+
+int GetRenderDisplayListQuadCount(const RenderDisplayList* list) { return list->quadCount; }
+
+void FreeRenderDisplayList(RenderDisplayList* list) {
+	if (!list) return;
+	free(list->data);
+	delete list;
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "replay.h"
+
+// the flags byte: bit (player) is set if the player's held buttons changed, bit (4 + player) if they pressed anything
+#define REPLAY_FLAG_HELD(player) (1 << (player))
+#define REPLAY_FLAG_DOWN(player) (1 << (4 + (player)))
+
+#define REPLAY_HEADER_SIZE 24
+
+// the smallest and largest a step can be: the flags byte and the state hash, plus a held and a down mask for every player at most
+#define REPLAY_MIN_STEP_SIZE 5
+#define REPLAY_MAX_STEP_SIZE (5 + MAX_PLAYERS * 4)
+
+// little endian reading/writing, so files are the same everywhere
+static void WriteU16(std::vector<u8>* data, u16 value) {
+	data->push_back(value & 0xff);
+	data->push_back(value >> 8);
+}
+static void WriteU32(std::vector<u8>* data, u32 value) {
+	for (int i = 0; i < 4; i++) data->push_back((value >> (8 * i)) & 0xff);
+}
+static u16 ReadU16(const u8* bytes) { return bytes[0] | (bytes[1] << 8); }
+static u32 ReadU32(const u8* bytes) { return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((u32) bytes[3] << 24); }
+
+// empties a replay and sets it up to record a game with the given seed, tank count, and ammo
+void StartReplayRecording(Replay* replay, u32 seed, int tankCount, int ammo) {
+	replay->seed = seed;
+	replay->tankCount = tankCount;
+	replay->ammo = ammo;
+	replay->stepCount = 0;
+	replay->data.clear();
+	replay->data.reserve(64 * 1024); // a few minutes' worth, so a game doesn't have to grow it much while it's being played
+	RewindReplay(replay);
+}
+
+// adds a step to the end of a replay: the input it was run with and the hash of the state it led to
+void RecordReplayStep(Replay* replay, const InputState* input, u32 stateHash) {
+	u8 flags = 0;
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		if ((u16) input->players[player].held != replay->held[player]) flags |= REPLAY_FLAG_HELD(player);
+		if ((u16) input->players[player].down) flags |= REPLAY_FLAG_DOWN(player);
+	}
+	replay->data.push_back(flags);
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		if (flags & REPLAY_FLAG_HELD(player)) {
+			replay->held[player] = input->players[player].held;
+			WriteU16(&replay->data, replay->held[player]);
+		}
+		if (flags & REPLAY_FLAG_DOWN(player)) WriteU16(&replay->data, input->players[player].down);
+	}
+	WriteU32(&replay->data, stateHash);
+	replay->stepCount++;
+	replay->step++;
+	replay->position = replay->data.size();
+}
+
+// goes back to the first step for playback
+void RewindReplay(Replay* replay) {
+	replay->step = 0;
+	replay->position = 0;
+	for (int player = 0; player < MAX_PLAYERS; player++) replay->held[player] = 0;
+}
+
+// reads the next step's input and the hash of the state it should lead to (returns false if there are no steps left)
+bool ReadReplayStep(Replay* replay, InputState* input, u32* stateHash) {
+	if (replay->step >= replay->stepCount) return false;
+	const u8* bytes = replay->data.data();
+	u32 size = replay->data.size();
+	if (replay->position >= size) return false;
+	u8 flags = bytes[replay->position++];
+	for (int player = 0; player < MAX_PLAYERS; player++) {
+		PlayerInput* playerInput = &input->players[player];
+		playerInput->down = 0;
+		if (flags & REPLAY_FLAG_HELD(player)) {
+			if (replay->position + 2 > size) return false;
+			replay->held[player] = ReadU16(bytes + replay->position);
+			replay->position += 2;
+		}
+		if (flags & REPLAY_FLAG_DOWN(player)) {
+			if (replay->position + 2 > size) return false;
+			playerInput->down = ReadU16(bytes + replay->position);
+			replay->position += 2;
+		}
+		playerInput->held = replay->held[player];
+		playerInput->pointerX = -100;
+		playerInput->pointerY = -100;
+		playerInput->pointerAngle = 0;
+	}
+	if (replay->position + 4 > size) return false;
+	*stateHash = ReadU32(bytes + replay->position);
+	replay->position += 4;
+	replay->step++;
+	return true;
+}
+
+// writes a replay to a file (returning false if it can't)
+bool SaveReplay(const Replay* replay, const char* path) {
+	std::vector<u8> header;
+	header.insert(header.end(), REPLAY_MAGIC, REPLAY_MAGIC + 4);
+	WriteU16(&header, REPLAY_VERSION);
+	WriteU16(&header, replay->ammo);
+	WriteU32(&header, replay->seed);
+	WriteU32(&header, replay->tankCount);
+	WriteU32(&header, replay->stepCount);
+	WriteU32(&header, replay->data.size());
+	FILE* file = fopen(path, "wb");
+	if (!file) return false;
+	bool written = fwrite(header.data(), 1, header.size(), file) == header.size() && fwrite(replay->data.data(), 1, replay->data.size(), file) == replay->data.size();
+	return fclose(file) == 0 && written;
+}
+
+// reads a replay from a file (returning false if it can't, or if the file isn't a valid replay)
+// the header's sizes are checked against the file before anything's allocated for them, so a truncated or corrupt file can't ask for more memory than it has data
+bool LoadReplay(Replay* replay, const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (!file) return false;
+	long fileSize = -1;
+	if (!fseek(file, 0, SEEK_END)) fileSize = ftell(file);
+	u8 header[REPLAY_HEADER_SIZE];
+	bool valid = fileSize >= REPLAY_HEADER_SIZE && !fseek(file, 0, SEEK_SET);
+	valid = valid && fread(header, 1, REPLAY_HEADER_SIZE, file) == REPLAY_HEADER_SIZE && !memcmp(header, REPLAY_MAGIC, 4) && ReadU16(header + 4) == REPLAY_VERSION;
+	if (valid) {
+		replay->ammo = ReadU16(header + 6);
+		replay->seed = ReadU32(header + 8);
+		replay->tankCount = ReadU32(header + 12);
+		replay->stepCount = ReadU32(header + 16);
+		u32 dataSize = ReadU32(header + 20);
+		// the data has to be what's left of the file, and the right size for that many steps
+		valid = dataSize == (u64) fileSize - REPLAY_HEADER_SIZE
+			&& dataSize >= (u64) replay->stepCount * REPLAY_MIN_STEP_SIZE && dataSize <= (u64) replay->stepCount * REPLAY_MAX_STEP_SIZE;
+		if (valid) replay->data.resize(dataSize);
+		valid = valid && fread(replay->data.data(), 1, replay->data.size(), file) == replay->data.size();
+	}
+	if (!valid) {
+		replay->stepCount = 0;
+		replay->data.clear();
+	}
+	fclose(file);
+	RewindReplay(replay);
+	return valid;
+}
+
+// state hashes are fnv-1a, done a byte at a time in little endian order
+u32 AddToStateHash(u32 hash, u32 value) {
+	for (int i = 0; i < 4; i++) {
+		hash ^= (value >> (8 * i)) & 0xff;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+u32 AddToStateHash(u32 hash, f32 value) {
+	u32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return AddToStateHash(hash, bits);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef TANK_REPLAY_H
+#define TANK_REPLAY_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <gccore.h>
+#include <vector>
+
+#include "platform.h"
+
+// a replay is everything needed to play a game again exactly: the game's seed (which every round's map comes from), the tank count and ammo,
+// and the buttons every player had on every simulation step, along with a hash of the game's state after each step so playback can tell if it went differently
+//
+// steps are stored as a flags byte saying which players' held buttons changed and which players pressed something, then those players' button masks (2 bytes each),
+// then the 4 byte state hash, so a typical step is 5 bytes
+// files are a 24 byte header (REPLAY_MAGIC, version, ammo, seed, tank count, step count, data size) and then the steps, all little endian so they're the same on the wii and a pc
+
+#define REPLAY_MAGIC "WTRP"
+#define REPLAY_VERSION 3 // 2: maps come from the xoshiro generator, so version 1 seeds make different maps; 3: every tank moves before any is hit or shoots
+
+struct Replay {
+	u32 seed;
+	int tankCount;
+	int ammo;
+	u32 stepCount;
+	std::vector<u8> data; // encoded steps
+	// where recording/playback is up to
+	u32 step;
+	u32 position; // in data
+	u16 held[MAX_PLAYERS]; // each player's held buttons on the last step
+};
+
+// empties a replay and sets it up to record a game with the given seed, tank count, and ammo
+void StartReplayRecording(Replay* replay, u32 seed, int tankCount, int ammo);
+
+// adds a step to the end of a replay: the input it was run with and the hash of the state it led to
+void RecordReplayStep(Replay* replay, const InputState* input, u32 stateHash);
+
+// goes back to the first step for playback
+void RewindReplay(Replay* replay);
+
+// reads the next step's input and the hash of the state it should lead to (returns false if there are no steps left)
+// (replays only have buttons, so the pointers are put off screen)
+bool ReadReplayStep(Replay* replay, InputState* input, u32* stateHash);
+
+// writes a replay to a file / reads one from a file (returning false if it can't, or if the file isn't a valid replay)
+bool SaveReplay(const Replay* replay, const char* path);
+bool LoadReplay(Replay* replay, const char* path);
+
+// state hashes are built up by adding values to them one at a time, starting from STATE_HASH_START (this is fnv-1a, done a byte at a time in little endian order,
+// so it comes out the same on big and little endian machines)
+#define STATE_HASH_START 2166136261u
+u32 AddToStateHash(u32 hash, u32 value);
+u32 AddToStateHash(u32 hash, f32 value);
+
+#endif
\ No newline at end of file
@@ -1,24 +1,30 @@
 #include "tank.h"
 using namespace wsp;
 
-// updates tank given player inputs (returns 0 if tank dies, 1 otherwise)
-void Tank::Update(LayerManager* tankManager, LayerManager* wallManager, LayerManager* bulletManager, LayerManager* explosionManager) {
+// moves the tank given player inputs, pushing it out of walls
+void Tank::Update(const InputState* input, f32 timeScale, WallGrid* wallGrid) {
 	// get inputs
-	u16 buttonsHeld = WPAD_ButtonsHeld(player);
-	u16 buttonsDown = WPAD_ButtonsDown(player);
+	u32 buttonsHeld = input->players[player].held;
 	// variables for button holding for the sake of conciseness/readability (directions corrected for sideways wiimote, also as of v1.1 up is 2 instead of d-pad)
-	u16 upHeld = buttonsHeld & WPAD_BUTTON_2;
-	u16 downHeld = buttonsHeld & WPAD_BUTTON_LEFT;
-	u16 leftHeld = buttonsHeld & WPAD_BUTTON_UP;
-	u16 rightHeld = buttonsHeld & WPAD_BUTTON_DOWN;
+	u32 upHeld = buttonsHeld & BUTTON_2;
+	u32 downHeld = buttonsHeld & BUTTON_LEFT;
+	u32 leftHeld = buttonsHeld & BUTTON_UP;
+	u32 rightHeld = buttonsHeld & BUTTON_DOWN;
 	// some other variables for animation and movement
 	bool tankMoved = (upHeld || downHeld) && !(upHeld && downHeld); // true if tank will attempt to move forwards/backwards this frame (up or down is held, but not both)
-	f32 radRotation = GetRotation() * 2.0 * (M_PI / 180.0); // convert rotation (in degrees/2) to radians
-	// movement
-	if (rightHeld) SetRotation( fmod((GetRotation() + turnSpeed),  180.0)); // go clockwise but stay in 0-180 (0-360 degrees)
-	if (leftHeld) SetRotation( fmod((GetRotation() - turnSpeed),  180.0)); // go counterclockwise but stay in 0-180 (0-360 degrees)
-	if (upHeld) Move(moveSpeed * cos(radRotation), moveSpeed * sin(radRotation));
-	if (downHeld) Move(-moveSpeed * cos(radRotation), -moveSpeed * sin(radRotation));
+	Angle heading = HalfDegreesToAngle(GetRotation()); // convert rotation (in degrees/2) to an angle
+	f32 cosHeading = AngleCosine(heading);
+	f32 sinHeading = AngleSine(heading);
+	// movement (turning wraps around on its own, so rotation stays in 0-180 (0-360 degrees))
+	if (rightHeld || leftHeld) {
+		Angle turn = HalfDegreesToAngle(turnSpeed * timeScale);
+		if (rightHeld) heading = heading + turn; // clockwise
+		if (leftHeld) heading = heading - turn; // counterclockwise
+		SetRotation(AngleToHalfDegrees(heading));
+	}
+	f32 stepDistance = moveSpeed * timeScale;
+	if (upHeld) Move(stepDistance * cosHeading, stepDistance * sinHeading);
+	if (downHeld) Move(-stepDistance * cosHeading, -stepDistance * sinHeading);
 	// animation
 	animFrame = (animFrame + 1) % 3; // this is set to 0 every 3 calls; this way, the tank animates every 3 frames
 	if (animFrame == 0) {
@@ -26,52 +32,54 @@ void Tank::Update(LayerManager* tankManager, LayerManager* wallManager, LayerMan
 		if (!tankMoved && rightHeld) Animate(true); // animate forwards for clockwise, backwards for counterclockwise (if tank isn't moving already)
 		if (!tankMoved && leftHeld) Animate(false);
 	}
-	// wall collision check
-	for (int i = 0; i < (int) wallManager->GetSize(); i++) {
-		Quad* wall = (Quad*) wallManager->GetLayerAt(i);
-		if (CollisionPossible((Sprite*) this, wall)) {
-			std::vector<f32> collision = Collision((Sprite*) this, wall);
-			if (collision[2] != 0) {
-				f32 axisMultiplier = collision[2] / sqrt(pow(collision[0], 2) + pow(collision[1], 2));
-				Move(collision[0] * axisMultiplier, collision[1] * axisMultiplier);
-			};
-		};
-	};
-	// bullet collision check
-	for (int i = 0; i < (int) bulletManager->GetSize(); i++) {
-		Bullet* bullet = (Bullet*) bulletManager->GetLayerAt(i);
-		if (CollisionPossible((Sprite*) this, (Sprite*) bullet)) {
-			std::vector<f32> collision = Collision((Sprite*) this, (Sprite*) bullet);
-			if (collision[2] != 0) {
-				bullet->Destroy(bulletManager);
-                life--;
-				if (!life) {
-					Destroy(tankManager, explosionManager);
-					return;
-				}
-			};
-		};
+	// wall collision check (every nearby wall the tank is in is found in one pass, then it's pushed out of them one at a time in wall order)
+	box = GetOrientedBox((Sprite*) this);
+	WallContact wallContacts[WALLBATCH_MAX_CONTACTS];
+	int wallContactCount = wallGrid ? QueryWallGrid(wallGrid, &box, wallContacts, WALLBATCH_MAX_CONTACTS) : 0;
+	for (int i = 0; i < wallContactCount; i++) {
+		// redo the test for this wall, since pushing out of the previous ones may have already fixed it
+		if (i) box = GetOrientedBox((Sprite*) this);
+		OrientedBox wall = GetWallBox(&wallGrid->walls, wallContacts[i].wall);
+		Contact collision = Collision(&box, &wall);
+		if (collision.overlap != 0) Move(collision.axis.x * collision.overlap, collision.axis.y * collision.overlap); // axis is already normalized
 	};
-	// 1 (shoot bullet)
-	if (buttonsDown & WPAD_BUTTON_1 && HasAmmo(bulletManager)) Shoot(wallManager, bulletManager);
+	// the tank is done moving for this frame, so its box is worked out once here for everything else that tests against it
+	if (wallContactCount) box = GetOrientedBox((Sprite*) this);
+	bounds = GetBoxBounds(&box);
+}
+// tests the tank against a bullet, and takes a life if it's hit (a bullet's box is axis aligned, so its half width/height are also its bounds)
+bool Tank::TestHit(const BulletSystem* bullets, int bullet) {
+	OrientedBox bulletBox = bullets->GetBox(bullet);
+	if (!BoundsOverlap(box.center, bounds, bulletBox.center, bulletBox.halfExtents)) return false;
+	if (Collision(&box, &bulletBox).overlap == 0) return false;
+	life--;
+	return true;
 }
-void Tank::SetMoveSpeed(f32 moveSpeed) { this->moveSpeed = moveSpeed; }
-void Tank::SetTurnSpeed(f32 turnSpeed) { this->turnSpeed = turnSpeed; }
-f32 Tank::GetInitialMoveSpeed() { return initialMoveSpeed; }
-f32 Tank::GetInitialTurnSpeed() { return initialTurnSpeed; }
+// shoots if the player pressed fire (1) this step and the tank has ammo left (returns true if it shot)
+bool Tank::Fire(const InputState* input, BulletSystem* bullets) {
+	return input->players[player].down & BUTTON_1 && HasAmmo(bullets) && Shoot(bullets);
+}
+void Tank::SavePose() { previousPose = GetPose((Sprite*) this); }
+const LayerPose* Tank::GetPreviousPose() { return &previousPose; }
+const OrientedBox* Tank::GetBox() { return &box; }
+Vec2 Tank::GetBounds() { return bounds; }
 // deletes the tank and removes it from the specified manager
 void Tank::Destroy(LayerManager* tankManager, LayerManager* explosionManager) {
-	if (explosionManager) explosionManager->Append(new Explosion(GetX() + GetWidth() / 2, GetY() + GetHeight() / 2));
+	if (explosionManager) {
+		Explosion* explosion = new (&pools->explosions) Explosion(GetX() + GetWidth() / 2, GetY() + GetHeight() / 2, textures, sounds);
+		if (explosion) explosionManager->Append(explosion);
+	}
     tankManager->Remove(this);
-	delete this->GetImage();
     delete this;
 }
 // constructor
-Tank::Tank(int player, int ammo) {
+Tank::Tank(int player, int ammo, EntityPools* pools, TextureCache* textures, SoundQueue* sounds) {
 	this->player = player;
 	this->ammo = ammo;
-	Image* tankImg = new Image();
-	tankImg->LoadImage(tanks_png); // tanks_png is an image that comes from an image include
+	this->pools = pools;
+	this->textures = textures;
+	this->sounds = sounds;
+	Image* tankImg = textures->Acquire(TEXTURE_TANKS); // every tank shares one copy of the sheet
 	SetImage(tankImg, tankImg->GetWidth()/8, tankImg->GetHeight()/4); // image is an 8x4 grid
 	SetFrame(player * 8); // 8 frames per player
 	SetStretchWidth(.75);
@@ -79,40 +87,42 @@ Tank::Tank(int player, int ammo) {
 	// tanks fit in a ~28x24 rectangle on their image (note: only width/height are relevant, offset is a libwiisprite feature that is not used)
 	// note: this is pixels on image, not on ingame sprite, which is smaller due to its .75 multiplier above
 	DefineCollisionRectangle(0, 0, 28, 24);
+	box = GetOrientedBox((Sprite*) this);
+	bounds = GetBoxBounds(&box);
 	// speeds default to these values, currently there is no reason for them to vary
 	moveSpeed = 2.0;
 	turnSpeed = 1.5;
-	initialMoveSpeed = moveSpeed;
-	initialTurnSpeed = turnSpeed;
+	SavePose();
     life = 1;
 }
+Tank::~Tank() { textures->Release(TEXTURE_TANKS); }
 // returns true if the tank has fewer than (ammo) shots on the map
-bool Tank::HasAmmo(LayerManager* bulletManager) {
-	int activeBullets = 0;
-	for (int i = 0; i < (int) bulletManager->GetSize(); i++) {
-		Bullet* bullet = (Bullet*) bulletManager->GetLayerAt(i);
-		if (bullet->GetPlayer() == player) activeBullets++;
-	}
-	return activeBullets < ammo;
-}
-// shoots a bullet
-void Tank::Shoot(LayerManager* wallManager, LayerManager* bulletManager) {
+bool Tank::HasAmmo(BulletSystem* bullets) { return bullets->GetPlayerCount(player) < ammo; }
+// shoots a bullet (returns false if there's no room for it)
+bool Tank::Shoot(BulletSystem* bullets) {
 	// spawn bullet at the front of the tank, subtracting speed to spawn it inside initially (it'll move before collision detection)
 	f32 bulletRadius = 2.0;
-	f32 bulletSpeed = initialMoveSpeed * 2.0;
-	f32 radRotation = GetRotation() * 2.0 * (M_PI / 180.0); // convert rotation (in degrees/2) to radians
-	f32 bulletX = GetX() + GetWidth() / 2 + cos(radRotation) * (12 + bulletRadius) - cos(radRotation) * bulletSpeed;
-	f32 bulletY = GetY() + GetHeight() / 2 + sin(radRotation) * (12 + bulletRadius) - sin(radRotation) * bulletSpeed;
-	Bullet* bullet = new Bullet(player, bulletRadius, bulletSpeed);
-	bullet->SetPosition(bulletX - bullet->GetWidth() / 2, bulletY - bullet->GetHeight() / 2); // center bullet on bulletX and bulletY
-	bullet->SetRotation(GetRotation());
-	bulletManager->Append(bullet);
+	f32 bulletSpeed = moveSpeed * 2.0;
+	Angle heading = HalfDegreesToAngle(GetRotation()); // convert rotation (in degrees/2) to an angle
+	f32 cosHeading = AngleCosine(heading);
+	f32 sinHeading = AngleSine(heading);
+	f32 bulletX = GetX() + GetWidth() / 2 + cosHeading * (12 + bulletRadius) - cosHeading * bulletSpeed;
+	f32 bulletY = GetY() + GetHeight() / 2 + sinHeading * (12 + bulletRadius) - sinHeading * bulletSpeed;
+	if (bullets->Spawn(player, bulletX, bulletY, heading, bulletRadius, bulletSpeed) < 0) return false; // no room (can't happen as long as the system is sized for every tank's ammo)
 	// play sound
-	SND_SetVoice(SND_GetFirstUnusedVoice(), VOICE_STEREO_16BIT_LE, 44100, 0, (char*) shoot_pcm, shoot_pcm_size, 255, 255, NULL);
+	if (sounds) sounds->Post(SOUND_SHOOT);
+	return true;
 }
 // animates the tank, moving its treads forwards or backwards
 void Tank::Animate(bool forwards) {
 	// for forwards, go backwards in the animation (add 7 frames each time so it loops back around to 1 behind)
 	if (forwards) SetFrame(player * 8 + (GetFrame() + 7) % 8); // player * 8 sets tank color, getFrame % 8 sets movement frame
 	else SetFrame(player * 8 + (GetFrame() + 1) % 8); // player * 8 sets tank color, getFrame % 8 sets movement frame
+}
+
+EntityPools::EntityPools(int tankCount, int explosionCount) : tanks(tankCount, "tanks"), explosions(explosionCount, "explosions") {}
+// prints every pool's usage and high water mark (for POOL_DEBUG builds)
+void EntityPools::Report() const {
+	tanks.Report();
+	explosions.Report();
 }
\ No newline at end of file
@@ -4,46 +4,73 @@
 #include <stdlib.h>
 #include <gccore.h>
 #include <wiisprite.h>
-#include <wiiuse/wpad.h>
 #include <math.h>
 #include <vector>
-#include <asndlib.h>
-#include <mp3player.h>
-
-#include "tanks_png.h"
-#include "shoot_pcm.h"
 
+#include "platform.h"
+#include "audio.h"
+#include "pool.h"
+#include "texturecache.h"
+#include "clock.h"
 #include "collision.h"
-#include "bullet.h"
+#include "wallgrid.h"
+#include "bulletsystem.h"
 #include "explosion.h"
 
 using namespace wsp;
 
-class Tank : public Sprite {
+struct EntityPools;
+
+class Tank : public Sprite, public Pooled<Tank> {
 	public:
-		// updates tank given player inputs
-		void Update(LayerManager* tankManager, LayerManager* wallManager, LayerManager* bulletManager, LayerManager* explosionManager);
+		// moves the tank given player inputs (movement is scaled by the simulation's time scale), pushing it out of walls
+		// (bullets are dealt with once every tank has moved: see HitTanks in broadphase.h, then Fire)
+		void Update(const InputState* input, f32 timeScale, WallGrid* wallGrid);
+		// tests the tank against a bullet, and takes a life if it's hit (returns true if it was)
+		bool TestHit(const BulletSystem* bullets, int bullet);
+		bool IsAlive() const { return life > 0; }
+		// shoots if the player pressed fire this step and the tank has ammo left (returns true if it shot)
+		bool Fire(const InputState* input, BulletSystem* bullets);
+		int GetPlayer() const { return player; }
         void Destroy(LayerManager* tankManager, LayerManager* explosionManager = NULL);
-		void SetMoveSpeed(f32 moveSpeed);
-		void SetTurnSpeed(f32 turnSpeed);
-		f32 GetInitialMoveSpeed();
-		f32 GetInitialTurnSpeed();
-		Tank(int player, int ammo);
+		// saves where the tank is now, for drawing it part way between this and where it is after the next step
+		void SavePose();
+		const LayerPose* GetPreviousPose();
+		// the collision box and bounds from the tank's last update (after it's been pushed out of walls)
+		const OrientedBox* GetBox();
+		Vec2 GetBounds();
+		// the tank makes its explosion from the given pools, shares its (and its explosion's) images from the given texture cache, and posts its sounds to the given queue (NULL for none)
+		Tank(int player, int ammo, EntityPools* pools, TextureCache* textures, SoundQueue* sounds);
+		~Tank();
 	private:
 		int player;
+		EntityPools* pools;
+		TextureCache* textures;
+		SoundQueue* sounds;
 		int animFrame;
 		f32 moveSpeed;
 		f32 turnSpeed;
-		f32 initialMoveSpeed;
-		f32 initialTurnSpeed;
+		LayerPose previousPose;
 		int ammo;
         int life;
+		OrientedBox box;
+		Vec2 bounds;
 		// returns true if the tank has fewer than (ammo) shots on the map
-		bool HasAmmo(LayerManager* bulletManager);
-		// shoots a bullet
-		void Shoot(LayerManager* wallManager, LayerManager* bulletManager);
+		bool HasAmmo(BulletSystem* bullets);
+		// shoots a bullet (returns false if there's no room for it)
+		bool Shoot(BulletSystem* bullets);
 		// animates the tank, moving its treads forwards or backwards
 		void Animate(bool forwards);
 };
 
+// preallocated storage for everything that gets made and destroyed during rounds (see ObjectPool)
+// (bullets don't need one, since BulletSystem keeps them in arrays of its own)
+struct EntityPools {
+	ObjectPool<Tank> tanks;
+	ObjectPool<Explosion> explosions;
+	EntityPools(int tankCount, int explosionCount);
+	// prints every pool's usage and high water mark (for POOL_DEBUG builds)
+	void Report() const;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "texturecache.h"
+
+#include "assetarchive.h"
+#include "tiledimage.h"
+#include "profiler.h"
+
+using namespace wsp;
+
+// the texture file (converted from the png in data, see tools/texconv.cpp) each texture comes from, in TextureId order
+static const char* const textureNames[TEXTURE_COUNT] = {
+	"tanks.tex",
+	"bullet.tex",
+	"explosion.tex",
+	"cursors.tex",
+	"background.tex",
+	"logo.tex",
+	"btn_2_players.tex",
+	"btn_2_players_over.tex",
+	"btn_3_players.tex",
+	"btn_3_players_over.tex",
+	"btn_4_players.tex",
+	"btn_4_players_over.tex",
+	"btn_exit.tex",
+	"btn_exit_over.tex",
+};
+
+// returns the image (loading it if it isn't already) and adds a reference to it
+// (its tiles are already in the asset archive in gx's layout, so loading one is just reading its header)
+Image* TextureCache::Acquire(TextureId id) {
+	if (!images[id]) {
+		const AssetInfo* asset;
+		const u8* file = GetBuiltInAsset(textureNames[id], &asset);
+		TiledImage* image = new TiledImage();
+		if (file) image->LoadTexture(file, asset->size);
+		images[id] = image;
+		decodes++;
+		CountProfileEvent(PROFILE_ALLOCATIONS);
+	}
+	references[id]++;
+	return images[id];
+}
+
+// drops a reference to the image, freeing it if that was the last one
+void TextureCache::Release(TextureId id) {
+	if (--references[id] > 0) return;
+	delete images[id];
+	images[id] = NULL;
+	references[id] = 0;
+}
+
+// loads every image now and keeps them until the cache is deleted
+void TextureCache::Preload() {
+	if (preloaded) return;
+	for (int id = 0; id < TEXTURE_COUNT; id++) Acquire((TextureId) id);
+	preloaded = true;
+}
+
+int TextureCache::GetReferences(TextureId id) const { return references[id]; }
+
+// prints how many images are loaded and referenced (for POOL_DEBUG builds)
+void TextureCache::Report() const {
+	int decoded = 0;
+	int referenced = 0;
+	for (int id = 0; id < TEXTURE_COUNT; id++) {
+		if (images[id]) decoded++;
+		referenced += references[id];
+	}
+	printf("textures: %d/%d loaded, %d references, %d loads\n", decoded, TEXTURE_COUNT, referenced, decodes);
+}
+
+TextureCache::TextureCache() {
+	for (int id = 0; id < TEXTURE_COUNT; id++) {
+		images[id] = NULL;
+		references[id] = 0;
+	}
+	decodes = 0;
+	preloaded = false;
+}
+
+// everything using the images should be gone by now, so this just frees whatever's left (the preloaded references)
+TextureCache::~TextureCache() {
+	for (int id = 0; id < TEXTURE_COUNT; id++) delete images[id];
+}
\ No newline at end of file
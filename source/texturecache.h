@@ -0,0 +1,57 @@
+#ifndef TANK_TEXTURECACHE_H
+#define TANK_TEXTURECACHE_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <gccore.h>
+#include <wiisprite.h>
+
+using namespace wsp;
+
+// every image the game draws (one per png in data)
+enum TextureId {
+	TEXTURE_TANKS,
+	TEXTURE_BULLET,
+	TEXTURE_EXPLOSION,
+	TEXTURE_CURSORS,
+	TEXTURE_BACKGROUND,
+	TEXTURE_LOGO,
+	TEXTURE_BTN_2_PLAYERS,
+	TEXTURE_BTN_2_PLAYERS_OVER,
+	TEXTURE_BTN_3_PLAYERS,
+	TEXTURE_BTN_3_PLAYERS_OVER,
+	TEXTURE_BTN_4_PLAYERS,
+	TEXTURE_BTN_4_PLAYERS_OVER,
+	TEXTURE_BTN_EXIT,
+	TEXTURE_BTN_EXIT_OVER,
+	TEXTURE_COUNT
+};
+
+// images shared by every sprite that uses them, so each one is loaded once instead of once per sprite (they're TiledImages, straight out of the asset archive)
+// images are reference counted: Acquire loads an image if nobody has it yet and adds a reference, Release drops one, and the image is freed when the last one goes
+// Preload has the cache hold a reference to everything itself, so nothing is ever loaded (or freed) mid-round
+class TextureCache {
+	public:
+		// returns the image (loading it if it isn't already) and adds a reference to it
+		Image* Acquire(TextureId id);
+		// drops a reference to the image, freeing it if that was the last one
+		void Release(TextureId id);
+		// loads every image now and keeps them until the cache is deleted
+		void Preload();
+		int GetReferences(TextureId id) const;
+		int GetDecodes() const { return decodes; } // number of images that have been loaded
+		// prints how many images are loaded and referenced (for POOL_DEBUG builds)
+		void Report() const;
+		TextureCache();
+		~TextureCache();
+	private:
+		Image* images[TEXTURE_COUNT];
+		int references[TEXTURE_COUNT];
+		int decodes;
+		bool preloaded;
+		// the cache owns its images, so it can't be copied
+		TextureCache(const TextureCache&);
+		TextureCache& operator=(const TextureCache&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "tiledimage.h"
+
+// sets the image up from a texture file (libwiisprite keeps an image's size in protected members, which is all a subclass needs to stand in for LoadImage)
+IMG_LOAD_ERROR TiledImage::LoadTexture(const u8* file, u32 size) {
+	if (IsInitialized()) return IMG_LOAD_ERROR_ALREADY_INIT;
+	TiledTextureHeader header;
+	if (!ReadTiledTextureHeader(file, size, &header)) return IMG_LOAD_ERROR_INV_PNG;
+	format = header.format;
+	_width = header.width;
+	_height = header.height;
+	InitTexture(file + TILED_TEXTURE_HEADER_SIZE);
+	_initialized = true;
+	return IMG_LOAD_ERROR_NONE;
+}
+
+TiledImage::TiledImage() {
+	format = 0;
+}
\ No newline at end of file
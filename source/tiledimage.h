@@ -0,0 +1,27 @@
+#ifndef TANK_TILEDIMAGE_H
+#define TANK_TILEDIMAGE_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+
+#include "tiledtexture.h"
+
+using namespace wsp;
+
+// an image made from a texture file (see tiledtexture.h) rather than a png: libwiisprite's LoadImage decodes a png with libpng and then swizzles it
+// into tiles of its own, but a texture file's tiles are already what gx reads, so this just points the image's texture object at them
+// (they're used where they are, so the file has to stay in memory as long as the image does, which the asset archive built into the game always does)
+class TiledImage : public Image {
+	public:
+		// sets the image up from a texture file (returns IMG_LOAD_ERROR_INV_PNG if it isn't one, or IMG_LOAD_ERROR_ALREADY_INIT if the image already has a texture)
+		IMG_LOAD_ERROR LoadTexture(const u8* file, u32 size);
+		u32 GetFormat() const { return format; } // a TiledTextureFormat
+		TiledImage();
+	private:
+		u32 format;
+		// points the texture object at the tiles (in the render backend, since it's gx's)
+		void InitTexture(const u8* tiles);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "tiledtexture.h"
+#include <string.h>
+
+// little endian reading/writing, so files are the same everywhere (see replay.cpp)
+static void WriteU32(u8* bytes, u32 value) {
+	for (int i = 0; i < 4; i++) bytes[i] = (value >> (8 * i)) & 0xff;
+}
+static u32 ReadU32(const u8* bytes) { return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((u32) bytes[3] << 24); }
+
+// a format's tile width/height and bytes per texel (returns false if it isn't a format there's a converter for)
+static bool GetTileLayout(u32 format, u32* tileWidth, u32* tileHeight, u32* texelSize) {
+	*tileWidth = format == TILED_TEXTURE_I8 ? 8 : 4;
+	*tileHeight = 4;
+	*texelSize = format == TILED_TEXTURE_I8 ? 1 : format == TILED_TEXTURE_RGB5A3 ? 2 : 4;
+	return format == TILED_TEXTURE_I8 || format == TILED_TEXTURE_RGB5A3 || format == TILED_TEXTURE_RGBA8;
+}
+
+// returns the bytes of tiles a texture takes (0 if the format isn't one of the above)
+u32 GetTiledTextureSize(u32 format, u32 width, u32 height) {
+	u32 tileWidth, tileHeight, texelSize;
+	if (!GetTileLayout(format, &tileWidth, &tileHeight, &texelSize)) return 0;
+	return (width + tileWidth - 1) / tileWidth * tileWidth * ((height + tileHeight - 1) / tileHeight * tileHeight) * texelSize;
+}
+
+// reads a texture file's header (returns false if it isn't one, or its tiles don't fit in size)
+bool ReadTiledTextureHeader(const u8* file, u32 size, TiledTextureHeader* header) {
+	if (!file || size < TILED_TEXTURE_HEADER_SIZE || memcmp(file, TILED_TEXTURE_MAGIC, 4) || ReadU32(file + 4) != TILED_TEXTURE_VERSION) return false;
+	header->format = ReadU32(file + 8);
+	header->width = ReadU32(file + 12);
+	header->height = ReadU32(file + 16);
+	header->size = ReadU32(file + 20);
+	// gx takes up to 1024x1024
+	if (!header->width || !header->height || header->width > 1024 || header->height > 1024) return false;
+	return header->size && header->size == GetTiledTextureSize(header->format, header->width, header->height) && header->size <= size - TILED_TEXTURE_HEADER_SIZE;
+}
+
+// writes a header (the size filled in from the format and dimensions)
+void WriteTiledTextureHeader(u8* file, u32 format, u32 width, u32 height) {
+	memset(file, 0, TILED_TEXTURE_HEADER_SIZE);
+	memcpy(file, TILED_TEXTURE_MAGIC, 4);
+	WriteU32(file + 4, TILED_TEXTURE_VERSION);
+	WriteU32(file + 8, format);
+	WriteU32(file + 12, width);
+	WriteU32(file + 16, height);
+	WriteU32(file + 20, GetTiledTextureSize(format, width, height));
+}
+
+// returns where a texel's bytes start in the tiles (its index within its tile, times its size, on from the tile's start)
+static u32 GetTexelOffset(u32 x, u32 y, u32 width, u32 tileWidth, u32 tileHeight, u32 texelSize) {
+	u32 tilesAcross = (width + tileWidth - 1) / tileWidth;
+	u32 tile = y / tileHeight * tilesAcross + x / tileWidth;
+	u32 tileSize = tileWidth * tileHeight * texelSize;
+	// rgba8 tiles are 64 bytes (two 32 byte halves), each half holding two bytes of every texel
+	if (texelSize == 4) return tile * tileSize + ((y % tileHeight) * tileWidth + x % tileWidth) * 2;
+	return tile * tileSize + ((y % tileHeight) * tileWidth + x % tileWidth) * texelSize;
+}
+
+// rounds an 8-bit channel to the nearest value with fewer bits
+static u32 ReduceChannel(u8 value, int bits) { return (value * ((1 << bits) - 1) + 127) / 255; }
+
+// rgb5a3 texels are big endian, like everything gx reads (pixels that are nearly opaque are rounded up to opaque, the same as 3-bit alpha would round them)
+static u16 PackRGB5A3(const u8* pixel) {
+	if (ReduceChannel(pixel[3], 3) == 7) return 0x8000 | ReduceChannel(pixel[0], 5) << 10 | ReduceChannel(pixel[1], 5) << 5 | ReduceChannel(pixel[2], 5);
+	return ReduceChannel(pixel[3], 3) << 12 | ReduceChannel(pixel[0], 4) << 8 | ReduceChannel(pixel[1], 4) << 4 | ReduceChannel(pixel[2], 4);
+}
+static void UnpackRGB5A3(u16 texel, u8* pixel) {
+	if (texel & 0x8000) {
+		for (int channel = 0; channel < 3; channel++) {
+			u32 value = (texel >> (10 - 5 * channel)) & 0x1f;
+			pixel[channel] = value << 3 | value >> 2;
+		}
+		pixel[3] = 0xff;
+		return;
+	}
+	for (int channel = 0; channel < 3; channel++) pixel[channel] = ((texel >> (8 - 4 * channel)) & 0xf) * 0x11;
+	u32 alpha = (texel >> 12) & 0x7;
+	pixel[3] = alpha << 5 | alpha << 2 | alpha >> 1;
+}
+
+// converts 8-bit rgba pixels into tiles (padding texels are left as zeros, which is transparent black)
+void TileTexture(const u8* pixels, u32 format, u32 width, u32 height, u8* tiles) {
+	u32 tileWidth, tileHeight, texelSize;
+	if (!GetTileLayout(format, &tileWidth, &tileHeight, &texelSize)) return;
+	memset(tiles, 0, GetTiledTextureSize(format, width, height));
+	for (u32 y = 0; y < height; y++) {
+		for (u32 x = 0; x < width; x++) {
+			const u8* pixel = pixels + (y * width + x) * 4;
+			u8* texel = tiles + GetTexelOffset(x, y, width, tileWidth, tileHeight, texelSize);
+			if (format == TILED_TEXTURE_I8) {
+				texel[0] = (pixel[0] * 77 + pixel[1] * 150 + pixel[2] * 29 + 128) >> 8;
+			}
+			else if (format == TILED_TEXTURE_RGB5A3) {
+				u16 packed = PackRGB5A3(pixel);
+				texel[0] = packed >> 8;
+				texel[1] = packed & 0xff;
+			}
+			else {
+				texel[0] = pixel[3];
+				texel[1] = pixel[0];
+				texel[32] = pixel[1];
+				texel[33] = pixel[2];
+			}
+		}
+	}
+}
+
+// converts tiles back into 8-bit rgba pixels (as gx would read them)
+void UntileTexture(const u8* tiles, u32 format, u32 width, u32 height, u8* pixels) {
+	u32 tileWidth, tileHeight, texelSize;
+	if (!GetTileLayout(format, &tileWidth, &tileHeight, &texelSize)) return;
+	for (u32 y = 0; y < height; y++) {
+		for (u32 x = 0; x < width; x++) {
+			u8* pixel = pixels + (y * width + x) * 4;
+			const u8* texel = tiles + GetTexelOffset(x, y, width, tileWidth, tileHeight, texelSize);
+			if (format == TILED_TEXTURE_I8) {
+				memset(pixel, texel[0], 4);
+			}
+			else if (format == TILED_TEXTURE_RGB5A3) {
+				UnpackRGB5A3(texel[0] << 8 | texel[1], pixel);
+			}
+			else {
+				pixel[3] = texel[0];
+				pixel[0] = texel[1];
+				pixel[1] = texel[32];
+				pixel[2] = texel[33];
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef TANK_TILEDTEXTURE_H
+#define TANK_TILEDTEXTURE_H
+
+#include <stdlib.h>
+#include <gccore.h>
+
+// textures already in gx's own layout, so loading one is just pointing gx at it (tools/texconv.cpp makes them out of the pngs when the game's built)
+// gx stores textures as tiles of texels, each tile 32 bytes, left to right then top to bottom (a texture that isn't a whole number of tiles is padded out);
+// a texture file is a TILED_TEXTURE_HEADER_SIZE byte header (little endian, like the asset archive) and then the tiles, so they stay 32 byte aligned
+
+#define TILED_TEXTURE_MAGIC "WTTX"
+#define TILED_TEXTURE_VERSION 1
+#define TILED_TEXTURE_HEADER_SIZE 32
+
+// the formats (these are gx's own GX_TF_ numbers)
+enum TiledTextureFormat {
+	TILED_TEXTURE_I8 = 0x1, // 8x4 tiles of 8-bit intensity, which gx uses for all four channels (so it's only for images where they're all the same)
+	TILED_TEXTURE_RGB5A3 = 0x5, // 4x4 tiles of 16 bits: 5-bit rgb if the texel's opaque, otherwise 3-bit alpha and 4-bit rgb
+	TILED_TEXTURE_RGBA8 = 0x6 // 4x4 tiles of 32 bits, each tile split into its alpha/red pairs and then its green/blue pairs
+};
+
+struct TiledTextureHeader {
+	u32 format; // a TiledTextureFormat
+	u32 width;
+	u32 height;
+	u32 size; // bytes of tiles after the header
+};
+
+// reads a texture file's header (returns false if it isn't one, or its tiles don't fit in size)
+bool ReadTiledTextureHeader(const u8* file, u32 size, TiledTextureHeader* header);
+// writes a header (TILED_TEXTURE_HEADER_SIZE bytes, the size filled in from the format and dimensions)
+void WriteTiledTextureHeader(u8* file, u32 format, u32 width, u32 height);
+
+// returns the bytes of tiles a texture takes (0 if the format isn't one of the above)
+u32 GetTiledTextureSize(u32 format, u32 width, u32 height);
+
+// converts 8-bit rgba pixels (rows top to bottom, no padding) into tiles, and back (the host side: the game never has to do either)
+void TileTexture(const u8* pixels, u32 format, u32 width, u32 height, u8* tiles);
+void UntileTexture(const u8* tiles, u32 format, u32 width, u32 height, u8* pixels);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "wallbatch.h"
+#include "profiler.h"
+#if defined(WALLBATCH_KERNEL_SSE)
+	#include <xmmintrin.h>
+#elif defined(WALLBATCH_KERNEL_NEON)
+	#include <arm_neon.h>
+#endif
+using namespace wsp;
+
+// empties the batch without freeing its storage
+void ClearWallBatch(WallBatch* batch) {
+	batch->count = 0;
+	batch->centerX.clear();
+	batch->centerY.clear();
+	batch->halfWidth.clear();
+	batch->halfHeight.clear();
+	batch->axisX.clear();
+	batch->axisY.clear();
+}
+
+// adds a wall to the batch and returns its index
+int AddToWallBatch(WallBatch* batch, const OrientedBox* wall) {
+	batch->centerX.push_back(wall->center.x);
+	batch->centerY.push_back(wall->center.y);
+	batch->halfWidth.push_back(wall->halfExtents.x);
+	batch->halfHeight.push_back(wall->halfExtents.y);
+	batch->axisX.push_back(wall->axis.x);
+	batch->axisY.push_back(wall->axis.y);
+	return batch->count++;
+}
+
+// clears the batch and fills it with every quad in the wall manager (batch indices match wall manager indices)
+void LoadWallBatch(WallBatch* batch, LayerManager* wallManager) {
+	ClearWallBatch(batch);
+	for (int i = 0; i < (int) wallManager->GetSize(); i++) {
+		OrientedBox wall = GetOrientedBox((Quad*) wallManager->GetLayerAt(i));
+		AddToWallBatch(batch, &wall);
+	}
+}
+
+// returns the oriented box of a wall in the batch
+OrientedBox GetWallBox(const WallBatch* batch, int wall) {
+	OrientedBox box = {
+		{batch->centerX[wall], batch->centerY[wall]},
+		{batch->halfWidth[wall], batch->halfHeight[wall]},
+		{batch->axisX[wall], batch->axisY[wall]}
+	};
+	return box;
+}
+
+// returns the smallest overlap of a box and a wall across the 4 axes (positive only if the box is penetrating the wall)
+// with u/v as the box's axes and p/q as the wall's, |p.u| = |q.v| and |p.v| = |q.u|, so only those 2 dot products are needed for every projected radius
+// the simd kernels below are just this function done across several walls at once
+static f32 WallOverlap(const OrientedBox* box, const WallBatch* batch, int wall) {
+	f32 dx = batch->centerX[wall] - box->center.x;
+	f32 dy = batch->centerY[wall] - box->center.y;
+	f32 px = batch->axisX[wall];
+	f32 py = batch->axisY[wall];
+	f32 wallHalfWidth = batch->halfWidth[wall];
+	f32 wallHalfHeight = batch->halfHeight[wall];
+	f32 cosAbs = fabs(px * box->axis.x + py * box->axis.y);
+	f32 sinAbs = fabs(py * box->axis.x - px * box->axis.y);
+	f32 overlapU = box->halfExtents.x + wallHalfWidth * cosAbs + wallHalfHeight * sinAbs - fabs(dx * box->axis.x + dy * box->axis.y);
+	f32 overlapV = box->halfExtents.y + wallHalfWidth * sinAbs + wallHalfHeight * cosAbs - fabs(dy * box->axis.x - dx * box->axis.y);
+	f32 overlapP = wallHalfWidth + box->halfExtents.x * cosAbs + box->halfExtents.y * sinAbs - fabs(dx * px + dy * py);
+	f32 overlapQ = wallHalfHeight + box->halfExtents.x * sinAbs + box->halfExtents.y * cosAbs - fabs(dy * px - dx * py);
+	return std::min(std::min(overlapU, overlapV), std::min(overlapP, overlapQ));
+}
+
+// works out the full contact for a wall the kernel flagged and appends it (the kernel only says whether there's overlap, not which axis it's on)
+static void AddContact(const OrientedBox* box, const WallBatch* batch, int wall, WallContact* contacts, int maxContacts, int* found) {
+	if (*found >= maxContacts) return;
+	OrientedBox wallBox = GetWallBox(batch, wall);
+	Contact contact = Collision(box, &wallBox);
+	if (contact.overlap == 0) return; // rounding can differ slightly between the kernel and the scalar version, so trust the scalar one
+	contacts[*found].wall = wall;
+	contacts[*found].contact = contact;
+	(*found)++;
+}
+
+#if defined(WALLBATCH_KERNEL_PAIRED)
+// 2 walls at a time w/ broadway's paired singles (each fpr holds 2 floats, one per wall)
+// this is all one asm block so that the compiler never gets the chance to spill a paired register with a plain stfd (which would drop the second float)
+static void PairedWallOverlaps(const OrientedBox* box, const WallBatch* batch, int wall, f32 overlaps[2]) {
+	asm volatile (
+		// load the 2 walls
+		"psq_l 0, 0(%[centerX]), 0, 0\n"
+		"psq_l 1, 0(%[centerY]), 0, 0\n"
+		"psq_l 2, 0(%[halfWidth]), 0, 0\n"
+		"psq_l 3, 0(%[halfHeight]), 0, 0\n"
+		"psq_l 4, 0(%[axisX]), 0, 0\n"
+		"psq_l 5, 0(%[axisY]), 0, 0\n"
+		// splat the box into both halves
+		"ps_merge00 6, %[x], %[x]\n"
+		"ps_merge00 7, %[y], %[y]\n"
+		"ps_merge00 8, %[hw], %[hw]\n"
+		"ps_merge00 9, %[hh], %[hh]\n"
+		"ps_merge00 10, %[ux], %[ux]\n"
+		"ps_merge00 11, %[uy], %[uy]\n"
+		// offset from box to wall
+		"ps_sub 0, 0, 6\n"
+		"ps_sub 1, 1, 7\n"
+		// |p.u| and |p.v|
+		"ps_mul 12, 4, 10\n"
+		"ps_madd 12, 5, 11, 12\n"
+		"ps_abs 12, 12\n"
+		"ps_mul 13, 5, 10\n"
+		"ps_nmsub 13, 4, 11, 13\n"
+		"ps_abs 13, 13\n"
+		// |offset| on u, v, p and q
+		"ps_mul 14, 0, 10\n"
+		"ps_madd 14, 1, 11, 14\n"
+		"ps_abs 14, 14\n"
+		"ps_mul 15, 1, 10\n"
+		"ps_nmsub 15, 0, 11, 15\n"
+		"ps_abs 15, 15\n"
+		"ps_mul 16, 0, 4\n"
+		"ps_madd 16, 1, 5, 16\n"
+		"ps_abs 16, 16\n"
+		"ps_mul 17, 1, 4\n"
+		"ps_nmsub 17, 0, 5, 17\n"
+		"ps_abs 17, 17\n"
+		// overlap on each axis
+		"ps_madd 18, 2, 12, 8\n"
+		"ps_madd 18, 3, 13, 18\n"
+		"ps_sub 18, 18, 14\n"
+		"ps_madd 19, 2, 13, 9\n"
+		"ps_madd 19, 3, 12, 19\n"
+		"ps_sub 19, 19, 15\n"
+		"ps_madd 20, 8, 12, 2\n"
+		"ps_madd 20, 9, 13, 20\n"
+		"ps_sub 20, 20, 16\n"
+		"ps_madd 21, 8, 13, 3\n"
+		"ps_madd 21, 9, 12, 21\n"
+		"ps_sub 21, 21, 17\n"
+		// min of the 4 (ps_sel picks the 2nd operand where the 1st is >= 0)
+		"ps_sub 22, 18, 19\n"
+		"ps_sel 18, 22, 19, 18\n"
+		"ps_sub 22, 20, 21\n"
+		"ps_sel 20, 22, 21, 20\n"
+		"ps_sub 22, 18, 20\n"
+		"ps_sel 18, 22, 20, 18\n"
+		"psq_st 18, 0(%[overlaps]), 0, 0\n"
+		:
+		: [centerX] "b" (&batch->centerX[wall]), [centerY] "b" (&batch->centerY[wall]),
+		  [halfWidth] "b" (&batch->halfWidth[wall]), [halfHeight] "b" (&batch->halfHeight[wall]),
+		  [axisX] "b" (&batch->axisX[wall]), [axisY] "b" (&batch->axisY[wall]),
+		  [x] "f" (box->center.x), [y] "f" (box->center.y), [hw] "f" (box->halfExtents.x), [hh] "f" (box->halfExtents.y),
+		  [ux] "f" (box->axis.x), [uy] "f" (box->axis.y), [overlaps] "b" (overlaps)
+		: "fr0", "fr1", "fr2", "fr3", "fr4", "fr5", "fr6", "fr7", "fr8", "fr9", "fr10", "fr11",
+		  "fr12", "fr13", "fr14", "fr15", "fr16", "fr17", "fr18", "fr19", "fr20", "fr21", "fr22", "memory"
+	);
+}
+#endif
+
+// returns the name of the kernel BatchCollision was built with
+const char* GetWallBatchKernel() {
+#if defined(WALLBATCH_KERNEL_PAIRED)
+	return "paired";
+#elif defined(WALLBATCH_KERNEL_SSE)
+	return "sse";
+#elif defined(WALLBATCH_KERNEL_NEON)
+	return "neon";
+#else
+	return "scalar";
+#endif
+}
+
+// tests a box against every wall in the batch, fills contacts with (at most maxContacts of) the ones it's penetrating in wall order, and returns how many were found
+int BatchCollision(const OrientedBox* box, const WallBatch* batch, WallContact* contacts, int maxContacts) {
+	return BatchCollision(box, batch, 0, batch->count, contacts, maxContacts);
+}
+
+// same as above, but only for the walls from first up to (not including) last
+int BatchCollision(const OrientedBox* box, const WallBatch* batch, int first, int last, WallContact* contacts, int maxContacts) {
+	CountProfileEvent(PROFILE_COLLISION_PAIRS, last - first);
+	int found = 0;
+	int wall = first;
+#if defined(WALLBATCH_KERNEL_PAIRED)
+	for (; wall + 2 <= last; wall += 2) {
+		f32 overlaps[2] __attribute__((aligned(8)));
+		PairedWallOverlaps(box, batch, wall, overlaps);
+		if (overlaps[0] > 0) AddContact(box, batch, wall, contacts, maxContacts, &found);
+		if (overlaps[1] > 0) AddContact(box, batch, wall + 1, contacts, maxContacts, &found);
+	}
+#elif defined(WALLBATCH_KERNEL_SSE)
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 x = _mm_set1_ps(box->center.x);
+	const __m128 y = _mm_set1_ps(box->center.y);
+	const __m128 hw = _mm_set1_ps(box->halfExtents.x);
+	const __m128 hh = _mm_set1_ps(box->halfExtents.y);
+	const __m128 ux = _mm_set1_ps(box->axis.x);
+	const __m128 uy = _mm_set1_ps(box->axis.y);
+	for (; wall + 4 <= last; wall += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(&batch->centerX[wall]), x);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(&batch->centerY[wall]), y);
+		__m128 wallHalfWidth = _mm_loadu_ps(&batch->halfWidth[wall]);
+		__m128 wallHalfHeight = _mm_loadu_ps(&batch->halfHeight[wall]);
+		__m128 px = _mm_loadu_ps(&batch->axisX[wall]);
+		__m128 py = _mm_loadu_ps(&batch->axisY[wall]);
+		__m128 cosAbs = _mm_andnot_ps(signMask, _mm_add_ps(_mm_mul_ps(px, ux), _mm_mul_ps(py, uy)));
+		__m128 sinAbs = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_mul_ps(py, ux), _mm_mul_ps(px, uy)));
+		__m128 distU = _mm_andnot_ps(signMask, _mm_add_ps(_mm_mul_ps(dx, ux), _mm_mul_ps(dy, uy)));
+		__m128 distV = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_mul_ps(dy, ux), _mm_mul_ps(dx, uy)));
+		__m128 distP = _mm_andnot_ps(signMask, _mm_add_ps(_mm_mul_ps(dx, px), _mm_mul_ps(dy, py)));
+		__m128 distQ = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_mul_ps(dy, px), _mm_mul_ps(dx, py)));
+		__m128 overlapU = _mm_sub_ps(_mm_add_ps(hw, _mm_add_ps(_mm_mul_ps(wallHalfWidth, cosAbs), _mm_mul_ps(wallHalfHeight, sinAbs))), distU);
+		__m128 overlapV = _mm_sub_ps(_mm_add_ps(hh, _mm_add_ps(_mm_mul_ps(wallHalfWidth, sinAbs), _mm_mul_ps(wallHalfHeight, cosAbs))), distV);
+		__m128 overlapP = _mm_sub_ps(_mm_add_ps(wallHalfWidth, _mm_add_ps(_mm_mul_ps(hw, cosAbs), _mm_mul_ps(hh, sinAbs))), distP);
+		__m128 overlapQ = _mm_sub_ps(_mm_add_ps(wallHalfHeight, _mm_add_ps(_mm_mul_ps(hw, sinAbs), _mm_mul_ps(hh, cosAbs))), distQ);
+		__m128 overlap = _mm_min_ps(_mm_min_ps(overlapU, overlapV), _mm_min_ps(overlapP, overlapQ));
+		int hits = _mm_movemask_ps(_mm_cmpgt_ps(overlap, zero));
+		if (!hits) continue; // the usual case, most walls are nowhere near
+		for (int lane = 0; lane < 4; lane++) {
+			if (hits & (1 << lane)) AddContact(box, batch, wall + lane, contacts, maxContacts, &found);
+		}
+	}
+#elif defined(WALLBATCH_KERNEL_NEON)
+	const float32x4_t zero = vdupq_n_f32(0);
+	const float32x4_t x = vdupq_n_f32(box->center.x);
+	const float32x4_t y = vdupq_n_f32(box->center.y);
+	const float32x4_t hw = vdupq_n_f32(box->halfExtents.x);
+	const float32x4_t hh = vdupq_n_f32(box->halfExtents.y);
+	const float32x4_t ux = vdupq_n_f32(box->axis.x);
+	const float32x4_t uy = vdupq_n_f32(box->axis.y);
+	for (; wall + 4 <= last; wall += 4) {
+		float32x4_t dx = vsubq_f32(vld1q_f32(&batch->centerX[wall]), x);
+		float32x4_t dy = vsubq_f32(vld1q_f32(&batch->centerY[wall]), y);
+		float32x4_t wallHalfWidth = vld1q_f32(&batch->halfWidth[wall]);
+		float32x4_t wallHalfHeight = vld1q_f32(&batch->halfHeight[wall]);
+		float32x4_t px = vld1q_f32(&batch->axisX[wall]);
+		float32x4_t py = vld1q_f32(&batch->axisY[wall]);
+		float32x4_t cosAbs = vabsq_f32(vmlaq_f32(vmulq_f32(px, ux), py, uy));
+		float32x4_t sinAbs = vabsq_f32(vmlsq_f32(vmulq_f32(py, ux), px, uy));
+		float32x4_t distU = vabsq_f32(vmlaq_f32(vmulq_f32(dx, ux), dy, uy));
+		float32x4_t distV = vabsq_f32(vmlsq_f32(vmulq_f32(dy, ux), dx, uy));
+		float32x4_t distP = vabsq_f32(vmlaq_f32(vmulq_f32(dx, px), dy, py));
+		float32x4_t distQ = vabsq_f32(vmlsq_f32(vmulq_f32(dy, px), dx, py));
+		float32x4_t overlapU = vsubq_f32(vmlaq_f32(vmlaq_f32(hw, wallHalfWidth, cosAbs), wallHalfHeight, sinAbs), distU);
+		float32x4_t overlapV = vsubq_f32(vmlaq_f32(vmlaq_f32(hh, wallHalfWidth, sinAbs), wallHalfHeight, cosAbs), distV);
+		float32x4_t overlapP = vsubq_f32(vmlaq_f32(vmlaq_f32(wallHalfWidth, hw, cosAbs), hh, sinAbs), distP);
+		float32x4_t overlapQ = vsubq_f32(vmlaq_f32(vmlaq_f32(wallHalfHeight, hw, sinAbs), hh, cosAbs), distQ);
+		float32x4_t overlap = vminq_f32(vminq_f32(overlapU, overlapV), vminq_f32(overlapP, overlapQ));
+		uint32_t hits[4];
+		vst1q_u32(hits, vcgtq_f32(overlap, zero));
+		if (!(hits[0] | hits[1] | hits[2] | hits[3])) continue; // the usual case, most walls are nowhere near
+		for (int lane = 0; lane < 4; lane++) {
+			if (hits[lane]) AddContact(box, batch, wall + lane, contacts, maxContacts, &found);
+		}
+	}
+#endif
+	// whatever's left over after the simd loop (or every wall, for the scalar path)
+	for (; wall < last; wall++) {
+		if (WallOverlap(box, batch, wall) > 0) AddContact(box, batch, wall, contacts, maxContacts, &found);
+	}
+	return found;
+}
\ No newline at end of file
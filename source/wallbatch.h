@@ -0,0 +1,69 @@
+#ifndef TANK_WALLBATCH_H
+#define TANK_WALLBATCH_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+#include <vector>
+
+#include "collision.h"
+
+using namespace wsp;
+
+// the kernel used by BatchCollision is picked at compile time: paired singles on the wii, sse/neon on the host, and plain c otherwise
+// (define WALLBATCH_SCALAR to force the plain c reference path anywhere)
+#if defined(WALLBATCH_SCALAR)
+	#define WALLBATCH_KERNEL_SCALAR
+#elif defined(GEKKO)
+	#define WALLBATCH_KERNEL_PAIRED
+#elif defined(__SSE__) || defined(_M_X64)
+	#define WALLBATCH_KERNEL_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define WALLBATCH_KERNEL_NEON
+#else
+	#define WALLBATCH_KERNEL_SCALAR
+#endif
+
+// walls packed as a structure of arrays so that several can be tested against one box at once
+// (the arrays keep their capacity when cleared, so reloading them every frame doesn't allocate)
+struct WallBatch {
+	int count;
+	std::vector<f32> centerX;
+	std::vector<f32> centerY;
+	std::vector<f32> halfWidth;
+	std::vector<f32> halfHeight;
+	std::vector<f32> axisX;
+	std::vector<f32> axisY;
+};
+
+// the most walls BatchCollision callers expect a single box to be touching at once
+#define WALLBATCH_MAX_CONTACTS 16
+
+// a wall that a box is penetrating, along with the collision info
+struct WallContact {
+	int wall;
+	Contact contact;
+};
+
+// empties the batch without freeing its storage
+void ClearWallBatch(WallBatch* batch);
+
+// adds a wall to the batch and returns its index
+int AddToWallBatch(WallBatch* batch, const OrientedBox* wall);
+
+// clears the batch and fills it with every quad in the wall manager (batch indices match wall manager indices)
+void LoadWallBatch(WallBatch* batch, LayerManager* wallManager);
+
+// returns the oriented box of a wall in the batch
+OrientedBox GetWallBox(const WallBatch* batch, int wall);
+
+// returns the name of the kernel BatchCollision was built with ("paired", "sse", "neon" or "scalar")
+const char* GetWallBatchKernel();
+
+// tests a box against every wall in the batch, fills contacts with (at most maxContacts of) the ones it's penetrating in wall order, and returns how many were found
+int BatchCollision(const OrientedBox* box, const WallBatch* batch, WallContact* contacts, int maxContacts);
+
+// same as above, but only for the walls from first up to (not including) last
+int BatchCollision(const OrientedBox* box, const WallBatch* batch, int first, int last, WallContact* contacts, int maxContacts);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "wallgrid.h"
+using namespace wsp;
+
+// returns the column/row a coordinate falls in, clamped to the grid
+static int GridColumn(const WallGrid* grid, f32 x) {
+	int column = (int) floor(x / grid->cellWidth);
+	return std::max(0, std::min(column, grid->columns - 1));
+}
+static int GridRow(const WallGrid* grid, f32 y) {
+	int row = (int) floor(y / grid->cellHeight);
+	return std::max(0, std::min(row, grid->rows - 1));
+}
+
+// returns the half width/height of the axis aligned box around a wall (spinners get the box around their whole circle of rotation)
+static Vec2 WallBounds(const OrientedBox* wall, bool spinner) {
+	Vec2 bounds;
+	if (spinner) {
+		bounds.x = sqrt(wall->halfExtents.x * wall->halfExtents.x + wall->halfExtents.y * wall->halfExtents.y);
+		bounds.y = bounds.x;
+	}
+	else {
+		bounds = GetBoxBounds(wall);
+	}
+	return bounds;
+}
+
+// fills the grid with every wall in the wall manager (the first spinningWallCount walls are spinners, and are indexed by everywhere they can rotate to)
+// a NULL wall manager just gives an empty grid
+void BuildWallGrid(WallGrid* grid, LayerManager* wallManager, int spinningWallCount, int columns, int rows, f32 cellWidth, f32 cellHeight) {
+	grid->columns = columns;
+	grid->rows = rows;
+	grid->cellWidth = cellWidth;
+	grid->cellHeight = cellHeight;
+	grid->spinningWallCount = spinningWallCount;
+	ResetWallGridCounters(grid);
+	// find the range of cells each wall touches
+	int wallCount = wallManager ? wallManager->GetSize() : 0;
+	std::vector<OrientedBox> boxes(wallCount);
+	std::vector<Vec2> wallBounds(wallCount);
+	std::vector<int> cellRanges(wallCount * 4); // first column, last column, first row, last row
+	grid->cellStarts.assign(columns * rows + 1, 0);
+	for (int i = 0; i < wallCount; i++) {
+		boxes[i] = GetOrientedBox((Quad*) wallManager->GetLayerAt(i));
+		wallBounds[i] = WallBounds(&boxes[i], i < spinningWallCount);
+		int* range = &cellRanges[i * 4];
+		range[0] = GridColumn(grid, boxes[i].center.x - wallBounds[i].x);
+		range[1] = GridColumn(grid, boxes[i].center.x + wallBounds[i].x);
+		range[2] = GridRow(grid, boxes[i].center.y - wallBounds[i].y);
+		range[3] = GridRow(grid, boxes[i].center.y + wallBounds[i].y);
+		// count walls per cell (shifted up by one so the prefix sum below turns these into start indices)
+		for (int row = range[2]; row <= range[3]; row++) {
+			for (int column = range[0]; column <= range[1]; column++) grid->cellStarts[row * columns + column + 1]++;
+		}
+	}
+	for (int cell = 0; cell < columns * rows; cell++) grid->cellStarts[cell + 1] += grid->cellStarts[cell];
+	// copy the walls into each cell they touch
+	int entryCount = grid->cellStarts[columns * rows];
+	std::vector<int> cellFill(grid->cellStarts.begin(), grid->cellStarts.end() - 1);
+	std::vector<int> entryWalls(entryCount);
+	for (int i = 0; i < wallCount; i++) {
+		int* range = &cellRanges[i * 4];
+		for (int row = range[2]; row <= range[3]; row++) {
+			for (int column = range[0]; column <= range[1]; column++) entryWalls[cellFill[row * columns + column]++] = i;
+		}
+	}
+	ClearWallBatch(&grid->walls);
+	grid->wallIds = entryWalls;
+	grid->bounds.resize(entryCount);
+	grid->spinners.assign(boxes.begin(), boxes.begin() + std::min(spinningWallCount, wallCount));
+	grid->spinnerEntries.clear();
+	grid->contacts.resize(entryCount);
+	for (int entry = 0; entry < entryCount; entry++) {
+		AddToWallBatch(&grid->walls, &boxes[entryWalls[entry]]);
+		grid->bounds[entry] = wallBounds[entryWalls[entry]];
+		if (entryWalls[entry] < spinningWallCount) grid->spinnerEntries.push_back(entry);
+	}
+}
+
+// updates the grid's copies of the spinning walls after they've rotated (each spinner's box is worked out once, then copied to every cell it's in)
+void UpdateWallGridSpinners(WallGrid* grid, LayerManager* wallManager) {
+	for (int i = 0; i < (int) grid->spinners.size(); i++) {
+		grid->spinners[i] = GetOrientedBox((Quad*) wallManager->GetLayerAt(i));
+	}
+	for (int i = 0; i < (int) grid->spinnerEntries.size(); i++) {
+		int entry = grid->spinnerEntries[i];
+		const OrientedBox* spinner = &grid->spinners[grid->wallIds[entry]];
+		grid->walls.axisX[entry] = spinner->axis.x;
+		grid->walls.axisY[entry] = spinner->axis.y;
+	}
+}
+
+// tests a box against the walls in the cells its bounds touch, fills contacts with (at most maxContacts of) the walls it's penetrating in wall manager order, and returns how many were found
+// (each contact's wall is an index into grid->walls; its wall manager index is grid->wallIds[wall])
+// a wall is in every cell its bounds touch, so any wall the box touches is in one of the box's cells too, however big the box is
+int QueryWallGrid(WallGrid* grid, const OrientedBox* box, WallContact* contacts, int maxContacts) {
+	Vec2 bounds = GetBoxBounds(box);
+	int firstColumn = GridColumn(grid, box->center.x - bounds.x);
+	int lastColumn = GridColumn(grid, box->center.x + bounds.x);
+	int lastRow = GridRow(grid, box->center.y + bounds.y);
+	WallContact* found = grid->contacts.data();
+	int foundCount = 0;
+	grid->queries++;
+	for (int row = GridRow(grid, box->center.y - bounds.y); row <= lastRow; row++) {
+		int first = grid->cellStarts[row * grid->columns + firstColumn];
+		int last = grid->cellStarts[row * grid->columns + lastColumn + 1];
+		grid->cellsVisited += lastColumn - firstColumn + 1;
+		grid->wallsTested += last - first;
+		// every copy's contact goes in the grid's own buffer first, so duplicates never take up the caller's slots
+		int rowFound = BatchCollision(box, &grid->walls, first, last, found + foundCount, last - first);
+		// walls that span several cells show up once per cell, so only keep the first copy of each
+		int rowEnd = foundCount + rowFound;
+		for (int i = foundCount; i < rowEnd; i++) {
+			bool duplicate = false;
+			for (int j = 0; j < foundCount && !duplicate; j++) duplicate = grid->wallIds[found[j].wall] == grid->wallIds[found[i].wall];
+			if (!duplicate) found[foundCount++] = found[i];
+		}
+	}
+	// put the contacts in wall manager order, so they get resolved in the same order as a plain loop over the walls would (and the ones kept are the first ones it would find)
+	for (int i = 1; i < foundCount; i++) {
+		WallContact contact = found[i];
+		int j = i;
+		for (; j > 0 && grid->wallIds[found[j - 1].wall] > grid->wallIds[contact.wall]; j--) found[j] = found[j - 1];
+		found[j] = contact;
+	}
+	foundCount = std::min(foundCount, maxContacts);
+	std::copy(found, found + foundCount, contacts);
+	grid->contactsFound += foundCount;
+	return foundCount;
+}
+
+// fills entries with (at most maxEntries of) the walls whose bounds touch the given area, without duplicates, and returns how many there are
+// (each entry is an index into grid->walls, like the contacts from QueryWallGrid; used for things that move too far to fit in a 3x3 query)
+int GatherWallGrid(WallGrid* grid, f32 minX, f32 minY, f32 maxX, f32 maxY, int* entries, int maxEntries) {
+	int firstColumn = GridColumn(grid, minX);
+	int lastColumn = GridColumn(grid, maxX);
+	Vec2 areaCenter = {(minX + maxX) / 2, (minY + maxY) / 2};
+	Vec2 areaBounds = {(maxX - minX) / 2, (maxY - minY) / 2};
+	int found = 0;
+	grid->queries++;
+	for (int row = GridRow(grid, minY); row <= GridRow(grid, maxY); row++) {
+		grid->cellsVisited += lastColumn - firstColumn + 1;
+		int last = grid->cellStarts[row * grid->columns + lastColumn + 1];
+		for (int entry = grid->cellStarts[row * grid->columns + firstColumn]; entry < last && found < maxEntries; entry++) {
+			Vec2 wallCenter = {grid->walls.centerX[entry], grid->walls.centerY[entry]};
+			if (!BoundsOverlap(areaCenter, areaBounds, wallCenter, grid->bounds[entry])) continue;
+			bool duplicate = false;
+			for (int i = 0; i < found && !duplicate; i++) duplicate = grid->wallIds[entries[i]] == grid->wallIds[entry];
+			if (!duplicate) entries[found++] = entry;
+		}
+	}
+	grid->wallsTested += found;
+	return found;
+}
+
+// sets the query counters back to 0
+void ResetWallGridCounters(WallGrid* grid) {
+	grid->queries = 0;
+	grid->cellsVisited = 0;
+	grid->wallsTested = 0;
+	grid->contactsFound = 0;
+}
\ No newline at end of file
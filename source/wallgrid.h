@@ -0,0 +1,54 @@
+#ifndef TANK_WALLGRID_H
+#define TANK_WALLGRID_H
+
+#include <stdlib.h>
+#include <gccore.h>
+#include <wiisprite.h>
+#include <vector>
+
+#include "collision.h"
+#include "wallbatch.h"
+
+using namespace wsp;
+
+// uniform grid over the map's cells that says which walls touch each cell, so collision queries only have to look at the walls near a collider
+// walls are copied into one batch grouped by cell (a wall is copied into every cell it touches), and since cells are stored row by row,
+// the cells of a row that a query covers are one contiguous run of the batch
+struct WallGrid {
+	int columns;
+	int rows;
+	f32 cellWidth;
+	f32 cellHeight;
+	std::vector<int> cellStarts; // index in walls of each cell's first wall (the last entry is the total)
+	WallBatch walls;
+	std::vector<int> wallIds; // wall manager index of each wall in the batch
+	std::vector<Vec2> bounds; // half width/height of the axis aligned box around each wall in the batch (spinners get the box around their whole circle of rotation, so this never changes)
+	int spinningWallCount; // walls with a wall manager index below this are spinners
+	std::vector<OrientedBox> spinners; // current box of each spinner, worked out once per frame by UpdateWallGridSpinners
+	std::vector<int> spinnerEntries; // batch indices of the spinning walls' copies, so they can be updated after they rotate
+	std::vector<WallContact> contacts; // where QueryWallGrid collects every copy's contact before it drops the duplicates (one for each copy, so it can never run out)
+	// query counters (reset with ResetWallGridCounters), for checking how much work the grid is saving
+	u32 queries;
+	u32 cellsVisited;
+	u32 wallsTested;
+	u32 contactsFound;
+};
+
+// fills the grid with every wall in the wall manager (the first spinningWallCount walls are spinners, and are indexed by everywhere they can rotate to)
+void BuildWallGrid(WallGrid* grid, LayerManager* wallManager, int spinningWallCount, int columns, int rows, f32 cellWidth, f32 cellHeight);
+
+// updates the grid's copies of the spinning walls after they've rotated (each spinner's box is worked out once, then copied to every cell it's in)
+void UpdateWallGridSpinners(WallGrid* grid, LayerManager* wallManager);
+
+// tests a box against the walls in the cells its bounds touch, fills contacts with (at most maxContacts of) the walls it's penetrating in wall manager order, and returns how many were found
+// (each contact's wall is an index into grid->walls; its wall manager index is grid->wallIds[wall]; anything smaller than a cell, like a tank or a bullet, touches at most the 3x3 cells around its center)
+int QueryWallGrid(WallGrid* grid, const OrientedBox* box, WallContact* contacts, int maxContacts);
+
+// fills entries with (at most maxEntries of) the walls whose bounds touch the given area, without duplicates, and returns how many there are
+// (each entry is an index into grid->walls, like the contacts from QueryWallGrid; used for things that move too far to fit in a 3x3 query)
+int GatherWallGrid(WallGrid* grid, f32 minX, f32 minY, f32 maxX, f32 maxY, int* entries, int maxEntries);
+
+// sets the query counters back to 0
+void ResetWallGridCounters(WallGrid* grid);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+// checks that bullets hit tanks with the box the old bullet sprite had, and bounce off walls however many others are near them
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "testcheck.h"
+#include "bulletsystem.h"
+
+int main() {
+	TextureCache textures;
+	BulletSystem bullets(8, 640, 480, &textures, NULL);
+
+	// the hit box against what the old bullet sprite's collision rectangle worked out to (the rectangle was 2 * radius wide, and stretched along with the image)
+	Sprite sprite;
+	sprite.SetImage(textures.Acquire(TEXTURE_BULLET));
+	const f32 radii[] = {1, 1.5, 2, 2.75, 3, 4, 6.5, 8, 16};
+	for (int i = 0; i < (int) (sizeof(radii) / sizeof(radii[0])); i++) {
+		f32 radius = radii[i];
+		sprite.SetStretchWidth(radius * 2 / sprite.GetImage()->GetWidth());
+		sprite.SetStretchHeight(radius * 2 / sprite.GetImage()->GetHeight());
+		sprite.DefineCollisionRectangle(0, 0, radius * 2, radius * 2);
+		sprite.SetPosition(100 - sprite.GetWidth() / 2, 50 - sprite.GetHeight() / 2);
+		OrientedBox old = GetOrientedBox(&sprite);
+		int bullet = bullets.Spawn(1, 100, 50, HalfDegreesToAngle(0), radius, 3);
+		OrientedBox box = bullets.GetBox(bullet);
+		CHECK(box.halfExtents.x == old.halfExtents.x && box.halfExtents.y == old.halfExtents.y, "radius %g: hit box is %gx%g, the old bullet's was %gx%g",
+			radius, box.halfExtents.x, box.halfExtents.y, old.halfExtents.x, old.halfExtents.y);
+		bullets.Clear();
+	}
+	textures.Release(TEXTURE_BULLET);
+
+	// a fast bullet heading for a wall, with more small walls than the old fixed size gather had room for (64) within its reach, all ahead of the wall
+	// in the grid (it's one cell, so they're in wall manager order), then the same with just the wall
+	for (int clutter = 0; clutter <= 200; clutter += 50) {
+		LayerManager wallManager(clutter + 1);
+		std::vector<Quad*> quads;
+		for (int i = 0; i <= clutter; i++) {
+			Quad* quad = new Quad();
+			bool wall = i == clutter;
+			quad->SetWidth(wall ? 8 : 2);
+			quad->SetHeight(wall ? 200 : 2);
+			quad->SetPosition(wall ? 200 : 20 + (i % 20) * 6, wall ? 0 : 150 + (i / 20) * 6);
+			wallManager.Append(quad);
+			quads.push_back(quad);
+		}
+		WallGrid grid;
+		BuildWallGrid(&grid, &wallManager, 0, 1, 1, 640, 480);
+		int bullet = bullets.Spawn(1, 100, 100, HalfDegreesToAngle(0), 2, 150);
+		int bounces = bullets.Update(1, &grid);
+		Vec2 position = bullets.GetPosition(bullet);
+		CHECK(bounces == 1, "%d small walls: the bullet bounced %d times, expected once", clutter, bounces);
+		CHECK(position.x < 200 - 2, "%d small walls: the bullet went through the wall to x = %g", clutter, position.x);
+		bullets.Clear();
+		for (int i = 0; i < (int) quads.size(); i++) delete quads[i];
+	}
+
+	return FinishTest("bulletsystemtest");
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+// checks the stack based separating axis test (Collision on two OBBs) against the vector based one it replaced, on random and edge case pairs,
+// then the oriented box version (which the tanks push out of walls with) against the stack based one
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <random>
+#include <vector>
+
+#include "testcheck.h"
+#include "collision.h"
+
+// how far apart the two versions' overlaps can be (they normalize edges with different float rounding, so they can be off in the last bits)
+#define COLLISION_TOLERANCE 1e-3f
+
+// the vector based version, as it was before (only changed to take the vertices as Vec2s, and to use fabs where it used abs on floats)
+typedef std::vector<std::vector<f32>> ReferenceVertices;
+
+static f32 ReferenceDotProduct(std::vector<f32> vector1, std::vector<f32> vector2) {
+	return (vector1[0] * vector2[0] + vector1[1] * vector2[1]);
+}
+static std::vector<f32> ReferenceNormalizeVector(std::vector<f32> vector) {
+	f32 magnitude = sqrt(pow(vector[0], 2) + pow(vector[1], 2));
+	return {vector[0] / magnitude, vector[1] / magnitude};
+}
+static std::vector<std::vector<f32>> ReferenceGetNormalVectors(std::vector<f32> vector) {
+	return {{-vector[1], vector[0]}, {vector[1], -vector[0]}};
+}
+static ReferenceVertices ReferenceGetEdgesFromVertices(ReferenceVertices vertices) {
+	int edgeCount = vertices.size();
+	ReferenceVertices edges(edgeCount, std::vector<f32>(2));
+	for (int vertex = 0; vertex < edgeCount; vertex++) {
+		edges[vertex][0] = vertices[(vertex + 1) % edgeCount][0] - vertices[vertex][0];
+		edges[vertex][1] = vertices[(vertex + 1) % edgeCount][1] - vertices[vertex][1];
+		edges[vertex] = ReferenceNormalizeVector(edges[vertex]);
+	}
+	return edges;
+}
+static ReferenceVertices ReferenceGetNormalsFromEdges(ReferenceVertices edges) {
+	int edgeCount = edges.size();
+	ReferenceVertices normals(edgeCount * 2, std::vector<f32>(2));
+	for (int vertex = 0; vertex < edgeCount; vertex++) {
+		ReferenceVertices edgeNormals = ReferenceGetNormalVectors(edges[vertex]);
+		normals[vertex * 2 + 0] = edgeNormals[0];
+		normals[vertex * 2 + 1] = edgeNormals[1];
+	}
+	return normals;
+}
+static std::vector<f32> ReferenceGetIntervalOnAxis(ReferenceVertices vertices, std::vector<f32> axis) {
+	std::vector<f32> interval(2);
+	for (int vertex = 0; vertex < (int) vertices.size(); vertex++) {
+		f32 d = ReferenceDotProduct(axis, vertices[vertex]);
+		if (vertex == 0) {
+			interval[0] = d;
+			interval[1] = d;
+		}
+		if (interval[0] > d) interval[0] = d;
+		if (interval[1] < d) interval[1] = d;
+	}
+	return interval;
+}
+static f32 ReferenceGetOverlapOnAxis(ReferenceVertices vertices1, ReferenceVertices vertices2, std::vector<f32> axis) {
+	f32 overlap = 0.0;
+	std::vector<f32> interval1 = ReferenceGetIntervalOnAxis(vertices1, axis);
+	std::vector<f32> interval2 = ReferenceGetIntervalOnAxis(vertices2, axis);
+	if ((interval2[0] < interval1[1]) && (interval1[0] < interval2[1])) overlap = interval2[0] - interval1[1];
+	return overlap;
+}
+static std::vector<f32> ReferenceCollision(ReferenceVertices vertices1, ReferenceVertices vertices2) {
+	int vertexCount1 = vertices1.size();
+	int vertexCount2 = vertices2.size();
+	ReferenceVertices axes(vertexCount1 + vertexCount2, std::vector<f32>(2));
+	ReferenceVertices normals1 = ReferenceGetNormalsFromEdges(ReferenceGetEdgesFromVertices(vertices1));
+	ReferenceVertices normals2 = ReferenceGetNormalsFromEdges(ReferenceGetEdgesFromVertices(vertices2));
+	ReferenceVertices collisionInfo(vertexCount1 + vertexCount2, std::vector<f32>(3));
+	int penetratingIndex = 0;
+	for (int i = 0; i < vertexCount1; i++) axes[i] = normals1[i * 2];
+	for (int i = 0; i < vertexCount2; i++) axes[vertexCount1 + i] = normals2[i * 2];
+	for (int i = 0; i < vertexCount1 + vertexCount2; i++) {
+		collisionInfo[i][0] = axes[i][0];
+		collisionInfo[i][1] = axes[i][1];
+		collisionInfo[i][2] = ReferenceGetOverlapOnAxis(vertices1, vertices2, axes[i]);
+		if (fabs(collisionInfo[i][2]) < fabs(collisionInfo[penetratingIndex][2])) penetratingIndex = i;
+	}
+	return collisionInfo[penetratingIndex];
+}
+
+static ReferenceVertices ToReference(const OBB* obb) {
+	ReferenceVertices vertices(4, std::vector<f32>(2));
+	for (int i = 0; i < 4; i++) {
+		vertices[i][0] = obb->vertices[i].x;
+		vertices[i][1] = obb->vertices[i].y;
+	}
+	return vertices;
+}
+
+static OBB MakeOBB(f32 x, f32 y, f32 halfWidth, f32 halfHeight, u32 turns) {
+	TiltedRect rect = {x, y, halfWidth, halfHeight, {turns}};
+	return TiltedRectVertices(&rect);
+}
+
+// compares the two versions on one pair: they have to agree on whether it's colliding (unless it's within the tolerance of touching) and by how much,
+// and the new one's axis has to be one the old one would've accepted (the same axis, or one that ties with it)
+static void CheckPair(const char* name, int index, const OBB* obb1, const OBB* obb2) {
+	Contact contact = Collision(obb1, obb2);
+	ReferenceVertices vertices1 = ToReference(obb1);
+	ReferenceVertices vertices2 = ToReference(obb2);
+	std::vector<f32> reference = ReferenceCollision(vertices1, vertices2);
+	bool touching = fabs(reference[2]) < COLLISION_TOLERANCE || fabs(contact.overlap) < COLLISION_TOLERANCE;
+	if (!touching) CHECK((contact.overlap != 0) == (reference[2] != 0), "%s %d: new overlap %g, old %g", name, index, contact.overlap, reference[2]);
+	CHECK(fabs(contact.overlap - reference[2]) < COLLISION_TOLERANCE, "%s %d: new overlap %g, old %g", name, index, contact.overlap, reference[2]);
+	bool sameAxis = fabs(contact.axis.x - reference[0]) < COLLISION_TOLERANCE && fabs(contact.axis.y - reference[1]) < COLLISION_TOLERANCE;
+	f32 overlapOnAxis = ReferenceGetOverlapOnAxis(vertices1, vertices2, {contact.axis.x, contact.axis.y});
+	CHECK(sameAxis || fabs(fabs(overlapOnAxis) - fabs(reference[2])) < COLLISION_TOLERANCE, "%s %d: new axis (%g, %g), old (%g, %g)", name, index, contact.axis.x, contact.axis.y, reference[0], reference[1]);
+}
+
+// checks the oriented box version on one pair against the vertex version: they have to agree on whether it's colliding (unless it's touching) and by how much,
+// the axis has to be one of the boxes' own (never its reverse), the overlap's sign has to say which side of box1 box2 is on, and the push out (axis * overlap)
+// has to leave the boxes just touching, and be the same as the vertex version's unless it came from another axis that ties with it
+static void CheckBoxPair(const char* name, int index, const TiltedRect* rect1, const TiltedRect* rect2) {
+	OrientedBox box1 = TiltedRectBox(rect1);
+	OrientedBox box2 = TiltedRectBox(rect2);
+	OBB obb1 = TiltedRectVertices(rect1);
+	OBB obb2 = TiltedRectVertices(rect2);
+	Contact contact = Collision(&box1, &box2);
+	Contact reference = Collision(&obb1, &obb2);
+	bool touching = fabs(reference.overlap) < COLLISION_TOLERANCE || fabs(contact.overlap) < COLLISION_TOLERANCE;
+	if (!touching) CHECK((contact.overlap != 0) == (reference.overlap != 0), "%s %d: box overlap %g, vertex %g", name, index, contact.overlap, reference.overlap);
+	CHECK(fabs(fabs(contact.overlap) - fabs(reference.overlap)) < COLLISION_TOLERANCE, "%s %d: box overlap %g, vertex %g", name, index, contact.overlap, reference.overlap);
+	if (contact.overlap == 0) return;
+	Vec2 axes[4] = {box1.axis, GetNormalVector(box1.axis), box2.axis, GetNormalVector(box2.axis)};
+	bool boxAxis = false;
+	for (int i = 0; i < 4; i++) boxAxis = boxAxis || (contact.axis.x == axes[i].x && contact.axis.y == axes[i].y);
+	CHECK(boxAxis, "%s %d: axis (%g, %g) isn't one of the boxes'", name, index, contact.axis.x, contact.axis.y);
+	f32 distance = DotProduct({box2.center.x - box1.center.x, box2.center.y - box1.center.y}, contact.axis);
+	CHECK((contact.overlap < 0) == (distance >= 0), "%s %d: overlap %g with box2 %g along the axis", name, index, contact.overlap, distance);
+	Vec2 push = {contact.axis.x * contact.overlap, contact.axis.y * contact.overlap};
+	Vec2 referencePush = {reference.axis.x * reference.overlap, reference.axis.y * reference.overlap};
+	bool samePush = fabs(push.x - referencePush.x) < COLLISION_TOLERANCE && fabs(push.y - referencePush.y) < COLLISION_TOLERANCE;
+	bool sameAxis = fabs(fabs(DotProduct(contact.axis, reference.axis)) - 1) < COLLISION_TOLERANCE;
+	CHECK(samePush || !sameAxis, "%s %d: push out (%g, %g), vertex (%g, %g)", name, index, push.x, push.y, referencePush.x, referencePush.y);
+	TiltedRect moved = *rect1;
+	moved.x += push.x;
+	moved.y += push.y;
+	OrientedBox movedBox = TiltedRectBox(&moved);
+	f32 left = Collision(&movedBox, &box2).overlap;
+	CHECK(fabs(left) < COLLISION_TOLERANCE, "%s %d: still %g in after pushing out by (%g, %g)", name, index, left, push.x, push.y);
+}
+
+int main() {
+	// touching: axis aligned boxes that share an edge or a corner exactly aren't colliding in either version (the interval test is strict)
+	OBB center = MakeOBB(100, 100, 10, 5, 0);
+	OBB right = MakeOBB(120, 100, 10, 5, 0);
+	OBB below = MakeOBB(100, 110, 10, 5, 0);
+	OBB corner = MakeOBB(120, 110, 10, 5, 0);
+	CheckPair("touching", 0, &center, &right);
+	CheckPair("touching", 1, &center, &below);
+	CheckPair("touching", 2, &center, &corner);
+	CHECK(Collision(&center, &right).overlap == 0 && Collision(&center, &below).overlap == 0 && Collision(&center, &corner).overlap == 0, "touching boxes collided");
+	// just overlapping, and just apart
+	OBB overlapping = MakeOBB(119, 100, 10, 5, 0);
+	OBB apart = MakeOBB(121, 100, 10, 5, 0);
+	CheckPair("overlapping", 0, &center, &overlapping);
+	CheckPair("apart", 0, &center, &apart);
+	CHECK(Collision(&center, &overlapping).overlap != 0 && Collision(&center, &apart).overlap == 0, "boxes 1 apart/overlapping wrong");
+	// containment, both ways round, and identical boxes
+	OBB inside = MakeOBB(102, 101, 3, 2, 0x12345678);
+	CheckPair("containment", 0, &center, &inside);
+	CheckPair("containment", 1, &inside, &center);
+	CheckPair("identical", 0, &center, &center);
+	// rotated: a wall and a tank at every 16th of a turn, centered on each other and then sliding along the wall's length
+	for (int step = 0; step < 16; step++) {
+		OBB wall = MakeOBB(300, 200, 44, 4, 0);
+		for (int offset = 0; offset < 8; offset++) {
+			OBB tank = MakeOBB(300 + offset * 8, 200 + offset * 2, 14, 12, step * 0x10000000u);
+			CheckPair("rotated", step * 8 + offset, &wall, &tank);
+		}
+	}
+	// random pairs around the same spot, so about half overlap
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<f32> position(-30, 30);
+	std::uniform_real_distribution<f32> size(1, 40);
+	for (int i = 0; i < 20000; i++) {
+		OBB obb1 = MakeOBB(position(rng), position(rng), size(rng), size(rng), rng());
+		OBB obb2 = MakeOBB(position(rng), position(rng), size(rng), size(rng), i % 4 ? rng() : 0);
+		CheckPair("random", i, &obb1, &obb2);
+	}
+	// oriented boxes: box2 on each side of box1, 1 in, which the vertex version gives as the axis pointing at box2 and -1, and this one as box1's own axis
+	// and a sign that points away from box2 (so the push out's the same either way)
+	TiltedRect centerRect = {100, 100, 10, 5, {0}};
+	TiltedRect sides[4] = {{119, 100, 10, 5, {0}}, {81, 100, 10, 5, {0}}, {100, 109, 10, 5, {0}}, {100, 91, 10, 5, {0}}};
+	OrientedBox centerBox = TiltedRectBox(&centerRect);
+	for (int side = 0; side < 4; side++) {
+		OrientedBox sideBox = TiltedRectBox(&sides[side]);
+		Contact contact = Collision(&centerBox, &sideBox);
+		Vec2 axis = side < 2 ? centerBox.axis : GetNormalVector(centerBox.axis);
+		f32 distance = DotProduct({sideBox.center.x - centerBox.center.x, sideBox.center.y - centerBox.center.y}, axis);
+		CHECK(contact.axis.x == axis.x && contact.axis.y == axis.y, "side %d: axis (%g, %g), expected (%g, %g)", side, contact.axis.x, contact.axis.y, axis.x, axis.y);
+		CHECK(fabs(contact.overlap - (distance > 0 ? -1 : 1)) < COLLISION_TOLERANCE, "side %d: overlap %g, expected %d", side, contact.overlap, distance > 0 ? -1 : 1);
+		OBB centerOBB = TiltedRectVertices(&centerRect);
+		OBB sideOBB = TiltedRectVertices(&sides[side]);
+		Contact reference = Collision(&centerOBB, &sideOBB);
+		f32 referenceDistance = DotProduct({sideBox.center.x - centerBox.center.x, sideBox.center.y - centerBox.center.y}, reference.axis);
+		CHECK(fabs(reference.overlap + 1) < COLLISION_TOLERANCE && referenceDistance > 0, "side %d: vertex version gave axis (%g, %g) and overlap %g", side, reference.axis.x, reference.axis.y, reference.overlap);
+		CheckBoxPair("sides", side, &centerRect, &sides[side]);
+	}
+	// the rotated and random pairs again, as oriented boxes
+	for (int step = 0; step < 16; step++) {
+		TiltedRect wall = {300, 200, 44, 4, {0}};
+		for (int offset = 0; offset < 8; offset++) {
+			TiltedRect tank = {300.0f + offset * 8, 200.0f + offset * 2, 14, 12, {step * 0x10000000u}};
+			CheckBoxPair("box rotated", step * 8 + offset, &tank, &wall);
+		}
+	}
+	for (int i = 0; i < 20000; i++) {
+		TiltedRect rect1 = {position(rng), position(rng), size(rng), size(rng), {(u32) rng()}};
+		TiltedRect rect2 = {position(rng), position(rng), size(rng), size(rng), {i % 4 ? (u32) rng() : 0}};
+		CheckBoxPair("box random", i, &rect1, &rect2);
+	}
+	return FinishTest("collisiontest");
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+// checks the exact commands the render queue sends the backend (host/renderer_host.cpp records them) for a scene built by hand and for a round of the game
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "testcheck.h"
+#include "renderer_host.h"
+#include "game.h"
+
+// the render log as text, like the host runner prints it but with the textures named: "Tbullet D5 T- L20" (T: texture set, - for none and ? for one not in images; D: quads drawn; L: display list called)
+static std::string DescribeRenderLog(const std::vector<const Image*>& images, const std::vector<const char*>& names) {
+	std::string description;
+	const std::vector<HostRenderCommand>* renderLog = GetHostRenderLog();
+	for (int i = 0; i < (int) renderLog->size(); i++) {
+		const HostRenderCommand* command = &(*renderLog)[i];
+		char text[64];
+		if (command->type == HOST_RENDER_SET_TEXTURE) {
+			const char* name = command->image ? "?" : "-";
+			for (int image = 0; image < (int) images.size(); image++) if (images[image] == command->image) name = names[image];
+			snprintf(text, sizeof(text), " T%s", name);
+		}
+		if (command->type == HOST_RENDER_DRAW_QUADS) snprintf(text, sizeof(text), " D%d", command->quadCount);
+		if (command->type == HOST_RENDER_CALL_DISPLAY_LIST) snprintf(text, sizeof(text), " L%d", command->quadCount);
+		if (command->type == HOST_RENDER_COMPILE_DISPLAY_LIST) snprintf(text, sizeof(text), " C%d", command->quadCount);
+		description += text;
+	}
+	return description.empty() ? description : description.substr(1);
+}
+
+// checks the counts' change since before against what's expected
+static void CheckCounts(const char* name, const HostRenderCounts* before, u64 drawCalls, u64 displayListCalls, u64 textureChanges, u64 quads) {
+	const HostRenderCounts* counts = GetHostRenderCounts();
+	CHECK(counts->drawCalls - before->drawCalls == drawCalls, "%s: %llu quad draws, expected %llu", name, (unsigned long long) (counts->drawCalls - before->drawCalls), (unsigned long long) drawCalls);
+	CHECK(counts->displayListCalls - before->displayListCalls == displayListCalls, "%s: %llu display list calls, expected %llu", name,
+		(unsigned long long) (counts->displayListCalls - before->displayListCalls), (unsigned long long) displayListCalls);
+	CHECK(counts->textureChanges - before->textureChanges == textureChanges, "%s: %llu texture changes, expected %llu", name,
+		(unsigned long long) (counts->textureChanges - before->textureChanges), (unsigned long long) textureChanges);
+	CHECK(counts->quads - before->quads == quads, "%s: %llu quads, expected %llu", name, (unsigned long long) (counts->quads - before->quads), (unsigned long long) quads);
+}
+
+int main() {
+	GameWindow gwd;
+	InitPlatform(&gwd);
+
+	// a scene built by hand, added in the worst order for textures: the passes out of order, and the tanks' and explosions' sprites alternating
+	{
+		TextureCache textures;
+		Image* background = textures.Acquire(TEXTURE_BACKGROUND);
+		Image* bullet = textures.Acquire(TEXTURE_BULLET);
+		Image* tanks = textures.Acquire(TEXTURE_TANKS);
+		Image* explosion = textures.Acquire(TEXTURE_EXPLOSION);
+		std::vector<const Image*> images = {background, bullet, tanks, explosion};
+		std::vector<const char*> names = {"background", "bullet", "tanks", "explosion"};
+		LayerManager walls(24);
+		for (int i = 0; i < 22; i++) {
+			Quad* wall = new Quad();
+			wall->SetWidth(8);
+			wall->SetHeight(80);
+			wall->SetPosition(i * 20, i < 2 ? 100 : 0);
+			walls.Append(wall);
+		}
+		Sprite sprites[12];
+		for (int i = 0; i < 12; i++) sprites[i].SetImage(i < 5 ? bullet : i < 11 ? (i % 2 ? tanks : explosion) : background);
+
+		GetHostRenderLog()->clear();
+		HostRenderCounts before = *GetHostRenderCounts();
+		RenderDisplayList* staticWalls = CompileQuadLayers(&walls, 2, 22); // the first 2 are "spinners"
+		CHECK(DescribeRenderLog(images, names) == "C20", "compiling the walls sent: %s", DescribeRenderLog(images, names).c_str());
+		CHECK(GetHostRenderCounts()->displayListsCompiled - before.displayListsCompiled == 1, "the walls should compile to one display list");
+		GetHostRenderLog()->clear();
+
+		RenderQueue queue;
+		for (int i = 5; i < 11; i++) queue.AddSprite(i % 2 ? RENDER_PASS_TANKS : RENDER_PASS_EXPLOSIONS, &sprites[i]);
+		queue.AddQuads(RENDER_PASS_WALLS, &walls, 0, 2);
+		queue.AddDisplayList(RENDER_PASS_WALLS, staticWalls);
+		for (int i = 0; i < 5; i++) queue.AddSprite(RENDER_PASS_BULLETS, &sprites[i]);
+		queue.AddSprite(RENDER_PASS_BACKGROUND, &sprites[11]);
+		queue.Flush();
+		std::string description = DescribeRenderLog(images, names);
+		CHECK(description == "Tbackground D1 Tbullet D5 T- D2 L20 Ttanks D3 Texplosion D3", "the scene sent: %s", description.c_str());
+		CheckCounts("scene", &before, 5, 1, 5, 34);
+		CHECK(queue.GetDrawCalls() == 6 && queue.GetStateChanges() == 5 && queue.GetQuadCount() == 34, "the scene's queue counted %d draws, %d state changes and %d quads",
+			queue.GetDrawCalls(), queue.GetStateChanges(), queue.GetQuadCount());
+
+		// flushing again draws nothing
+		GetHostRenderLog()->clear();
+		queue.Flush();
+		CHECK(GetHostRenderLog()->empty(), "an empty flush sent: %s", DescribeRenderLog(images, names).c_str());
+
+		FreeRenderDisplayList(staticWalls);
+		for (int i = 0; i < (int) walls.GetSize(); i++) delete walls.GetLayerAt(i);
+		textures.Release(TEXTURE_BACKGROUND);
+		textures.Release(TEXTURE_BULLET);
+		textures.Release(TEXTURE_TANKS);
+		textures.Release(TEXTURE_EXPLOSION);
+	}
+
+	// rounds of the game with nobody pressing anything, so there's a background, the walls (the static ones in one display list, compiled once a round) and the tanks
+	for (u32 seed = 1; seed <= 10; seed++) {
+		Game* game = new Game(640, 480, seed);
+		game->StartGame(4);
+		InputState input;
+		memset(&input, 0, sizeof(InputState));
+		HostRenderCounts before = *GetHostRenderCounts();
+		for (int step = 0; step < 3; step++) game->Update(&input);
+		CHECK(GetHostRenderCounts()->displayListsCompiled - before.displayListsCompiled == 1, "seed %u: the round should compile the walls once", seed);
+		for (int frame = 0; frame < 3; frame++) {
+			Map* map = game->GetMap();
+			LayerManager* tankManager = game->GetTankManager();
+			int spinners = map->GetSpinningWalls();
+			int staticWalls = game->GetWallManager()->GetSize() - spinners;
+			std::vector<const Image*> images = {((Sprite*) tankManager->GetLayerAt(0))->GetImage()};
+			std::vector<const char*> names = {"tanks"};
+			char expected[128];
+			snprintf(expected, sizeof(expected), "T? D1 T-%s%s L%d Ttanks D%d", spinners ? " D" : "", spinners ? std::to_string(spinners).c_str() : "", staticWalls, (int) tankManager->GetSize());
+			GetHostRenderLog()->clear();
+			before = *GetHostRenderCounts();
+			game->Draw(frame == 1 ? .5f : 1);
+			std::string description = DescribeRenderLog(images, names);
+			CHECK(description == expected, "seed %u frame %d: the game sent \"%s\", expected \"%s\"", seed, frame, description.c_str(), expected);
+			CheckCounts("game", &before, spinners ? 3 : 2, 1, 3, 1 + spinners + staticWalls + tankManager->GetSize());
+			CHECK(GetHostRenderCounts()->displayListsCompiled == before.displayListsCompiled, "seed %u frame %d: drawing compiled a display list", seed, frame);
+			game->Update(&input);
+		}
+		delete game;
+	}
+
+	ShutdownPlatform(&gwd);
+	return FinishTest("rendertest");
+}
\ No newline at end of file
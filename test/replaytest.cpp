@@ -0,0 +1,101 @@
+// checks that replays load back the way they were saved, and that LoadReplay turns down files whose header doesn't match their data (before it allocates for them)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <vector>
+
+#include "testcheck.h"
+#include "replay.h"
+
+#define REPLAY_TEST_PATH "replaytest.wtr"
+
+// reads/writes a whole file
+static std::vector<u8> ReadTestFile(const char* path) {
+	std::vector<u8> data;
+	FILE* file = fopen(path, "rb");
+	if (!file) return data;
+	int byte;
+	while ((byte = fgetc(file)) != EOF) data.push_back(byte);
+	fclose(file);
+	return data;
+}
+static void WriteTestFile(const char* path, const std::vector<u8>& data) {
+	FILE* file = fopen(path, "wb");
+	fwrite(data.data(), 1, data.size(), file);
+	fclose(file);
+}
+static void SetU32(std::vector<u8>* data, int offset, u32 value) {
+	for (int i = 0; i < 4; i++) (*data)[offset + i] = (value >> (8 * i)) & 0xff;
+}
+
+// writes a changed copy of a saved replay, and checks it won't load
+static void CheckRejected(const char* name, std::vector<u8> file) {
+	WriteTestFile(REPLAY_TEST_PATH, file);
+	Replay replay;
+	CHECK(!LoadReplay(&replay, REPLAY_TEST_PATH), "%s loaded", name);
+	CHECK(replay.data.empty() && replay.stepCount == 0, "%s left %u steps and %u bytes in the replay", name, replay.stepCount, (u32) replay.data.size());
+}
+
+int main() {
+	// a replay of random input, from nobody pressing anything to everyone changing every button every step
+	std::mt19937 rng(1);
+	Replay recorded;
+	StartReplayRecording(&recorded, 1234, 4, 6);
+	InputState input;
+	memset(&input, 0, sizeof(InputState));
+	std::vector<u32> hashes;
+	for (int step = 0; step < 2000; step++) {
+		for (int player = 0; player < MAX_PLAYERS; player++) {
+			if (rng() % 4 < (u32) step / 500) input.players[player].held = rng() & 0xffff;
+			input.players[player].down = rng() % 8 == 0 ? rng() & 0xffff : 0;
+		}
+		hashes.push_back(rng());
+		RecordReplayStep(&recorded, &input, hashes.back());
+	}
+	CHECK(SaveReplay(&recorded, REPLAY_TEST_PATH), "couldn't save the replay");
+	std::vector<u8> file = ReadTestFile(REPLAY_TEST_PATH);
+
+	Replay loaded;
+	CHECK(LoadReplay(&loaded, REPLAY_TEST_PATH), "the saved replay didn't load");
+	CHECK(loaded.seed == 1234 && loaded.tankCount == 4 && loaded.ammo == 6 && loaded.stepCount == 2000, "the header came back as seed %u, %d tanks, %d ammo, %u steps",
+		loaded.seed, loaded.tankCount, loaded.ammo, loaded.stepCount);
+	CHECK(loaded.data == recorded.data, "the steps came back different");
+	u32 hash;
+	int steps = 0;
+	while (ReadReplayStep(&loaded, &input, &hash)) CHECK(hash == hashes[steps++], "step %d's hash came back different", steps - 1);
+	CHECK(steps == 2000, "%d steps played back", steps);
+
+	// the header is 24 bytes, with the step count at 16 and the data size at 20
+	CheckRejected("an empty file", std::vector<u8>());
+	CheckRejected("half a header", std::vector<u8>(file.begin(), file.begin() + 12));
+	CheckRejected("a truncated file", std::vector<u8>(file.begin(), file.end() - 1));
+	std::vector<u8> extra = file;
+	extra.push_back(0);
+	CheckRejected("a file with a byte too many", extra);
+	std::vector<u8> corrupt = file;
+	SetU32(&corrupt, 20, 0xffffffff);
+	CheckRejected("a 4GB data size", corrupt);
+	corrupt = file;
+	SetU32(&corrupt, 20, file.size() - 24 + 1);
+	CheckRejected("a data size a byte past the end", corrupt);
+	corrupt = file;
+	SetU32(&corrupt, 16, 0xffffffff);
+	CheckRejected("4 billion steps", corrupt);
+	corrupt = file;
+	SetU32(&corrupt, 16, (file.size() - 24) / 5 + 1);
+	CheckRejected("more steps than the data can hold", corrupt);
+	corrupt = file;
+	SetU32(&corrupt, 16, 1);
+	CheckRejected("fewer steps than the data has", corrupt);
+	corrupt = file;
+	corrupt[0] = 'X';
+	CheckRejected("the wrong magic", corrupt);
+	// and a replay with no steps is still fine
+	Replay empty;
+	StartReplayRecording(&empty, 1, 2, 6);
+	CHECK(SaveReplay(&empty, REPLAY_TEST_PATH) && LoadReplay(&loaded, REPLAY_TEST_PATH) && loaded.stepCount == 0, "a replay with no steps didn't load");
+
+	remove(REPLAY_TEST_PATH);
+	return FinishTest("replaytest");
+}
\ No newline at end of file
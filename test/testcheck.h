@@ -0,0 +1,38 @@
+#ifndef TANK_TESTCHECK_H
+#define TANK_TESTCHECK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "collision.h"
+
+// shared by the host tests (run with make test): a check that fails prints where it was and why, and the test carries on so every failure shows up at once,
+// then FinishTest prints a summary and gives the exit code (non-zero if anything failed, so make test stops there)
+
+static int testChecks = 0;
+static int testFailures = 0;
+
+// checks a condition, and prints the message (printf style) if it's false
+#define CHECK(condition, ...) do { \
+	testChecks++; \
+	if (!(condition)) { \
+		testFailures++; \
+		printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #condition); \
+		printf(__VA_ARGS__); \
+		printf("\n"); \
+	} \
+} while (0)
+
+// prints how many checks passed, and returns the test's exit code
+static inline int FinishTest(const char* name) {
+	printf("%s: %d/%d checks passed\n", name, testChecks - testFailures, testChecks);
+	return testFailures ? 1 : 0;
+}
+
+// makes the oriented box of a tilted rectangle, for tests that build their own walls and tanks
+static inline OrientedBox MakeBox(f32 x, f32 y, f32 halfWidth, f32 halfHeight, u32 turns) {
+	TiltedRect rect = {x, y, halfWidth, halfHeight, {turns}};
+	return TiltedRectBox(&rect);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+// checks BatchCollision against testing each wall on its own with Collision, which is what its kernels are meant to be a faster way of doing
+// (make test runs this twice: built with the host's simd kernel, and with the plain c one; the wii's paired singles kernel can only be checked on a wii)
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+#include "testcheck.h"
+#include "wallbatch.h"
+
+// the walls from first to last that a box is penetrating, in wall order, the slow way
+static std::vector<WallContact> ReferenceContacts(const OrientedBox* box, const WallBatch* batch, int first, int last) {
+	std::vector<WallContact> contacts;
+	for (int wall = first; wall < last; wall++) {
+		OrientedBox wallBox = GetWallBox(batch, wall);
+		Contact contact = Collision(box, &wallBox);
+		if (contact.overlap == 0) continue;
+		WallContact wallContact = {wall, contact};
+		contacts.push_back(wallContact);
+	}
+	return contacts;
+}
+
+// checks one query against the reference, for every limit on contacts from none to more than there are
+static void CheckQuery(const char* name, int index, const OrientedBox* box, const WallBatch* batch, int first, int last) {
+	std::vector<WallContact> reference = ReferenceContacts(box, batch, first, last);
+	for (int maxContacts = 0; maxContacts <= (int) reference.size() + 1; maxContacts++) {
+		WallContact contacts[64];
+		int found = BatchCollision(box, batch, first, last, contacts, maxContacts);
+		int expected = std::min((int) reference.size(), maxContacts);
+		CHECK(found == expected, "%s %d (walls %d-%d, max %d): %d contacts, expected %d", name, index, first, last, maxContacts, found, expected);
+		for (int i = 0; i < std::min(found, expected); i++) {
+			const Contact* contact = &contacts[i].contact;
+			const Contact* expectedContact = &reference[i].contact;
+			CHECK(contacts[i].wall == reference[i].wall, "%s %d (max %d): contact %d is wall %d, expected %d", name, index, maxContacts, i, contacts[i].wall, reference[i].wall);
+			CHECK(contact->overlap == expectedContact->overlap && contact->axis.x == expectedContact->axis.x && contact->axis.y == expectedContact->axis.y,
+				"%s %d (max %d): contact %d has overlap %g, expected %g", name, index, maxContacts, i, contact->overlap, expectedContact->overlap);
+		}
+	}
+}
+
+int main() {
+	printf("wallbatchtest: %s kernel\n", GetWallBatchKernel());
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<f32> position(-40, 40);
+	std::uniform_real_distribution<f32> length(4, 60);
+	WallBatch batch;
+
+	// every batch size from empty to a few past 4 vector widths, so every size of leftover tail gets run (walls at random around the box, so some hit)
+	for (int size = 0; size <= 19; size++) {
+		for (int trial = 0; trial < 50; trial++) {
+			ClearWallBatch(&batch);
+			for (int i = 0; i < size; i++) {
+				OrientedBox wall = MakeBox(position(rng), position(rng), length(rng), 4, rng() % 3 ? 0 : rng());
+				AddToWallBatch(&batch, &wall);
+			}
+			OrientedBox box = MakeBox(position(rng) / 2, position(rng) / 2, 14, 12, rng());
+			CheckQuery("size", size * 100 + trial, &box, &batch, 0, size);
+			// and every range within it, so the vector loads start at every alignment
+			if (trial < 5) {
+				for (int first = 0; first <= size; first++) {
+					for (int last = first; last <= size; last++) CheckQuery("range", size * 100 + trial, &box, &batch, first, last);
+				}
+			}
+		}
+	}
+
+	// a box in a pile of walls, so it touches more of them than WALLBATCH_MAX_CONTACTS (which callers would truncate at)
+	ClearWallBatch(&batch);
+	for (int i = 0; i < 37; i++) {
+		OrientedBox wall = MakeBox(position(rng) / 4, position(rng) / 4, length(rng), 4, rng());
+		AddToWallBatch(&batch, &wall);
+	}
+	OrientedBox box = MakeBox(0, 0, 14, 12, 0);
+	CHECK((int) ReferenceContacts(&box, &batch, 0, batch.count).size() > WALLBATCH_MAX_CONTACTS, "the pile should touch more than %d walls", WALLBATCH_MAX_CONTACTS);
+	CheckQuery("pile", 0, &box, &batch, 0, batch.count);
+
+	// walls exactly touching an axis aligned box (on whole numbers, so there's no rounding) aren't penetrating, and ones a pixel closer are
+	ClearWallBatch(&batch);
+	f32 edges[][2] = {{24, 0}, {-24, 0}, {0, 16}, {0, -16}, {23, 0}, {-23, 0}, {0, 15}, {0, -15}, {24, 16}};
+	for (int i = 0; i < 9; i++) {
+		OrientedBox wall = MakeBox(edges[i][0], edges[i][1], 10, 4, 0);
+		AddToWallBatch(&batch, &wall);
+	}
+	box = MakeBox(0, 0, 14, 12, 0);
+	std::vector<WallContact> touching = ReferenceContacts(&box, &batch, 0, batch.count);
+	CHECK(touching.size() == 4 && touching[0].wall == 4 && touching[3].wall == 7, "%d of the touching/overlapping walls collided, expected the 4 overlapping ones", (int) touching.size());
+	CheckQuery("touching", 0, &box, &batch, 0, batch.count);
+
+	// LoadWallBatch keeps the wall manager's order
+	LayerManager wallManager(8);
+	std::vector<Quad*> quads;
+	for (int i = 0; i < 8; i++) {
+		Quad* quad = new Quad();
+		quad->SetWidth(40 + i);
+		quad->SetHeight(8);
+		quad->SetPosition(i * 10, i * 5);
+		quad->SetRotation(i * 20);
+		wallManager.Append(quad);
+		quads.push_back(quad);
+	}
+	LoadWallBatch(&batch, &wallManager);
+	CHECK(batch.count == 8, "loaded %d walls", batch.count);
+	for (int i = 0; i < batch.count; i++) {
+		OrientedBox expected = GetOrientedBox(quads[i]);
+		OrientedBox wall = GetWallBox(&batch, i);
+		CHECK(wall.center.x == expected.center.x && wall.center.y == expected.center.y && wall.axis.x == expected.axis.x, "wall %d doesn't match its quad", i);
+	}
+	box = MakeBox(30, 20, 14, 12, 0x20000000);
+	CheckQuery("loaded", 0, &box, &batch, 0, batch.count);
+	for (int i = 0; i < (int) quads.size(); i++) delete quads[i];
+
+	return FinishTest("wallbatchtest");
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+// checks QueryWallGrid against testing a box with Collision against every wall the slow way, on generated maps (spinners included) and a grid built by hand
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+#include "testcheck.h"
+#include "map.h"
+
+// the wall manager indices of the walls a box is penetrating, in wall manager order, the slow way
+static std::vector<int> ReferenceWalls(const OrientedBox* box, LayerManager* wallManager) {
+	std::vector<int> walls;
+	for (int i = 0; i < (int) wallManager->GetSize(); i++) {
+		OrientedBox wall = GetOrientedBox((Quad*) wallManager->GetLayerAt(i));
+		if (Collision(box, &wall).overlap != 0) walls.push_back(i);
+	}
+	return walls;
+}
+
+// checks one query against the reference: the same walls in the same order (the first maxContacts of them, if there are more), with the same contacts
+static void CheckQuery(const char* name, int index, WallGrid* grid, LayerManager* wallManager, const OrientedBox* box, int maxContacts) {
+	std::vector<int> reference = ReferenceWalls(box, wallManager);
+	WallContact contacts[64];
+	int found = QueryWallGrid(grid, box, contacts, maxContacts);
+	int expected = std::min((int) reference.size(), maxContacts);
+	CHECK(found == expected, "%s %d (max %d): %d contacts, expected %d", name, index, maxContacts, found, expected);
+	for (int i = 0; i < std::min(found, expected); i++) {
+		int wall = grid->wallIds[contacts[i].wall];
+		CHECK(wall == reference[i], "%s %d (max %d): contact %d is wall %d, expected %d", name, index, maxContacts, i, wall, reference[i]);
+		OrientedBox wallBox = GetOrientedBox((Quad*) wallManager->GetLayerAt(wall));
+		Contact contact = Collision(box, &wallBox);
+		CHECK(contacts[i].contact.overlap == contact.overlap, "%s %d: contact %d has overlap %g, expected %g", name, index, i, contacts[i].contact.overlap, contact.overlap);
+	}
+}
+
+int main() {
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<f32> x(-20, 660);
+	std::uniform_real_distribution<f32> y(-20, 500);
+
+	// the game's maps: tank sized boxes (the collision rectangle's 28x24), bullet sized ones, and ones bigger than a cell, all over the screen
+	// (and off it a bit, since the grid clamps to its edges), with the spinners turned between queries
+	LayerManager wallManager(200);
+	for (u32 seed = 1; seed <= 20; seed++) {
+		Map* map = new Map(640, 480, 8, 6, 8, seed);
+		map->GenerateWalls(&wallManager);
+		WallGrid* grid = map->GetWallGrid();
+		for (int i = 0; i < 300; i++) {
+			if (i % 50 == 0) {
+				for (int spinner = 0; spinner < map->GetSpinningWalls(); spinner++) {
+					Quad* quad = (Quad*) wallManager.GetLayerAt(spinner);
+					quad->SetRotation(quad->GetRotation() + 37);
+				}
+				map->UpdateWallGrid(&wallManager);
+			}
+			OrientedBox tank = MakeBox(x(rng), y(rng), 14, 12, rng());
+			OrientedBox bullet = MakeBox(x(rng), y(rng), 2, 2, 0);
+			OrientedBox big = MakeBox(x(rng), y(rng), 30 + rng() % 120, 8 + rng() % 60, rng());
+			CheckQuery("tank", seed * 1000 + i, grid, &wallManager, &tank, WALLBATCH_MAX_CONTACTS);
+			CheckQuery("bullet", seed * 1000 + i, grid, &wallManager, &bullet, WALLBATCH_MAX_CONTACTS);
+			CheckQuery("big", seed * 1000 + i, grid, &wallManager, &big, 64);
+		}
+		map->Destroy(&wallManager);
+	}
+
+	// a grid built by hand: long walls that each span every cell of a row or column (so every query sees several copies of each),
+	// crossed by a box that touches all of them, queried with every limit on contacts (duplicates used to take up the caller's slots, so this came up short)
+	std::vector<Quad*> quads;
+	for (int i = 0; i < 6; i++) {
+		Quad* quad = new Quad();
+		bool across = i % 2 == 0;
+		quad->SetWidth(across ? 400 : 8);
+		quad->SetHeight(across ? 8 : 300);
+		quad->SetPosition(across ? 0 : 90 + i * 8, across ? 130 + i * 8 : 0);
+		wallManager.Append(quad);
+		quads.push_back(quad);
+	}
+	WallGrid grid;
+	BuildWallGrid(&grid, &wallManager, 0, 5, 4, 80, 75);
+	OrientedBox box = MakeBox(120, 160, 40, 40, 0);
+	CHECK(ReferenceWalls(&box, &wallManager).size() == 6, "the box should touch all 6 walls");
+	for (int maxContacts = 0; maxContacts <= 7; maxContacts++) CheckQuery("long walls", 0, &grid, &wallManager, &box, maxContacts);
+	for (int i = 0; i < 2000; i++) {
+		OrientedBox random = MakeBox(x(rng) * .6f, y(rng) * .6f, 4 + rng() % 60, 4 + rng() % 60, rng());
+		CheckQuery("long walls random", i, &grid, &wallManager, &random, 1 + i % 6);
+	}
+	for (int i = 0; i < (int) quads.size(); i++) delete quads[i];
+
+	return FinishTest("wallgridtest");
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <string>
+
+#include "assetarchive.h"
+#include "mixer.h"
+
+// packs the game's assets into one archive (see assetarchive.h), run by the build on the machine doing the building
+// everything's packed as it is except the sound effects (.pcm files, 16-bit stereo 44.1khz), which are mixed down to mono and resampled to -rate (22.05khz by default),
+// so they take a quarter of the memory and the dsp still plays them with no decoding
+// after writing the archive, it reads it back (both as a file and from memory, the two ways the game can open one) and checks every asset against the file it came from:
+// files have to come back exactly, and sounds (expanded back to 44.1khz stereo with the host mixer, the way they'll be played) have to be within ASSETPACK_MIN_SNR of the original
+// usage: assetpack [-rate n] <archive> <files...>
+//        assetpack -list <archive>
+
+// the rate sound effects are stored at unless -rate says otherwise
+#define ASSETPACK_DEFAULT_RATE 22050
+// the rate the .pcm files are at
+#define ASSETPACK_SOURCE_RATE 44100
+// how close (signal to noise, in db) a sound has to come back to the original (anything that's really broken comes back far below this)
+#define ASSETPACK_MIN_SNR 20.0
+// the resampling filter reaches this many source samples either side of each sample
+#define ASSETPACK_FILTER_RADIUS 32
+
+// reads a whole file (returns false if it can't be read)
+static bool ReadFile(const char* path, std::vector<u8>* data) {
+	FILE* file = fopen(path, "rb");
+	if (!file) return false;
+	data->clear();
+	u8 buffer[64 * 1024];
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) data->insert(data->end(), buffer, buffer + count);
+	bool valid = !ferror(file);
+	fclose(file);
+	return valid;
+}
+
+static const char* BaseName(const char* path) {
+	const char* slash = strrchr(path, '/');
+	return slash ? slash + 1 : path;
+}
+
+static bool IsSound(const char* name) {
+	size_t length = strlen(name);
+	return length > 4 && !strcmp(name + length - 4, ".pcm");
+}
+
+static s16 ClampSample(f64 sample) {
+	sample = floor(sample + 0.5);
+	return sample < -32768 ? -32768 : sample > 32767 ? 32767 : (s16) sample;
+}
+
+// mixes a 44.1khz stereo sound down to mono at rate (which has to divide 44.1khz evenly), through a windowed sinc low pass filter so nothing above the new rate's nyquist frequency folds back down
+// (the output's padded with silence to a multiple of ASSET_ALIGNMENT bytes, which asndlib wants)
+static void ConvertSound(const std::vector<u8>& source, u32 rate, std::vector<u8>* output) {
+	const s16* samples = (const s16*) source.data();
+	int frames = source.size() / 4;
+	int factor = ASSETPACK_SOURCE_RATE / rate;
+	// cut off a little below nyquist, so the filter's rolled off by the time it gets there
+	f64 cutoff = 0.45 / factor;
+	f64 taps[2 * ASSETPACK_FILTER_RADIUS + 1];
+	f64 total = 0;
+	for (int i = -ASSETPACK_FILTER_RADIUS; i <= ASSETPACK_FILTER_RADIUS; i++) {
+		f64 sinc = i ? sin(2 * M_PI * cutoff * i) / (M_PI * i) : 2 * cutoff;
+		f64 window = 0.42 + 0.5 * cos(M_PI * i / ASSETPACK_FILTER_RADIUS) + 0.08 * cos(2 * M_PI * i / ASSETPACK_FILTER_RADIUS); // blackman
+		taps[i + ASSETPACK_FILTER_RADIUS] = sinc * window;
+		total += sinc * window;
+	}
+	int length = (frames + factor - 1) / factor;
+	output->assign((length * 2 + ASSET_ALIGNMENT - 1) / ASSET_ALIGNMENT * ASSET_ALIGNMENT, 0);
+	s16* converted = (s16*) output->data();
+	for (int i = 0; i < length; i++) {
+		f64 sum = 0;
+		for (int tap = -ASSETPACK_FILTER_RADIUS; tap <= ASSETPACK_FILTER_RADIUS; tap++) {
+			int frame = i * factor + tap;
+			if (frame < 0 || frame >= frames) continue;
+			sum += taps[tap + ASSETPACK_FILTER_RADIUS] * (samples[frame * 2] + samples[frame * 2 + 1]) * 0.5;
+		}
+		converted[i] = ClampSample(sum / total);
+	}
+}
+
+// expands a packed sound back to 44.1khz stereo through the host mixer, and returns how close it is to the original (signal to noise, in db)
+static f64 CompareSound(const AssetInfo* asset, const u8* data, const std::vector<u8>& original) {
+	int frames = original.size() / 4;
+	std::vector<s16> expanded(frames * 2);
+	MixerVoice voice = {(const s16*) data, asset->size / (2 * asset->channels), 0, MIXER_STEP(asset->rate), (int) asset->channels, MIXER_FULL_VOLUME};
+	int count = ExpandVoice(&voice, expanded.data(), frames);
+	const s16* samples = (const s16*) original.data();
+	f64 signal = 0;
+	f64 noise = 0;
+	for (int i = 0; i < frames * 2; i++) {
+		f64 error = (i < count * 2 ? expanded[i] : 0) - samples[i];
+		signal += (f64) samples[i] * samples[i];
+		noise += error * error;
+	}
+	if (noise == 0) return INFINITY;
+	return 10 * log10(signal / noise);
+}
+
+// prints an archive's table
+static int ListArchive(const char* path) {
+	AssetArchive archive;
+	if (!OpenAssetArchiveFile(&archive, path)) {
+		fprintf(stderr, "assetpack: %s isn't an asset archive\n", path);
+		return 1;
+	}
+	printf("name,type,offset,size,rate,channels\n");
+	for (u32 i = 0; i < archive.assets.size(); i++) {
+		const AssetInfo* asset = &archive.assets[i];
+		printf("%s,%s,%u,%u,%u,%u\n", asset->name, asset->type == ASSET_SOUND ? "sound" : "raw", asset->offset, asset->size, asset->rate, asset->channels);
+	}
+	CloseAssetArchive(&archive);
+	return 0;
+}
+
+// reads the archive back both ways the game can open it, and checks each asset against the file it came from (returns false if anything doesn't match)
+static bool VerifyArchive(const char* path, const std::vector<std::string>& names, const std::vector<std::vector<u8> >& originals) {
+	AssetArchive paged;
+	AssetArchive loaded;
+	std::vector<u8> bytes;
+	if (!OpenAssetArchiveFile(&paged, path) || !ReadFile(path, &bytes)) {
+		fprintf(stderr, "assetpack: can't read %s back\n", path);
+		return false;
+	}
+	// in memory, the archive has to be aligned like the game's built in one
+	std::vector<u8> buffer(bytes.size() + ASSET_ALIGNMENT);
+	u8* memory = buffer.data() + (ASSET_ALIGNMENT - (uintptr_t) buffer.data() % ASSET_ALIGNMENT) % ASSET_ALIGNMENT;
+	memcpy(memory, bytes.data(), bytes.size());
+	bool valid = OpenAssetArchive(&loaded, memory, bytes.size()) && loaded.assets.size() == names.size();
+	u32 sourceBytes = 0;
+	printf("asset,type,source_bytes,packed_bytes,snr_db\n");
+	for (u32 i = 0; valid && i < names.size(); i++) {
+		const AssetInfo* asset = FindAsset(&loaded, names[i].c_str());
+		const AssetInfo* pagedAsset = FindAsset(&paged, names[i].c_str());
+		const u8* data = asset ? LoadAsset(&loaded, asset) : NULL;
+		const u8* pagedData = pagedAsset ? LoadAsset(&paged, pagedAsset) : NULL;
+		// both ways of reading it have to give the same bytes, at the alignment the dsp needs
+		valid = data && pagedData && asset->size == pagedAsset->size && !memcmp(data, pagedData, asset->size);
+		valid = valid && !((uintptr_t) data % ASSET_ALIGNMENT) && !((uintptr_t) pagedData % ASSET_ALIGNMENT);
+		if (valid && asset->type == ASSET_SOUND) {
+			f64 snr = CompareSound(asset, data, originals[i]);
+			printf("%s,sound,%u,%u,%.1f\n", asset->name, (u32) originals[i].size(), asset->size, snr);
+			valid = snr >= ASSETPACK_MIN_SNR;
+		}
+		else if (valid) {
+			printf("%s,raw,%u,%u,\n", asset->name, (u32) originals[i].size(), asset->size);
+			valid = asset->size == originals[i].size() && !memcmp(data, originals[i].data(), asset->size);
+		}
+		if (!valid) fprintf(stderr, "assetpack: %s didn't come back from %s intact\n", names[i].c_str(), path);
+		if (pagedData) FreeAsset(&paged, pagedData);
+		if (data) FreeAsset(&loaded, data);
+		sourceBytes += originals[i].size();
+	}
+	if (valid) printf("total,,%u,%u,\n", sourceBytes, (u32) bytes.size());
+	CloseAssetArchive(&paged);
+	CloseAssetArchive(&loaded);
+	return valid;
+}
+
+int main(int argc, char** argv) {
+	u32 rate = ASSETPACK_DEFAULT_RATE;
+	int arg = 1;
+	if (argc == 3 && !strcmp(argv[1], "-list")) return ListArchive(argv[2]);
+	if (arg + 1 < argc && !strcmp(argv[arg], "-rate")) {
+		rate = atoi(argv[arg + 1]);
+		arg += 2;
+	}
+	if (arg >= argc || !rate || rate > ASSETPACK_SOURCE_RATE || ASSETPACK_SOURCE_RATE % rate) {
+		fprintf(stderr, "usage: assetpack [-rate n] <archive> <files...> (the rate has to divide %d)\n       assetpack -list <archive>\n", ASSETPACK_SOURCE_RATE);
+		return 1;
+	}
+	const char* path = argv[arg++];
+
+	std::vector<AssetInfo> assets;
+	std::vector<std::vector<u8> > data;
+	std::vector<std::string> names;
+	std::vector<std::vector<u8> > originals;
+	for (; arg < argc; arg++) {
+		const char* name = BaseName(argv[arg]);
+		std::vector<u8> original;
+		if (!ReadFile(argv[arg], &original)) {
+			fprintf(stderr, "assetpack: can't read %s\n", argv[arg]);
+			return 1;
+		}
+		if (strlen(name) >= ASSET_NAME_SIZE) {
+			fprintf(stderr, "assetpack: %s's name is too long (the most is %d characters)\n", name, ASSET_NAME_SIZE - 1);
+			return 1;
+		}
+		AssetInfo asset = AssetInfo();
+		strcpy(asset.name, name);
+		std::vector<u8> packed;
+		if (IsSound(name)) {
+			asset.type = ASSET_SOUND;
+			asset.rate = rate;
+			asset.channels = 1;
+			ConvertSound(original, rate, &packed);
+		}
+		else {
+			asset.type = ASSET_RAW;
+			packed = original;
+		}
+		assets.push_back(asset);
+		data.push_back(packed);
+		names.push_back(name);
+		originals.push_back(original);
+	}
+
+	std::vector<u8> archive;
+	PackAssetArchive(&archive, &assets, data);
+	FILE* file = fopen(path, "wb");
+	bool written = file && fwrite(archive.data(), 1, archive.size(), file) == archive.size();
+	if (file && fclose(file)) written = false;
+	if (!written) {
+		fprintf(stderr, "assetpack: can't write %s\n", path);
+		return 1;
+	}
+	if (!VerifyArchive(path, names, originals)) {
+		remove(path);
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
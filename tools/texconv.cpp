@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <png.h>
+#include <vector>
+#include <chrono>
+
+#include "tiledtexture.h"
+
+// converts a png into a texture file (see tiledtexture.h), run by the build on the machine doing the building, so the game never decodes a png
+// -format picks the texel format; auto (the default) picks the smallest one that keeps every channel of every pixel within -max-error of the png:
+// i8 (only when a pixel's channels are all about the same, since gx reads an i8 texel into all four), then rgb5a3, then rgba8 (which is exact)
+// the default error is 0, so a texture only comes out smaller than rgba8 when that loses nothing; anything lossy is opted into per image
+// (with -max-error or -format, which the makefiles pass from TEXCONVFLAGS_<name>; rgb5a3 can always manage 18, half a step of its 3-bit alpha)
+// after writing the file, it reads it back and checks that every texel comes back as the format should hold that pixel,
+// then prints what it did as a line of csv: the file, format, size, bytes before and after, the worst channel error, and how long decoding and tiling the png took
+// usage: texconv [-format auto|i8|rgb5a3|rgba8] [-max-error n] <png> <texture file>
+
+// the most a channel can be off by, by default, for auto to pick a format
+#define TEXCONV_DEFAULT_MAX_ERROR 0
+
+// reads a whole file (returns false if it can't be read)
+static bool ReadFile(const char* path, std::vector<u8>* data) {
+	FILE* file = fopen(path, "rb");
+	if (!file) return false;
+	data->clear();
+	u8 buffer[64 * 1024];
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) data->insert(data->end(), buffer, buffer + count);
+	bool valid = !ferror(file);
+	fclose(file);
+	return valid;
+}
+
+// decodes a png into 8-bit rgba pixels (returns false if it isn't a png libpng can read)
+static bool DecodePng(const std::vector<u8>& png, std::vector<u8>* pixels, u32* width, u32* height) {
+	png_image image;
+	memset(&image, 0, sizeof(image));
+	image.version = PNG_IMAGE_VERSION;
+	if (!png_image_begin_read_from_memory(&image, png.data(), png.size())) return false;
+	image.format = PNG_FORMAT_RGBA;
+	pixels->resize(PNG_IMAGE_SIZE(image));
+	if (!png_image_finish_read(&image, NULL, pixels->data(), 0, NULL)) return false;
+	*width = image.width;
+	*height = image.height;
+	return true;
+}
+
+// what a pixel comes back as from a format (a single texel, so it doesn't depend on the tiling being right)
+static void QuantizePixel(const u8* pixel, u32 format, u8* output) {
+	u8 texel[64];
+	TileTexture(pixel, format, 1, 1, texel);
+	UntileTexture(texel, format, 1, 1, output);
+}
+
+// returns the biggest difference between any channel of two sets of pixels
+static int GetMaxError(const u8* pixels, const u8* other, u32 count) {
+	int error = 0;
+	for (u32 i = 0; i < count * 4; i++) error = abs(pixels[i] - other[i]) > error ? abs(pixels[i] - other[i]) : error;
+	return error;
+}
+
+// the smallest format that keeps every pixel within maxError
+static u32 ChooseFormat(const std::vector<u8>& pixels, int maxError) {
+	static const u32 formats[] = {TILED_TEXTURE_I8, TILED_TEXTURE_RGB5A3};
+	for (int format = 0; format < 2; format++) {
+		bool fits = true;
+		for (u32 i = 0; i < pixels.size() && fits; i += 4) {
+			u8 quantized[4];
+			QuantizePixel(&pixels[i], formats[format], quantized);
+			fits = GetMaxError(&pixels[i], quantized, 1) <= maxError;
+		}
+		if (fits) return formats[format];
+	}
+	return TILED_TEXTURE_RGBA8;
+}
+
+static const char* GetFormatName(u32 format) { return format == TILED_TEXTURE_I8 ? "i8" : format == TILED_TEXTURE_RGB5A3 ? "rgb5a3" : "rgba8"; }
+
+int main(int argc, char** argv) {
+	const char* formatName = "auto";
+	int maxError = TEXCONV_DEFAULT_MAX_ERROR;
+	int arg = 1;
+	for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+		if (!strcmp(argv[arg], "-format")) formatName = argv[arg + 1];
+		else if (!strcmp(argv[arg], "-max-error")) maxError = atoi(argv[arg + 1]);
+		else break;
+	}
+	bool automatic = !strcmp(formatName, "auto");
+	u32 format = !strcmp(formatName, "i8") ? TILED_TEXTURE_I8 : !strcmp(formatName, "rgb5a3") ? TILED_TEXTURE_RGB5A3 : !strcmp(formatName, "rgba8") ? TILED_TEXTURE_RGBA8 : 0;
+	if (arg + 2 != argc || (!format && !automatic)) {
+		fprintf(stderr, "usage: texconv [-format auto|i8|rgb5a3|rgba8] [-max-error n] <png> <texture file>\n");
+		return 1;
+	}
+	const char* pngPath = argv[arg];
+	const char* path = argv[arg + 1];
+
+	std::vector<u8> png;
+	std::vector<u8> pixels;
+	u32 width, height;
+	if (!ReadFile(pngPath, &png)) {
+		fprintf(stderr, "texconv: can't read %s\n", pngPath);
+		return 1;
+	}
+	// decoding and tiling are timed, since they're what libwiisprite's LoadImage does with a png when the game starts
+	auto start = std::chrono::steady_clock::now();
+	if (!DecodePng(png, &pixels, &width, &height)) {
+		fprintf(stderr, "texconv: %s isn't a png that can be read\n", pngPath);
+		return 1;
+	}
+	double decodeTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	if (automatic) format = ChooseFormat(pixels, maxError);
+	std::vector<u8> file(TILED_TEXTURE_HEADER_SIZE + GetTiledTextureSize(format, width, height));
+	WriteTiledTextureHeader(file.data(), format, width, height);
+	start = std::chrono::steady_clock::now();
+	TileTexture(pixels.data(), format, width, height, file.data() + TILED_TEXTURE_HEADER_SIZE);
+	decodeTime += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	// the game checks the header too, but it's better for the build to fail than the game
+	TiledTextureHeader header;
+	if (!ReadTiledTextureHeader(file.data(), file.size(), &header)) {
+		fprintf(stderr, "texconv: %s is %ux%u, which is too big for gx\n", pngPath, width, height);
+		return 1;
+	}
+
+	FILE* output = fopen(path, "wb");
+	bool written = output && fwrite(file.data(), 1, file.size(), output) == file.size();
+	if (output && fclose(output)) written = false;
+	if (!written) {
+		fprintf(stderr, "texconv: can't write %s\n", path);
+		return 1;
+	}
+
+	// read it back, untile it, and check every pixel against what the format should hold for it
+	std::vector<u8> readBack;
+	std::vector<u8> untiled(pixels.size());
+	bool valid = ReadFile(path, &readBack) && ReadTiledTextureHeader(readBack.data(), readBack.size(), &header);
+	valid = valid && header.format == format && header.width == width && header.height == height;
+	int error = 0;
+	if (valid) {
+		UntileTexture(readBack.data() + TILED_TEXTURE_HEADER_SIZE, format, width, height, untiled.data());
+		for (u32 i = 0; valid && i < pixels.size(); i += 4) {
+			u8 quantized[4];
+			QuantizePixel(&pixels[i], format, quantized);
+			valid = !memcmp(quantized, &untiled[i], 4);
+		}
+		error = GetMaxError(pixels.data(), untiled.data(), width * height);
+		valid = valid && (!automatic || error <= maxError);
+	}
+	if (!valid) {
+		fprintf(stderr, "texconv: %s didn't come back from %s intact\n", pngPath, path);
+		remove(path);
+		return 1;
+	}
+	const char* name = strrchr(pngPath, '/') ? strrchr(pngPath, '/') + 1 : pngPath;
+	printf("%s,%s,%u,%u,%u,%u,%d,%.1f\n", name, GetFormatName(format), width, height, (u32) png.size(), (u32) file.size(), error, decodeTime);
+	return 0;
+}
\ No newline at end of file